@@ -187,7 +187,7 @@ void CommandListDX12::EndRenderPass()
 	CommandList::EndRenderPass();
 }
 
-void CommandListDX12::Draw(int32_t pritimiveCount)
+PipelineStateDX12* CommandListDX12::BindDrawingStates(bool isIndexed)
 {
 	assert(currentCommandList_ != nullptr);
 
@@ -205,7 +205,7 @@ void CommandListDX12::Draw(int32_t pritimiveCount)
 	GetCurrentPipelineState(pip_, isPipDirtied);
 
 	assert(vb_.vertexBuffer != nullptr);
-	assert(ib_.indexBuffer != nullptr);
+	assert(!isIndexed || ib_.indexBuffer != nullptr);
 	assert(pip_ != nullptr);
 
 	auto vb = static_cast<VertexBufferDX12*>(vb_.vertexBuffer);
@@ -223,7 +223,7 @@ void CommandListDX12::Draw(int32_t pritimiveCount)
 		}
 	}
 
-	if (ib != nullptr)
+	if (isIndexed && ib != nullptr)
 	{
 		D3D12_INDEX_BUFFER_VIEW indexView;
 		indexView.BufferLocation = ib->Get()->GetGPUVirtualAddress() + ib_.offset;
@@ -268,13 +268,13 @@ void CommandListDX12::Draw(int32_t pritimiveCount)
 			heapSampler, cpuDescriptorHandleSampler, gpuDescriptorHandleSampler, requiredSamplerDescriptorCount))
 	{
 		Log(LogType::Error, "Failed to draw because of descriptors.");
-		return;
+		return nullptr;
 	}
 
 	if (!cbDescriptorHeap_->Allocate(heapConstant, cpuDescriptorHandleConstant, gpuDescriptorHandleConstant, requiredCBDescriptorCount))
 	{
 		Log(LogType::Error, "Failed to draw because of descriptors.");
-		return;
+		return nullptr;
 	}
 
 	{
@@ -394,15 +394,53 @@ void CommandListDX12::Draw(int32_t pritimiveCount)
 		}
 	}
 
-	// setup a topology (triangle)
-	currentCommandList_->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	// setup a topology
+	D3D_PRIMITIVE_TOPOLOGY topology = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+	if (pip->Topology == TopologyType::Line)
+		topology = D3D_PRIMITIVE_TOPOLOGY_LINELIST;
+	if (pip->Topology == TopologyType::TriangleStrip)
+		topology = D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP;
+	if (pip->Topology == TopologyType::LineStrip)
+		topology = D3D_PRIMITIVE_TOPOLOGY_LINESTRIP;
+	if (pip->Topology == TopologyType::Point)
+		topology = D3D_PRIMITIVE_TOPOLOGY_POINTLIST;
+	currentCommandList_->IASetPrimitiveTopology(topology);
+
+	return pip;
+}
+
+void CommandListDX12::Draw(int32_t pritimiveCount)
+{
+	auto pip = BindDrawingStates(true);
+	if (pip == nullptr)
+		return;
 
 	// draw polygon
-	currentCommandList_->DrawIndexedInstanced(pritimiveCount * 3 /*triangle*/, 1, 0, 0, 0);
+	currentCommandList_->DrawIndexedInstanced(GetVertexCountFromPrimitiveCount(pip->Topology, pritimiveCount), 1, 0, 0, 0);
 
 	CommandList::Draw(pritimiveCount);
 }
 
+void CommandListDX12::DrawIndexed(int32_t indexCount, int32_t firstIndex, int32_t baseVertex)
+{
+	if (BindDrawingStates(true) == nullptr)
+		return;
+
+	currentCommandList_->DrawIndexedInstanced(indexCount, 1, firstIndex, baseVertex, 0);
+
+	CommandList::DrawIndexed(indexCount, firstIndex, baseVertex);
+}
+
+void CommandListDX12::DrawNonIndexed(int32_t vertexCount, int32_t firstVertex)
+{
+	if (BindDrawingStates(false) == nullptr)
+		return;
+
+	currentCommandList_->DrawInstanced(vertexCount, 1, firstVertex, 0);
+
+	CommandList::DrawNonIndexed(vertexCount, firstVertex);
+}
+
 void CommandListDX12::CopyTexture(Texture* src, Texture* dst)
 {
 	if (isInRenderPass_)
@@ -39,6 +39,12 @@ private:
 
 	void BeginInternal();
 
+	/**
+		@brief	bind a vertex buffer, an index buffer, descriptors, a pipeline and a topology for drawing
+		@return	a bound pipeline state. nullptr is returned if descriptors cannot be allocated.
+	*/
+	PipelineStateDX12* BindDrawingStates(bool isIndexed);
+
 public:
 	CommandListDX12();
 	virtual ~CommandListDX12();
@@ -52,6 +58,8 @@ public:
 	void BeginRenderPass(RenderPass* renderPass) override;
 	void EndRenderPass() override;
 	void Draw(int32_t pritimiveCount) override;
+	void DrawIndexed(int32_t indexCount, int32_t firstIndex, int32_t baseVertex) override;
+	void DrawNonIndexed(int32_t vertexCount, int32_t firstVertex) override;
 	void CopyTexture(Texture* src, Texture* dst) override;
 
 	void Clear(const Color8& color);
@@ -36,7 +36,7 @@ void PipelineStateDX12::SetShader(ShaderStageType stage, Shader* shader)
 	shaders_[static_cast<int>(stage)] = shader;
 }
 
-void PipelineStateDX12::Compile()
+bool PipelineStateDX12::Compile()
 {
 	CreateRootSignature();
 
@@ -46,7 +46,7 @@ void PipelineStateDX12::Compile()
 	{
 		auto shader = static_cast<ShaderDX12*>(shaders_.at(i));
 		if (shader == nullptr)
-			return;
+			return false;
 
 		auto& shaderData = shader->GetData();
 
@@ -106,10 +106,12 @@ void PipelineStateDX12::Compile()
 	}
 
 	// setup a topology
-	if (Topology == TopologyType::Triangle)
+	if (Topology == TopologyType::Triangle || Topology == TopologyType::TriangleStrip)
 		pipelineStateDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
-	if (Topology == TopologyType::Line)
+	if (Topology == TopologyType::Line || Topology == TopologyType::LineStrip)
 		pipelineStateDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_LINE;
+	if (Topology == TopologyType::Point)
+		pipelineStateDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_POINT;
 
 	// TODO...(generate from parameters)
 	D3D12_RASTERIZER_DESC rasterizerDesc = {};
@@ -234,11 +236,11 @@ void PipelineStateDX12::Compile()
 		goto FAILED_EXIT;
 	}
 
-	return;
+	return true;
 
 FAILED_EXIT:
 	SafeRelease(pipelineState_);
-	return;
+	return false;
 }
 
 bool PipelineStateDX12::CreateRootSignature()
@@ -18,6 +18,7 @@ namespace LLGI
 {
 
 static const int RenderTargetMax = 8;
+static const int SubpassMax = 8;
 static const int VertexLayoutMax = 16;
 
 enum class DeviceType
@@ -84,6 +85,9 @@ enum class TopologyType
 {
 	Triangle,
 	Line,
+	TriangleStrip,
+	LineStrip,
+	Point,
 };
 
 enum class TextureWrapMode
@@ -110,12 +114,65 @@ enum class DepthFuncType
 	Always,
 };
 
+/**
+	@brief	what is done with contents of an attachment when a render pass begins
+*/
+enum class AttachmentLoadOp
+{
+	Load,	  //! contents are preserved
+	Clear,	  //! contents are cleared with a clear value
+	DontCare, //! contents are undefined
+};
+
+/**
+	@brief	what is done with contents of an attachment when a render pass ends
+*/
+enum class AttachmentStoreOp
+{
+	Store,	  //! contents are written into memory
+	DontCare, //! contents are discarded
+};
+
 enum class ConstantBufferType
 {
 	LongTime,  //! this constant buffer is not almost changed
 	ShortTime, //! this constant buffer is disposed or rewrite by a frame. If shorttime, this constant buffer must be disposed by a frame.
 };
 
+/**
+	@brief	states of a pipeline state which can be changed per draw with CommandList::SetDynamicState
+*/
+struct DynamicPipelineState
+{
+	CullingMode Culling = CullingMode::Clockwise;
+	TopologyType Topology = TopologyType::Triangle;
+	bool IsDepthTestEnabled = false;
+	bool IsDepthWriteEnabled = false;
+	bool IsStencilTestEnabled = false;
+	DepthFuncType DepthFunc = DepthFuncType::Less;
+
+	bool operator==(const DynamicPipelineState& value) const
+	{
+		return Culling == value.Culling && Topology == value.Topology && IsDepthTestEnabled == value.IsDepthTestEnabled &&
+			   IsDepthWriteEnabled == value.IsDepthWriteEnabled && IsStencilTestEnabled == value.IsStencilTestEnabled &&
+			   DepthFunc == value.DepthFunc;
+	}
+
+	bool operator!=(const DynamicPipelineState& value) const { return !(*this == value); }
+
+	struct Hash
+	{
+		typedef std::size_t result_type;
+
+		std::size_t operator()(const DynamicPipelineState& key) const
+		{
+			return static_cast<std::size_t>(key.Culling) + (static_cast<std::size_t>(key.Topology) << 4) +
+				   (static_cast<std::size_t>(key.DepthFunc) << 8) + (static_cast<std::size_t>(key.IsDepthTestEnabled) << 12) +
+				   (static_cast<std::size_t>(key.IsDepthWriteEnabled) << 13) + (static_cast<std::size_t>(key.IsStencilTestEnabled) << 14);
+		}
+	};
+};
+
 struct Vec2I
 {
 	int32_t X;
@@ -261,6 +318,22 @@ public:
 
 	int GetRef() { return reference; }
 
+	/**
+		@brief	add a reference only if the object is not being destroyed
+		@note
+		It is used by caches which keep objects without references.
+	*/
+	bool TryAddRef()
+	{
+		auto current = reference.load();
+		while (current > 0)
+		{
+			if (reference.compare_exchange_weak(current, current + 1))
+				return true;
+		}
+		return false;
+	}
+
 	int Release()
 	{
 		assert(reference > 0);
@@ -312,6 +385,7 @@ template <typename T> using unique_ref = std::unique_ptr<T, ReferenceDeleter<T>>
 
 class VertexBuffer;
 class IndexBuffer;
+class IndirectBuffer;
 class ConstantBuffer;
 class Shader;
 class PipelineState;
@@ -359,6 +433,32 @@ inline int32_t GetTextureMemorySize(TextureFormatType format, Vec2I size)
 	return 0;
 }
 
+/**
+	@brief	get the number of vertices (or indices) which is required to draw primitives
+*/
+inline int32_t GetVertexCountFromPrimitiveCount(TopologyType topology, int32_t primitiveCount)
+{
+	if (primitiveCount <= 0)
+		return 0;
+
+	switch (topology)
+	{
+	case TopologyType::Triangle:
+		return primitiveCount * 3;
+	case TopologyType::Line:
+		return primitiveCount * 2;
+	case TopologyType::TriangleStrip:
+		return primitiveCount + 2;
+	case TopologyType::LineStrip:
+		return primitiveCount + 1;
+	case TopologyType::Point:
+		return primitiveCount;
+	default:
+		assert(0);
+	}
+	return 0;
+}
+
 /**
 	@brief	window abstraction class
 */
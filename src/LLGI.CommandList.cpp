@@ -2,6 +2,7 @@
 #include "LLGI.CommandList.h"
 #include "LLGI.ConstantBuffer.h"
 #include "LLGI.IndexBuffer.h"
+#include "LLGI.IndirectBuffer.h"
 #include "LLGI.PipelineState.h"
 #include "LLGI.Texture.h"
 #include "LLGI.VertexBuffer.h"
@@ -33,6 +34,20 @@ void CommandList::GetCurrentConstantBuffer(ShaderStageType type, ConstantBuffer*
 	buffer = constantBuffers[static_cast<int>(type)];
 }
 
+void CommandList::GetCurrentDynamicState(DynamicPipelineState& state, bool& isDirtied)
+{
+	if (isDynamicStateSpecified_ || currentPipelineState == nullptr)
+	{
+		state = dynamicState_;
+	}
+	else
+	{
+		state = currentPipelineState->GetDynamicState();
+	}
+
+	isDirtied = isDynamicStateDirtied_;
+}
+
 void CommandList::RegisterReferencedObject(ReferenceObject* referencedObject)
 {
 	if (referencedObject == nullptr)
@@ -91,6 +106,8 @@ void CommandList::Begin()
 	isVertexBufferDirtied = true;
 	isCurrentIndexBufferDirtied = true;
 	isPipelineDirtied = true;
+	isDynamicStateSpecified_ = false;
+	isDynamicStateDirtied_ = true;
 	ResetTextures();
 
 	swapIndex_ = (swapIndex_ + 1) % swapCount_;
@@ -112,6 +129,8 @@ bool CommandList::BeginWithPlatform(void* platformContextPtr)
 	isVertexBufferDirtied = true;
 	isCurrentIndexBufferDirtied = true;
 	isPipelineDirtied = true;
+	isDynamicStateSpecified_ = false;
+	isDynamicStateDirtied_ = true;
 
 	swapIndex_ = (swapIndex_ + 1) % swapCount_;
 
@@ -154,11 +173,48 @@ void CommandList::EndWithPlatform()
 
 void CommandList::SetScissor(int32_t x, int32_t y, int32_t width, int32_t height) {}
 
-void CommandList::Draw(int32_t pritimiveCount)
+void CommandList::ResetDirtiedStates()
 {
 	isVertexBufferDirtied = false;
 	isCurrentIndexBufferDirtied = false;
 	isPipelineDirtied = false;
+	isDynamicStateDirtied_ = false;
+}
+
+void CommandList::Draw(int32_t pritimiveCount) { ResetDirtiedStates(); }
+
+void CommandList::DrawIndexed(int32_t indexCount, int32_t firstIndex, int32_t baseVertex) { ResetDirtiedStates(); }
+
+void CommandList::DrawNonIndexed(int32_t vertexCount, int32_t firstVertex) { ResetDirtiedStates(); }
+
+void CommandList::DrawIndirect(IndirectBuffer* argumentBuffer, int32_t offset, int32_t drawCount, int32_t stride)
+{
+	Log(LogType::Error, "DrawIndirect is not supported in this platform.");
+}
+
+void CommandList::DrawIndexedIndirect(IndirectBuffer* argumentBuffer, int32_t offset, int32_t drawCount, int32_t stride)
+{
+	Log(LogType::Error, "DrawIndexedIndirect is not supported in this platform.");
+}
+
+void CommandList::DrawIndirectCount(
+	IndirectBuffer* argumentBuffer, int32_t offset, IndirectBuffer* countBuffer, int32_t countOffset, int32_t maxDrawCount, int32_t stride)
+{
+	Log(LogType::Error, "DrawIndirectCount is not supported in this platform.");
+}
+
+void CommandList::DrawIndexedIndirectCount(
+	IndirectBuffer* argumentBuffer, int32_t offset, IndirectBuffer* countBuffer, int32_t countOffset, int32_t maxDrawCount, int32_t stride)
+{
+	Log(LogType::Error, "DrawIndexedIndirectCount is not supported in this platform.");
+}
+
+void CommandList::DrawIndexedMulti(const DrawIndexedRange* ranges, int32_t count)
+{
+	for (int32_t i = 0; i < count; i++)
+	{
+		DrawIndexed(ranges[i].IndexCount, ranges[i].FirstIndex, ranges[i].VertexOffset);
+	}
 }
 
 void CommandList::SetVertexBuffer(VertexBuffer* vertexBuffer, int32_t stride, int32_t offset)
@@ -197,6 +253,25 @@ void CommandList::SetConstantBuffer(ConstantBuffer* constantBuffer, ShaderStageT
 	RegisterReferencedObject(constantBuffer);
 }
 
+void CommandList::SetDynamicState(const DynamicPipelineState& state)
+{
+	if (isDynamicStateSpecified_ && dynamicState_ == state)
+		return;
+
+	dynamicState_ = state;
+	isDynamicStateSpecified_ = true;
+	isDynamicStateDirtied_ = true;
+}
+
+void CommandList::ResetDynamicState()
+{
+	if (!isDynamicStateSpecified_)
+		return;
+
+	isDynamicStateSpecified_ = false;
+	isDynamicStateDirtied_ = true;
+}
+
 void CommandList::SetTexture(
 	Texture* texture, TextureWrapMode wrapMode, TextureMinMagFilter minmagFilter, int32_t unit, ShaderStageType shaderStage)
 {
@@ -226,6 +301,7 @@ void CommandList::BeginRenderPass(RenderPass* renderPass)
 	isVertexBufferDirtied = true;
 	isCurrentIndexBufferDirtied = true;
 	isPipelineDirtied = true;
+	isDynamicStateDirtied_ = true;
 	isInRenderPass_ = true;
 }
 
@@ -234,6 +310,7 @@ bool CommandList::BeginRenderPassWithPlatformPtr(void* platformPtr)
 	isVertexBufferDirtied = true;
 	isCurrentIndexBufferDirtied = true;
 	isPipelineDirtied = true;
+	isDynamicStateDirtied_ = true;
 	isInRenderPass_ = true;
 	return true;
 }
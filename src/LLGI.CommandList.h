@@ -10,6 +10,53 @@ static constexpr int NumTexture = 8;
 class VertexBuffer;
 class IndexBuffer;
 
+/**
+	@brief	a range of indexes which is drawn by CommandList::DrawIndexedMulti
+	@note
+	The layout is same as VkMultiDrawIndexedInfoEXT.
+*/
+struct DrawIndexedRange
+{
+	uint32_t FirstIndex;
+	uint32_t IndexCount;
+	int32_t VertexOffset;
+};
+
+/**
+	@brief	how a texture is used by next commands
+*/
+enum class TextureAccessType
+{
+	ShaderRead,
+	RenderTarget,
+	DepthStencil,
+	CopySource,
+	CopyDestination,
+};
+
+/**
+	@brief	a texture which is prepared by CommandList::TransitionTextures
+*/
+struct TextureBarrier
+{
+	Texture* Target = nullptr;
+	TextureAccessType Access = TextureAccessType::ShaderRead;
+
+	//! current contents are not kept. it is required when memory of a texture was used by another texture
+	bool IsDiscarded = false;
+};
+
+/**
+	@brief	a region of a texture which is read by CommandList::ReadbackTexture
+*/
+struct TextureRegion
+{
+	Vec2I Position;
+
+	//! the whole of a texture is read if it is zero
+	Vec2I Size;
+};
+
 /**
 	@brief	command list
 	@note
@@ -65,6 +112,10 @@ private:
 	bool isPipelineDirtied = true;
 	bool doesBeginWithPlatform_ = false;
 
+	DynamicPipelineState dynamicState_;
+	bool isDynamicStateSpecified_ = false;
+	bool isDynamicStateDirtied_ = true;
+
 	std::array<ConstantBuffer*, static_cast<int>(ShaderStageType::Max)> constantBuffers;
 
 protected:
@@ -78,8 +129,18 @@ protected:
 	void GetCurrentIndexBuffer(BindingIndexBuffer& buffer, bool& isDirtied);
 	void GetCurrentPipelineState(PipelineState*& pipelineState, bool& isDirtied);
 	void GetCurrentConstantBuffer(ShaderStageType type, ConstantBuffer*& buffer);
+
+	/**
+		@brief	get states which are used in a draw
+		@note
+		States of current pipeline state are returned if SetDynamicState is not called.
+	*/
+	void GetCurrentDynamicState(DynamicPipelineState& state, bool& isDirtied);
 	void RegisterReferencedObject(ReferenceObject* referencedObject);
 
+	//! mark current binding states as applied. It is called after a draw is recorded.
+	void ResetDirtiedStates();
+
 public:
 	CommandList(int32_t swapCount = 3);
 	virtual ~CommandList();
@@ -104,16 +165,142 @@ public:
 
 	virtual void SetScissor(int32_t x, int32_t y, int32_t width, int32_t height);
 	virtual void Draw(int32_t pritimiveCount);
+
+	/**
+		@brief	draw a range of current index buffer
+		@param	indexCount	the number of indices
+		@param	firstIndex	the index of the first index in current index buffer
+		@param	baseVertex	the value which is added to each index before reading a vertex
+		@note
+		Unlike specifying an offset with SetIndexBuffer, it doesn't change binding states.
+	*/
+	virtual void DrawIndexed(int32_t indexCount, int32_t firstIndex, int32_t baseVertex);
+
+	/**
+		@brief	draw vertices of current vertex buffer without an index buffer
+		@param	vertexCount	the number of vertices
+		@param	firstVertex	the index of the first vertex
+	*/
+	virtual void DrawNonIndexed(int32_t vertexCount, int32_t firstVertex);
+
+	/**
+		@brief	draw primitives with arguments which are read from a buffer on gpu
+		@param	argumentBuffer	a buffer which contains DrawIndirectArguments
+		@param	offset	the offset in bytes of the first arguments
+		@param	drawCount	the number of arguments
+		@param	stride	the stride in bytes between arguments
+		@note
+		It is supported only in Vulkan.
+	*/
+	virtual void DrawIndirect(IndirectBuffer* argumentBuffer, int32_t offset, int32_t drawCount, int32_t stride);
+
+	/**
+		@brief	draw indexed primitives with arguments which are read from a buffer on gpu
+		@param	argumentBuffer	a buffer which contains DrawIndexedIndirectArguments
+		@param	offset	the offset in bytes of the first arguments
+		@param	drawCount	the number of arguments
+		@param	stride	the stride in bytes between arguments
+		@note
+		It is supported only in Vulkan.
+	*/
+	virtual void DrawIndexedIndirect(IndirectBuffer* argumentBuffer, int32_t offset, int32_t drawCount, int32_t stride);
+
+	/**
+		@brief	draw primitives with arguments and the number of them which are read from buffers on gpu
+		@note
+		The number of draws is min(the value of countBuffer at countOffset, maxDrawCount).
+		It is supported only in Vulkan with VK_KHR_draw_indirect_count. An error is logged otherwise.
+	*/
+	virtual void DrawIndirectCount(IndirectBuffer* argumentBuffer,
+								   int32_t offset,
+								   IndirectBuffer* countBuffer,
+								   int32_t countOffset,
+								   int32_t maxDrawCount,
+								   int32_t stride);
+
+	/**
+		@brief	draw indexed primitives with arguments and the number of them which are read from buffers on gpu
+		@note
+		The number of draws is min(the value of countBuffer at countOffset, maxDrawCount).
+		It is supported only in Vulkan with VK_KHR_draw_indirect_count. An error is logged otherwise.
+	*/
+	virtual void DrawIndexedIndirectCount(IndirectBuffer* argumentBuffer,
+										  int32_t offset,
+										  IndirectBuffer* countBuffer,
+										  int32_t countOffset,
+										  int32_t maxDrawCount,
+										  int32_t stride);
+
+	/**
+		@brief	draw some ranges of current index buffer
+		@note
+		It is drawn with one command if a platform supports it. Otherwise, it is drawn with a loop of DrawIndexed.
+	*/
+	virtual void DrawIndexedMulti(const DrawIndexedRange* ranges, int32_t count);
+
 	virtual void SetVertexBuffer(VertexBuffer* vertexBuffer, int32_t stride, int32_t offset);
 	virtual void SetIndexBuffer(IndexBuffer* indexBuffer, int32_t offset = 0);
 	virtual void SetPipelineState(PipelineState* pipelineState);
 	virtual void SetConstantBuffer(ConstantBuffer* constantBuffer, ShaderStageType shaderStage);
 
+	/**
+		@brief	override culling, a topology and depth stencil states of current pipeline state
+		@note
+		Specified states are used in draws until ResetDynamicState is called.
+		A topology must be in the same class (triangles, lines or points) as the topology of current pipeline state.
+		It is supported only in Vulkan.
+	*/
+	virtual void SetDynamicState(const DynamicPipelineState& state);
+
+	/**
+		@brief	use states of current pipeline state again
+	*/
+	virtual void ResetDynamicState();
+
+	/**
+		@brief	send small data to a shader directly without a constant buffer
+		@param	shaderStage	the stage which receives data
+		@param	offset	the offset in bytes from the start of the stage's range (PipelineState::PushConstantSizes)
+		@param	size	the size of data in bytes
+		@param	data	data
+		@note
+		An offset and a size must be multiples of 4. It must be called after SetPipelineState. Data is copied when it is called.
+		It is supported only in Vulkan. It does nothing in other platforms, so shaders for them must read data from constant buffers.
+	*/
+	virtual void SetPushConstants(ShaderStageType shaderStage, int32_t offset, int32_t size, const void* data) {}
+
 	/**
 		@brief	copy a texture
 	*/
 	virtual void CopyTexture(Texture* src, Texture* dst) {}
 
+	/**
+		@brief	prepare textures for next commands at once
+		@note
+		It must be called outside of RenderPass. Textures are prepared one by one by commands if this function is not called.
+		It is ignored if a platform doesn't require it.
+	*/
+	virtual void TransitionTextures(const TextureBarrier* barriers, int32_t count) {}
+
+	/**
+		@brief	read a region of a texture without waiting for gpu
+		@param	texture	a texture
+		@param	region	a region of the texture
+		@param	callback	a function which receives pixels of the region. rows are not padded. data is valid only while it is called.
+		@return	whether the copy is recorded. it fails if a readback ring doesn't have enough space.
+		@note
+		It must be called outside of RenderPass. The copy is recorded into this command list
+		and callback is called by Begin after the command list is executed, so results arrive some frames later.
+		WaitUntilCompleted calls callbacks at once. Callbacks are not called if the command list is released before it.
+		It is supported only in Vulkan.
+	*/
+	virtual bool ReadbackTexture(Texture* texture,
+								 const TextureRegion& region,
+								 const std::function<void(const void* data, int32_t size)>& callback)
+	{
+		return false;
+	}
+
 	/**
 		@brief specify textures
 		@note
@@ -135,6 +322,13 @@ public:
 	*/
 	virtual bool BeginRenderPassWithPlatformPtr(void* platformPtr);
 
+	/**
+		@brief	start a next subpass of a current render pass
+		@note
+		It is supported only in Vulkan. See RenderPass::SetSubpasses.
+	*/
+	virtual void NextSubpass() {}
+
 	virtual void EndRenderPass() { isInRenderPass_ = false; }
 
 	/**
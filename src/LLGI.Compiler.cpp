@@ -7,4 +7,23 @@ void Compiler::Initialize() {}
 
 void Compiler::Compile(CompilerResult& result, const char* code, ShaderStageType shaderStage) {}
 
+void Compiler::Compile(CompilerResult& result, const char* code, ShaderStageType shaderStage, const std::vector<CompilerDefine>& defines)
+{
+	if (defines.size() > 0)
+	{
+		result.Message = "Defines are not supported.";
+		return;
+	}
+
+	Compile(result, code, shaderStage);
+}
+
+void Compiler::CompileBatch(CompilerJob* jobs, int32_t count)
+{
+	for (int32_t i = 0; i < count; i++)
+	{
+		Compile(jobs[i].Result, jobs[i].Code, jobs[i].Stage, jobs[i].Defines);
+	}
+}
+
 } // namespace LLGI
\ No newline at end of file
@@ -7,12 +7,36 @@ namespace LLGI
 
 Compiler* CreateCompiler(DeviceType device);
 
+enum class CompilerOptimizationLevel
+{
+	None,
+	Size,
+	Performance,
+};
+
 struct CompilerResult
 {
 	std::string Message;
 	std::vector<std::vector<uint8_t>> Binary;
 };
 
+struct CompilerDefine
+{
+	std::string Name;
+	std::string Value;
+};
+
+/**
+	@brief	a unit of work compiled by Compiler::CompileBatch
+*/
+struct CompilerJob
+{
+	const char* Code = nullptr;
+	ShaderStageType Stage = ShaderStageType::Vertex;
+	std::vector<CompilerDefine> Defines;
+	CompilerResult Result;
+};
+
 class Compiler : public ReferenceObject
 {
 private:
@@ -23,6 +47,41 @@ public:
 	virtual void Initialize();
 	virtual void Compile(CompilerResult& result, const char* code, ShaderStageType shaderStage);
 
+	/**
+		@brief	compile a shader with macros
+		@note
+		Macros are supported only in Vulkan.
+	*/
+	virtual void Compile(CompilerResult& result, const char* code, ShaderStageType shaderStage, const std::vector<CompilerDefine>& defines);
+
+	/**
+		@brief	compile jobs and store results into each job
+		@note
+		Jobs are compiled in parallel only in Vulkan. Otherwise they are compiled one by one.
+	*/
+	virtual void CompileBatch(CompilerJob* jobs, int32_t count);
+
+	/**
+		@brief	specify a directory where compiled binaries are stored and shared among processes
+		@note
+		It is supported only in Vulkan.
+	*/
+	virtual void SetCacheDirectory(const char* directory) {}
+
+	/**
+		@brief	add a directory where files included by #include are searched
+		@note
+		It is supported only in Vulkan. Shaders which include files are not cached.
+	*/
+	virtual void AddIncludeDirectory(const char* directory) {}
+
+	/**
+		@brief	specify how compiled binaries are optimized
+		@note
+		It is supported only in Vulkan. Debug information is stripped unless it is None.
+	*/
+	virtual void SetOptimizationLevel(CompilerOptimizationLevel level) {}
+
 	virtual DeviceType GetDeviceType() const { return DeviceType::Default; }
 };
 
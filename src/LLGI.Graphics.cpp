@@ -106,6 +106,9 @@ bool RenderPass::assignRenderTextures(Texture** textures, int32_t count)
 	for (size_t i = 0; i < count; i++)
 	{
 		renderTextures_.at(i) = textures[i];
+
+		// contents of a transient texture are not kept after a pass
+		colorStoreOps_.at(i) = textures[i]->GetIsTransient() ? AttachmentStoreOp::DontCare : AttachmentStoreOp::Store;
 	}
 
 	return true;
@@ -123,6 +126,11 @@ bool RenderPass::assignDepthTexture(Texture* depthTexture)
 	SafeRelease(depthTexture_);
 	depthTexture_ = depthTexture;
 
+	if (depthTexture_ != nullptr)
+	{
+		depthStoreOp_ = depthTexture_->GetIsTransient() ? AttachmentStoreOp::DontCare : AttachmentStoreOp::Store;
+	}
+
 	return true;
 }
 
@@ -160,6 +168,12 @@ FAIL:;
 	return false;
 }
 
+RenderPass::RenderPass()
+{
+	colorLoadOps_.fill(AttachmentLoadOp::Load);
+	colorStoreOps_.fill(AttachmentStoreOp::Store);
+}
+
 RenderPass::~RenderPass()
 {
 	SafeRelease(depthTexture_);
@@ -170,12 +184,80 @@ RenderPass::~RenderPass()
 	}
 }
 
-void RenderPass::SetIsColorCleared(bool isColorCleared) { isColorCleared_ = isColorCleared; }
+void RenderPass::SetIsColorCleared(bool isColorCleared)
+{
+	isColorCleared_ = isColorCleared;
+	colorLoadOps_.fill(isColorCleared ? AttachmentLoadOp::Clear : AttachmentLoadOp::Load);
+}
+
+void RenderPass::SetIsDepthCleared(bool isDepthCleared)
+{
+	isDepthCleared_ = isDepthCleared;
+	depthLoadOp_ = isDepthCleared ? AttachmentLoadOp::Clear : AttachmentLoadOp::Load;
+}
 
-void RenderPass::SetIsDepthCleared(bool isDepthCleared) { isDepthCleared_ = isDepthCleared; }
+void RenderPass::SetColorAction(int32_t index, AttachmentLoadOp loadOp, AttachmentStoreOp storeOp)
+{
+	colorLoadOps_.at(index) = loadOp;
+	colorStoreOps_.at(index) = storeOp;
+
+	isColorCleared_ = false;
+	for (const auto& op : colorLoadOps_)
+	{
+		isColorCleared_ |= op == AttachmentLoadOp::Clear;
+	}
+}
+
+void RenderPass::SetDepthAction(AttachmentLoadOp loadOp, AttachmentStoreOp storeOp)
+{
+	depthLoadOp_ = loadOp;
+	depthStoreOp_ = storeOp;
+	isDepthCleared_ = loadOp == AttachmentLoadOp::Clear;
+}
 
 void RenderPass::SetClearColor(const Color8& color) { color_ = color; }
 
+bool RenderPass::SetSubpasses(const SubpassParameter* subpasses, int32_t count)
+{
+	if (count < 0 || count > SubpassMax)
+	{
+		Log(LogType::Error, "RenderPass : Invalid the number of subpasses.");
+		return false;
+	}
+
+	const int32_t textureMask = (1 << GetRenderTextureCount()) - 1;
+
+	for (int32_t i = 0; i < count; i++)
+	{
+		const auto& subpass = subpasses[i];
+		if ((subpass.ColorAttachmentMask & ~textureMask) != 0 || (subpass.InputAttachmentMask & ~textureMask) != 0)
+		{
+			Log(LogType::Error, "RenderPass : A subpass refers a texture which is not contained.");
+			return false;
+		}
+
+		if ((subpass.ColorAttachmentMask & subpass.InputAttachmentMask) != 0)
+		{
+			Log(LogType::Error, "RenderPass : A texture is written and read in the same subpass.");
+			return false;
+		}
+
+		if ((subpass.IsDepthUsed || subpass.IsDepthInput) && !GetHasDepthTexture())
+		{
+			Log(LogType::Error, "RenderPass : A subpass uses a depth texture which is not contained.");
+			return false;
+		}
+	}
+
+	subpasses_.resize(count);
+	for (int32_t i = 0; i < count; i++)
+	{
+		subpasses_.at(i) = subpasses[i];
+	}
+
+	return true;
+}
+
 bool RenderPass::GetIsSwapchainScreen() const { return GetRenderTexture(0)->GetType() == TextureType::Screen; }
 
 Graphics::~Graphics()
@@ -196,6 +278,8 @@ VertexBuffer* Graphics::CreateVertexBuffer(int32_t size) { return nullptr; }
 
 IndexBuffer* Graphics::CreateIndexBuffer(int32_t stride, int32_t count) { return nullptr; }
 
+IndirectBuffer* Graphics::CreateIndirectBuffer(int32_t size) { return nullptr; }
+
 Shader* Graphics::CreateShader(DataStructure* data, int32_t count) { return nullptr; }
 
 PipelineState* Graphics::CreatePiplineState() { return nullptr; }
@@ -208,6 +292,76 @@ ConstantBuffer* Graphics::CreateConstantBuffer(int32_t size) { return nullptr; }
 
 Texture* Graphics::CreateTexture(uint64_t id) { return nullptr; }
 
+bool Graphics::CreateTransientTextures(const TransientTextureParameter* parameters, int32_t count, Texture** textures)
+{
+	for (int32_t i = 0; i < count; i++)
+	{
+		textures[i] = nullptr;
+	}
+
+	for (int32_t i = 0; i < count; i++)
+	{
+		const auto& parameter = parameters[i];
+
+		// reuse a texture which has the same parameter and is not used in the range
+		for (int32_t j = 0; j < i; j++)
+		{
+			const auto& candidate = parameters[j];
+			if (candidate.Size.X != parameter.Size.X || candidate.Size.Y != parameter.Size.Y || candidate.Format != parameter.Format ||
+				candidate.IsDepth != parameter.IsDepth)
+			{
+				continue;
+			}
+
+			bool isOverlapped = false;
+			for (int32_t k = 0; k < i; k++)
+			{
+				if (textures[k] == textures[j] && parameters[k].FirstPass <= parameter.LastPass &&
+					parameter.FirstPass <= parameters[k].LastPass)
+				{
+					isOverlapped = true;
+					break;
+				}
+			}
+
+			if (!isOverlapped)
+			{
+				textures[i] = textures[j];
+				SafeAddRef(textures[i]);
+				break;
+			}
+		}
+
+		if (textures[i] != nullptr)
+			continue;
+
+		if (parameter.IsDepth)
+		{
+			DepthTextureInitializationParameter depthParameter;
+			depthParameter.Size = parameter.Size;
+			textures[i] = CreateDepthTexture(depthParameter);
+		}
+		else
+		{
+			RenderTextureInitializationParameter renderParameter;
+			renderParameter.Size = parameter.Size;
+			renderParameter.Format = parameter.Format;
+			textures[i] = CreateRenderTexture(renderParameter);
+		}
+
+		if (textures[i] == nullptr)
+		{
+			for (int32_t j = 0; j < i; j++)
+			{
+				SafeRelease(textures[j]);
+			}
+			return false;
+		}
+	}
+
+	return true;
+}
+
 RenderPassPipelineState* Graphics::CreateRenderPassPipelineState(RenderPass* renderPass) { return nullptr; }
 
 std::vector<uint8_t> Graphics::CaptureRenderTarget(Texture* renderTarget)
@@ -21,11 +21,53 @@ struct RenderTextureInitializationParameter
 	Vec2I Size;
 	TextureFormatType Format = TextureFormatType::R8G8B8A8_UNORM;
 	bool IsMultiSampling = false;
+
+	/**
+		@brief	the number of samples if IsMultiSampling is true
+		@note
+		It is clamped to the number which a device supports.
+		A multisampled image is resolved into the texture at the end of a render pass.
+		On Vulkan, the multisampled image is transient, so AttachmentLoadOp::Load is treated as AttachmentLoadOp::DontCare.
+	*/
+	int32_t SamplingCount = 4;
+
+	/**
+		@brief	contents are used only in a render pass
+		@note
+		Memory may not be allocated on a tile based gpu. A texture cannot be sampled, copied nor locked.
+		Its store action is AttachmentStoreOp::DontCare by default.
+	*/
+	bool IsTransient = false;
 };
 
 struct DepthTextureInitializationParameter
 {
 	Vec2I Size;
+
+	//! a depth texture must be multisampled to be used with multisampled render textures
+	bool IsMultiSampling = false;
+
+	//! same as RenderTextureInitializationParameter::SamplingCount
+	int32_t SamplingCount = 4;
+
+	//! same as RenderTextureInitializationParameter::IsTransient
+	bool IsTransient = false;
+};
+
+/**
+	@brief	a render texture or a depth texture which is used only in a range of passes
+*/
+struct TransientTextureParameter
+{
+	Vec2I Size;
+	TextureFormatType Format = TextureFormatType::R8G8B8A8_UNORM;
+	bool IsDepth = false;
+
+	//! the index of the first pass which uses a texture
+	int32_t FirstPass = 0;
+
+	//! the index of the last pass which uses a texture
+	int32_t LastPass = 0;
 };
 
 /**
@@ -61,6 +103,34 @@ public:
 	virtual ConstantBuffer* CreateConstantBuffer(int32_t size);
 };
 
+/**
+	@brief	a subpass of a render pass
+	@note
+	Attachments which are written in a subpass can be read as input attachments by following subpasses without leaving a tile memory.
+*/
+struct SubpassParameter
+{
+	//! a mask of indexes of render textures which are written. a location of an output of a shader is the order in the mask
+	int32_t ColorAttachmentMask = 0;
+
+	//! a mask of indexes of render textures which are read. input_attachment_index of a shader is the order in the mask
+	int32_t InputAttachmentMask = 0;
+
+	//! whether a depth texture is tested and written
+	bool IsDepthUsed = true;
+
+	//! whether a depth texture is read after input attachments of render textures. It is not written in the subpass
+	bool IsDepthInput = false;
+
+	bool operator==(const SubpassParameter& value) const
+	{
+		return ColorAttachmentMask == value.ColorAttachmentMask && InputAttachmentMask == value.InputAttachmentMask &&
+			   IsDepthUsed == value.IsDepthUsed && IsDepthInput == value.IsDepthInput;
+	}
+
+	bool operator!=(const SubpassParameter& value) const { return !(*this == value); }
+};
+
 class RenderPass : public ReferenceObject
 {
 private:
@@ -68,8 +138,15 @@ private:
 
 	bool isDepthCleared_ = false;
 
+	std::array<AttachmentLoadOp, RenderTargetMax> colorLoadOps_;
+	std::array<AttachmentStoreOp, RenderTargetMax> colorStoreOps_;
+	AttachmentLoadOp depthLoadOp_ = AttachmentLoadOp::Load;
+	AttachmentStoreOp depthStoreOp_ = AttachmentStoreOp::Store;
+
 	Color8 color_;
 
+	FixedSizeVector<SubpassParameter, SubpassMax> subpasses_;
+
 	FixedSizeVector<Texture*, RenderTargetMax> renderTextures_;
 	Texture* depthTexture_ = nullptr;
 
@@ -82,7 +159,7 @@ protected:
 	bool getSize(Vec2I& size, const Texture** textures, int32_t textureCount, Texture* depthTexture) const;
 
 public:
-	RenderPass() = default;
+	RenderPass();
 	virtual ~RenderPass();
 
 	virtual bool GetIsColorCleared() const { return isColorCleared_; }
@@ -97,6 +174,41 @@ public:
 
 	virtual void SetClearColor(const Color8& color);
 
+	AttachmentLoadOp GetColorLoadOp(int32_t index) const { return colorLoadOps_.at(index); }
+
+	AttachmentStoreOp GetColorStoreOp(int32_t index) const { return colorStoreOps_.at(index); }
+
+	AttachmentLoadOp GetDepthLoadOp() const { return depthLoadOp_; }
+
+	AttachmentStoreOp GetDepthStoreOp() const { return depthStoreOp_; }
+
+	/**
+		@brief	specify actions of a render texture
+		@note
+		SetIsColorCleared overwrites load actions of all render textures.
+		Only Vulkan distinguishes actions per render texture. Other backends clear all render textures if one of them is cleared.
+	*/
+	virtual void SetColorAction(int32_t index, AttachmentLoadOp loadOp, AttachmentStoreOp storeOp);
+
+	/**
+		@brief	specify actions of a depth texture
+		@note
+		SetIsDepthCleared overwrites a load action.
+	*/
+	virtual void SetDepthAction(AttachmentLoadOp loadOp, AttachmentStoreOp storeOp);
+
+	/**
+		@brief	divide a render pass into subpasses which are started with CommandList::NextSubpass
+		@note
+		A render pass has one subpass which writes all textures if count is 0.
+		A pipeline state specifies a subpass with PipelineState::Subpass.
+		It must be called before the render pass is used by command lists. It is supported only in Vulkan.
+	*/
+	virtual bool SetSubpasses(const SubpassParameter* subpasses, int32_t count);
+
+	//! get subpasses. It is empty if SetSubpasses is not called
+	const FixedSizeVector<SubpassParameter, SubpassMax>& GetSubpasses() const { return subpasses_; }
+
 	virtual Texture* GetRenderTexture(int index) const { return renderTextures_.at(index); }
 
 	virtual int GetRenderTextureCount() const { return static_cast<int32_t>(renderTextures_.size()); }
@@ -118,6 +230,9 @@ struct RenderPassPipelineStateKey
 	bool IsColorCleared = true;
 	bool IsDepthCleared = true;
 
+	//! the number of samples of attachments
+	int32_t SamplingCount = 1;
+
 	bool operator==(const RenderPassPipelineStateKey& value) const
 	{
 		if (RenderTargetFormats.size() != value.RenderTargetFormats.size())
@@ -129,7 +244,8 @@ struct RenderPassPipelineStateKey
 				return false;
 		}
 
-		return (IsPresent == value.IsPresent && HasDepth == value.HasDepth && IsColorCleared == value.IsColorCleared && IsDepthCleared == value.IsDepthCleared);
+		return (IsPresent == value.IsPresent && HasDepth == value.HasDepth && IsColorCleared == value.IsColorCleared &&
+				IsDepthCleared == value.IsDepthCleared && SamplingCount == value.SamplingCount);
 	}
 
 	struct Hash
@@ -142,6 +258,7 @@ struct RenderPassPipelineStateKey
 			ret += std::hash<bool>()(key.HasDepth);
 			ret += std::hash<bool>()(key.IsColorCleared);
 			ret += std::hash<bool>()(key.IsDepthCleared);
+			ret += std::hash<int32_t>()(key.SamplingCount);
 
 			for (int32_t i = 0; i < key.RenderTargetFormats.size(); i++)
 			{
@@ -204,6 +321,13 @@ public:
 		@param	count	the number of index
 	*/
 	virtual IndexBuffer* CreateIndexBuffer(int32_t stride, int32_t count);
+
+	/**
+		@brief	create a buffer which contains arguments of indirect draws
+		@param	size	the size of buffer
+	*/
+	virtual IndirectBuffer* CreateIndirectBuffer(int32_t size);
+
 	virtual Shader* CreateShader(DataStructure* data, int32_t count);
 	virtual PipelineState* CreatePiplineState();
 
@@ -233,6 +357,17 @@ public:
 
 	virtual Texture* CreateDepthTexture(const DepthTextureInitializationParameter& parameter) { return nullptr; }
 
+	/**
+		@brief	create textures which are used only in ranges of passes
+		@param	parameters	parameters of textures
+		@param	count	the number of textures
+		@param	textures	an array which receives created textures
+		@note
+		Textures whose ranges don't overlap may share memory, so contents of a texture are undefined at the first pass.
+		Memory is shared among only textures which are created at once.
+	*/
+	virtual bool CreateTransientTextures(const TransientTextureParameter* parameters, int32_t count, Texture** textures);
+
 	/**
 		@brief	create texture from pointer or id in current platform
 	*/
@@ -254,7 +389,11 @@ public:
 	*/
 	virtual RenderPassPipelineState* CreateRenderPassPipelineState(const RenderPassPipelineStateKey& key) { return nullptr; }
 
-	/** For testing. Wait for all commands in queue to complete. Then read data from specified render target. */
+	/**
+		@brief	For testing. Wait for all commands in queue to complete. Then read data from specified render target.
+		@note
+		Use CommandList::ReadbackTexture to read textures every frame without waiting for gpu.
+	*/
 	virtual std::vector<uint8_t> CaptureRenderTarget(Texture* renderTarget);
 
 	/**
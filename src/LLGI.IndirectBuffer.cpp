@@ -0,0 +1,14 @@
+#include "LLGI.IndirectBuffer.h"
+
+namespace LLGI
+{
+
+void* IndirectBuffer::Lock() { return nullptr; }
+
+void* IndirectBuffer::Lock(int32_t offset, int32_t size) { return nullptr; }
+
+void IndirectBuffer::Unlock() {}
+
+int32_t IndirectBuffer::GetSize() { return 0; }
+
+} // namespace LLGI
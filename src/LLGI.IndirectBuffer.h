@@ -0,0 +1,55 @@
+
+#pragma once
+
+#include "LLGI.Base.h"
+
+namespace LLGI
+{
+
+/**
+	@brief	arguments of CommandList::DrawIndirect
+	@note
+	The layout is same as VkDrawIndirectCommand, D3D12_DRAW_ARGUMENTS and MTLDrawPrimitivesIndirectArguments.
+*/
+struct DrawIndirectArguments
+{
+	uint32_t VertexCount;
+	uint32_t InstanceCount;
+	uint32_t FirstVertex;
+	uint32_t FirstInstance;
+};
+
+/**
+	@brief	arguments of CommandList::DrawIndexedIndirect
+	@note
+	The layout is same as VkDrawIndexedIndirectCommand, D3D12_DRAW_INDEXED_ARGUMENTS and MTLDrawIndexedPrimitivesIndirectArguments.
+*/
+struct DrawIndexedIndirectArguments
+{
+	uint32_t IndexCount;
+	uint32_t InstanceCount;
+	uint32_t FirstIndex;
+	int32_t VertexOffset;
+	uint32_t FirstInstance;
+};
+
+/**
+	@brief	a buffer on gpu which contains arguments of indirect draws
+*/
+class IndirectBuffer : public ReferenceObject
+{
+private:
+public:
+	IndirectBuffer() = default;
+	virtual ~IndirectBuffer() = default;
+
+	virtual void* Lock();
+
+	virtual void* Lock(int32_t offset, int32_t size);
+
+	virtual void Unlock();
+
+	virtual int32_t GetSize();
+};
+
+} // namespace LLGI
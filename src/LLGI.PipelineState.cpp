@@ -1,11 +1,64 @@
 
 #include "LLGI.PipelineState.h"
 #include "LLGI.Graphics.h"
+#include <string.h>
 
 namespace LLGI
 {
 
-PipelineState::PipelineState() { VertexLayoutSemantics.fill(0); }
+PipelineState::PipelineState()
+{
+	VertexLayoutSemantics.fill(0);
+	PushConstantSizes.fill(0);
+}
+
+int32_t PipelineState::GetPushConstantOffset(ShaderStageType stage) const
+{
+	int32_t offset = 0;
+	for (int i = 0; i < static_cast<int>(stage); i++)
+	{
+		offset += PushConstantSizes[i];
+	}
+	return offset;
+}
+
+void PipelineState::SetSpecializationConstant(uint32_t id, int32_t value) { SetSpecializationConstant(id, static_cast<uint32_t>(value)); }
+
+void PipelineState::SetSpecializationConstant(uint32_t id, uint32_t value)
+{
+	for (auto& constant : SpecializationConstants)
+	{
+		if (constant.ID == id)
+		{
+			constant.Value = value;
+			return;
+		}
+	}
+
+	SpecializationConstant constant;
+	constant.ID = id;
+	constant.Value = value;
+	SpecializationConstants.push_back(constant);
+}
+
+void PipelineState::SetSpecializationConstant(uint32_t id, float value)
+{
+	uint32_t bits = 0;
+	memcpy(&bits, &value, sizeof(float));
+	SetSpecializationConstant(id, bits);
+}
+
+DynamicPipelineState PipelineState::GetDynamicState() const
+{
+	DynamicPipelineState state;
+	state.Culling = Culling;
+	state.Topology = Topology;
+	state.IsDepthTestEnabled = IsDepthTestEnabled;
+	state.IsDepthWriteEnabled = IsDepthWriteEnabled;
+	state.IsStencilTestEnabled = IsStencilTestEnabled;
+	state.DepthFunc = DepthFunc;
+	return state;
+}
 
 void PipelineState::SetShader(ShaderStageType stage, Shader* shader) {}
 
@@ -15,6 +68,6 @@ void PipelineState::SetRenderPassPipelineState(RenderPassPipelineState* renderPa
 	renderPassPipelineState_ = CreateSharedPtr(renderPassPipelineState);
 }
 
-void PipelineState::Compile() {}
+bool PipelineState::Compile() { return false; }
 
 } // namespace LLGI
\ No newline at end of file
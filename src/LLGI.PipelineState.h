@@ -6,6 +6,17 @@
 namespace LLGI
 {
 
+/**
+	@brief	a value which replaces a specialization constant of shaders when a pipeline is compiled
+*/
+struct SpecializationConstant
+{
+	uint32_t ID = 0;
+
+	//! a bit pattern of int, uint, float or bool
+	uint32_t Value = 0;
+};
+
 class PipelineState : public ReferenceObject
 {
 protected:
@@ -35,6 +46,13 @@ public:
 	
 	bool IsMSAA = false;
 
+	/**
+		@brief	the index of a subpass which a pipeline is used in
+		@note
+		It is supported only in Vulkan. See RenderPass::SetSubpasses.
+	*/
+	int32_t Subpass = 0;
+
 	std::array<std::string, VertexLayoutMax> VertexLayoutNames;
 	std::array<VertexLayoutFormat, VertexLayoutMax> VertexLayouts;
 	
@@ -42,11 +60,51 @@ public:
 	std::array<int32_t, VertexLayoutMax> VertexLayoutSemantics;
 	int32_t VertexLayoutCount = 0;
 
+	/**
+		@brief	the size of push constants of each stage in bytes
+		@note
+		Ranges are placed in order of stages. For example, the range of the pixel shader starts at the size of the vertex shader's one.
+		Sizes must be multiples of 4 and the total must not exceed maxPushConstantsSize of a device, otherwise Compile fails.
+		It is supported only in Vulkan.
+	*/
+	std::array<int32_t, static_cast<int>(ShaderStageType::Max)> PushConstantSizes;
+
+	/**
+		@brief	values of specialization constants which are applied to all stages
+		@note
+		Constants which are not declared in a shader are ignored.
+		It is supported only in Vulkan.
+	*/
+	std::vector<SpecializationConstant> SpecializationConstants;
+
+	/**
+		@brief	set a value of a specialization constant
+		@note
+		It must be called before Compile.
+	*/
+	void SetSpecializationConstant(uint32_t id, int32_t value);
+	void SetSpecializationConstant(uint32_t id, uint32_t value);
+	void SetSpecializationConstant(uint32_t id, float value);
+
+	/**
+		@brief	get the offset of push constants of the stage in bytes
+	*/
+	int32_t GetPushConstantOffset(ShaderStageType stage) const;
+
+	/**
+		@brief	get states which can be overridden by CommandList::SetDynamicState
+	*/
+	DynamicPipelineState GetDynamicState() const;
+
 	virtual void SetShader(ShaderStageType stage, Shader* shader);
 
 	virtual void SetRenderPassPipelineState(RenderPassPipelineState* renderPassPipelineState);
 
-	virtual void Compile();
+	/**
+		@brief	create a pipeline with current states
+		@return	whether the pipeline is created
+	*/
+	virtual bool Compile();
 };
 
 } // namespace LLGI
@@ -14,6 +14,13 @@ struct PlatformParameter
 {
 	DeviceType Device;
 	bool WaitVSync;
+
+	/**
+		@brief	enable a bindless texture mode if a device supports it
+		@note
+		It is supported only in Vulkan. See Texture::GetBindlessIndex.
+	*/
+	bool IsBindlessEnabled = false;
 };
 
 Window* CreateWindow(const char* title, Vec2I windowSize);
@@ -12,6 +12,8 @@ private:
 protected:
 	TextureType type_ = TextureType::Unknown;
 	TextureFormatType format_ = TextureFormatType::Uknown;
+	bool isTransient_ = false;
+	int32_t samplingCount_ = 1;
 
 public:
 	Texture() = default;
@@ -27,6 +29,19 @@ public:
 
 	TextureType GetType() const { return type_; }
 
+	//! whether contents are used only in a render pass. See RenderTextureInitializationParameter::IsTransient
+	bool GetIsTransient() const { return isTransient_; }
+
+	//! the number of samples. It is larger than 1 if a texture is multisampled
+	int32_t GetSamplingCount() const { return samplingCount_; }
+
+	/**
+		@brief	get a stable index in a global texture table of a bindless texture mode
+		@note
+		It returns -1 if a bindless texture mode is not enabled.
+	*/
+	virtual int32_t GetBindlessIndex() const { return -1; }
+
 	virtual TextureFormatType GetFormat() const;
 };
 
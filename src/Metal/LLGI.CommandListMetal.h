@@ -8,6 +8,7 @@ namespace LLGI
 
 struct CommandList_Impl;
 class IndexBuffer;
+class PipelineStateMetal;
 
 class CommandListMetal : public CommandList
 {
@@ -17,6 +18,11 @@ class CommandListMetal : public CommandList
 	MTLSamplerDescriptor* samplers[2][2];
 	id<MTLSamplerState> samplerStates[2][2];
 
+	//! bind a vertex buffer, constant buffers, textures and a pipeline for drawing
+	PipelineStateMetal* BindDrawingStates(bool isIndexed);
+
+	void DrawIndexedPrimitives(PipelineStateMetal* pip, int32_t indexCount, int32_t firstIndex, int32_t baseVertex);
+
 public:
 	CommandListMetal();
 	virtual ~CommandListMetal();
@@ -27,6 +33,8 @@ public:
 	void End() override;
 	void SetScissor(int32_t x, int32_t y, int32_t width, int32_t height) override;
 	void Draw(int32_t pritimiveCount) override;
+	void DrawIndexed(int32_t indexCount, int32_t firstIndex, int32_t baseVertex) override;
+	void DrawNonIndexed(int32_t vertexCount, int32_t firstVertex) override;
     void CopyTexture(Texture* src, Texture* dst) override;
 	void BeginRenderPass(RenderPass* renderPass) override;
 	void EndRenderPass() override;
@@ -193,7 +193,24 @@ void CommandListMetal::End() {
 
 void CommandListMetal::SetScissor(int32_t x, int32_t y, int32_t width, int32_t height) { impl->SetScissor(x, y, width, height); }
 
-void CommandListMetal::Draw(int32_t pritimiveCount)
+static MTLPrimitiveType GetPrimitiveType(TopologyType topologyType)
+{
+	switch (topologyType)
+	{
+	case TopologyType::Line:
+		return MTLPrimitiveTypeLine;
+	case TopologyType::TriangleStrip:
+		return MTLPrimitiveTypeTriangleStrip;
+	case TopologyType::LineStrip:
+		return MTLPrimitiveTypeLineStrip;
+	case TopologyType::Point:
+		return MTLPrimitiveTypePoint;
+	default:
+		return MTLPrimitiveTypeTriangle;
+	}
+}
+
+PipelineStateMetal* CommandListMetal::BindDrawingStates(bool isIndexed)
 {
 	BindingVertexBuffer vb_;
 	BindingIndexBuffer ib_;
@@ -208,11 +225,10 @@ void CommandListMetal::Draw(int32_t pritimiveCount)
 	GetCurrentPipelineState(pip_, isPipDirtied);
 
 	assert(vb_.vertexBuffer != nullptr);
-	assert(ib_.indexBuffer != nullptr);
+	assert(!isIndexed || ib_.indexBuffer != nullptr);
 	assert(pip_ != nullptr);
 
 	auto vb = static_cast<VertexBufferMetal*>(vb_.vertexBuffer);
-	auto ib = static_cast<IndexBufferMetal*>(ib_.indexBuffer);
 	auto pip = static_cast<PipelineStateMetal*>(pip_);
     
     // set cull mode
@@ -286,33 +302,62 @@ void CommandListMetal::Draw(int32_t pritimiveCount)
 		[impl->renderEncoder setStencilReferenceValue:0xFF];
 	}
 
-	// draw
-	int indexPerPrim = 0;
-	if (pip->Topology == TopologyType::Triangle)
-		indexPerPrim = 3;
-	if (pip->Topology == TopologyType::Line)
-		indexPerPrim = 2;
+	return pip;
+}
 
-	MTLPrimitiveType topology = MTLPrimitiveTypeTriangle;
-	MTLIndexType indexType = MTLIndexTypeUInt32;
+void CommandListMetal::DrawIndexedPrimitives(PipelineStateMetal* pip, int32_t indexCount, int32_t firstIndex, int32_t baseVertex)
+{
+	BindingIndexBuffer ib_;
+	bool isIBDirtied = false;
+	GetCurrentIndexBuffer(ib_, isIBDirtied);
 
-	if (pip->Topology == TopologyType::Line)
+	auto ib = static_cast<IndexBufferMetal*>(ib_.indexBuffer);
+	MTLIndexType indexType = ib->GetStride() == 2 ? MTLIndexTypeUInt16 : MTLIndexTypeUInt32;
+	auto indexBufferOffset = ib_.offset + firstIndex * ib->GetStride();
+
+	if (baseVertex == 0)
 	{
-		topology = MTLPrimitiveTypeLine;
+		[impl->renderEncoder drawIndexedPrimitives:GetPrimitiveType(pip->Topology)
+										indexCount:indexCount
+										 indexType:indexType
+									   indexBuffer:ib->GetImpl()->buffer
+								 indexBufferOffset:indexBufferOffset];
 	}
-
-	if (ib->GetStride() == 2)
+	else
 	{
-		indexType = MTLIndexTypeUInt16;
+		[impl->renderEncoder drawIndexedPrimitives:GetPrimitiveType(pip->Topology)
+										indexCount:indexCount
+										 indexType:indexType
+									   indexBuffer:ib->GetImpl()->buffer
+								 indexBufferOffset:indexBufferOffset
+									 instanceCount:1
+										baseVertex:baseVertex
+									  baseInstance:0];
 	}
+}
 
-	[impl->renderEncoder drawIndexedPrimitives:topology
-									indexCount:pritimiveCount * indexPerPrim
-									 indexType:indexType
-								   indexBuffer:ib->GetImpl()->buffer
-							 indexBufferOffset:ib_.offset];
-    
-    CommandList::Draw(pritimiveCount);
+void CommandListMetal::Draw(int32_t pritimiveCount)
+{
+	auto pip = BindDrawingStates(true);
+	DrawIndexedPrimitives(pip, GetVertexCountFromPrimitiveCount(pip->Topology, pritimiveCount), 0, 0);
+
+	CommandList::Draw(pritimiveCount);
+}
+
+void CommandListMetal::DrawIndexed(int32_t indexCount, int32_t firstIndex, int32_t baseVertex)
+{
+	auto pip = BindDrawingStates(true);
+	DrawIndexedPrimitives(pip, indexCount, firstIndex, baseVertex);
+
+	CommandList::DrawIndexed(indexCount, firstIndex, baseVertex);
+}
+
+void CommandListMetal::DrawNonIndexed(int32_t vertexCount, int32_t firstVertex)
+{
+	auto pip = BindDrawingStates(false);
+	[impl->renderEncoder drawPrimitives:GetPrimitiveType(pip->Topology) vertexStart:firstVertex vertexCount:vertexCount];
+
+	CommandList::DrawNonIndexed(vertexCount, firstVertex);
 }
 
 void CommandListMetal::CopyTexture(Texture* src, Texture* dst)
@@ -88,7 +88,7 @@ struct PipelineState_Impl
 	PipelineState_Impl();
 	~PipelineState_Impl();
 
-	void Compile(PipelineState* self, Graphics_Impl* graphics);
+	bool Compile(PipelineState* self, Graphics_Impl* graphics);
 };
 
 struct Buffer_Impl
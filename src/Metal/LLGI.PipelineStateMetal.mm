@@ -32,7 +32,7 @@ PipelineState_Impl::~PipelineState_Impl()
 	}
 }
 
-void PipelineState_Impl::Compile(PipelineState* self, Graphics_Impl* graphics)
+bool PipelineState_Impl::Compile(PipelineState* self, Graphics_Impl* graphics)
 {
 	auto self_ = static_cast<PipelineStateMetal*>(self);
 	auto renderPassPipelineStateMetal_ = static_cast<RenderPassPipelineStateMetal*>(self_->GetRenderPassPipelineState());
@@ -148,14 +148,18 @@ void PipelineState_Impl::Compile(PipelineState* self, Graphics_Impl* graphics)
 	[depthStencilDescriptor release];
 
 	// topology
-	if (self_->Topology == TopologyType::Triangle)
+	if (self_->Topology == TopologyType::Triangle || self_->Topology == TopologyType::TriangleStrip)
 	{
 		pipelineStateDescriptor.inputPrimitiveTopology = MTLPrimitiveTopologyClassTriangle;
 	}
-	else if (self_->Topology == TopologyType::Line)
+	else if (self_->Topology == TopologyType::Line || self_->Topology == TopologyType::LineStrip)
 	{
 		pipelineStateDescriptor.inputPrimitiveTopology = MTLPrimitiveTopologyClassLine;
 	}
+	else if (self_->Topology == TopologyType::Point)
+	{
+		pipelineStateDescriptor.inputPrimitiveTopology = MTLPrimitiveTopologyClassPoint;
+	}
 	else
 	{
 		assert(0);
@@ -217,6 +221,7 @@ void PipelineState_Impl::Compile(PipelineState* self, Graphics_Impl* graphics)
 
 	NSError* pipelineError = nil;
 	pipelineState = [graphics->device newRenderPipelineStateWithDescriptor:pipelineStateDescriptor error:&pipelineError];
+	return pipelineState != nil;
 }
 
 PipelineStateMetal::PipelineStateMetal()
@@ -253,6 +258,6 @@ void PipelineStateMetal::SetShader(ShaderStageType stage, Shader* shader)
 	shaders[static_cast<int>(stage)] = shader;
 }
 
-void PipelineStateMetal::Compile() { impl->Compile(this, graphics_->GetImpl()); }
+bool PipelineStateMetal::Compile() { return impl->Compile(this, graphics_->GetImpl()); }
 
 }
@@ -32,6 +32,10 @@ public:
 
 	void SetIsDepthCleared(bool isDepthCleared) override;
 
+	void SetColorAction(int32_t index, AttachmentLoadOp loadOp, AttachmentStoreOp storeOp) override;
+
+	void SetDepthAction(AttachmentLoadOp loadOp, AttachmentStoreOp storeOp) override;
+
 	void SetClearColor(const Color8& color) override;
 	
 	RenderPass_Impl* GetImpl() const;
@@ -121,6 +121,18 @@ void RenderPassMetal::SetIsDepthCleared(bool isDepthCleared)
 	RenderPass::SetIsDepthCleared(isDepthCleared);
 }
 
+void RenderPassMetal::SetColorAction(int32_t index, AttachmentLoadOp loadOp, AttachmentStoreOp storeOp)
+{
+	RenderPass::SetColorAction(index, loadOp, storeOp);
+	impl->isColorCleared = GetIsColorCleared();
+}
+
+void RenderPassMetal::SetDepthAction(AttachmentLoadOp loadOp, AttachmentStoreOp storeOp)
+{
+	RenderPass::SetDepthAction(loadOp, storeOp);
+	impl->isDepthCleared = GetIsDepthCleared();
+}
+
 void RenderPassMetal::SetClearColor(const Color8& color)
 {
 	impl->clearColor = color;
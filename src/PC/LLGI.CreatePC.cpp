@@ -73,7 +73,7 @@ Platform* CreatePlatform(const PlatformParameter& parameter, Window* window)
 #endif
 	{
 		auto platform = new PlatformVulkan();
-		if (!platform->Initialize(window, parameter.WaitVSync))
+		if (!platform->Initialize(window, parameter.WaitVSync, parameter.IsBindlessEnabled))
 		{
 			SafeRelease(platform);
 			return nullptr;
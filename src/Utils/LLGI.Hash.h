@@ -0,0 +1,71 @@
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace LLGI
+{
+
+static const uint64_t FNV1aOffsetBasis64 = 14695981039346656037ULL;
+
+/**
+	@brief	calculate a 64bit FNV-1a hash of data
+	@note
+	A hash of previous data can be specified as an initial value to hash several data in sequence.
+*/
+inline uint64_t CalculateFNV1a64(const void* data, size_t size, uint64_t hash = FNV1aOffsetBasis64)
+{
+	auto bytes = static_cast<const uint8_t*>(data);
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+/**
+	@brief	calculate a 64bit MurmurHash64A of data
+	@note
+	It is independent of FNV-1a, so a pair of both hashes identifies data without comparing bytes.
+*/
+inline uint64_t CalculateMurmur64(const void* data, size_t size, uint64_t seed = 0)
+{
+	const uint64_t m = 0xc6a4a7935bd1e995ULL;
+	const int r = 47;
+
+	auto bytes = static_cast<const uint8_t*>(data);
+	uint64_t hash = seed ^ (size * m);
+
+	size_t i = 0;
+	for (; i + 8 <= size; i += 8)
+	{
+		uint64_t k = 0;
+		memcpy(&k, bytes + i, sizeof(k));
+
+		k *= m;
+		k ^= k >> r;
+		k *= m;
+
+		hash ^= k;
+		hash *= m;
+	}
+
+	if (i < size)
+	{
+		for (size_t j = size - i; j > 0; j--)
+		{
+			hash ^= static_cast<uint64_t>(bytes[i + j - 1]) << (8 * (j - 1));
+		}
+		hash *= m;
+	}
+
+	hash ^= hash >> r;
+	hash *= m;
+	hash ^= hash >> r;
+	return hash;
+}
+
+} // namespace LLGI
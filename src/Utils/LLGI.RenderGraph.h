@@ -0,0 +1,567 @@
+
+#pragma once
+
+#include "../LLGI.CommandList.h"
+#include "../LLGI.Graphics.h"
+#include "../LLGI.Texture.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace LLGI
+{
+
+/**
+	@brief	a handle of a texture in RenderGraph
+*/
+struct RenderGraphTexture
+{
+	int32_t Index = -1;
+
+	bool IsValid() const { return Index >= 0; }
+};
+
+/**
+	@brief	passes which are executed in a frame
+	@note
+	Passes declare textures which they read and write.
+	Compile culls passes whose outputs are not used and creates transient textures.
+	Memory of transient textures is shared if they are not used in the same passes.
+	Execute issues barriers of a pass at once before the pass.
+
+	Passes are executed in the order of AddPass, so a texture must be written by a preceding pass before it is read.
+	A compiled graph can be executed every frame. Call Reset to build another graph.
+*/
+class RenderGraph
+{
+public:
+	class Builder
+	{
+		friend class RenderGraph;
+
+	private:
+		RenderGraph* graph_ = nullptr;
+		int32_t pass_ = 0;
+
+		Builder(RenderGraph* graph, int32_t pass) : graph_(graph), pass_(pass) {}
+
+	public:
+		//! read a texture in shaders
+		void Read(RenderGraphTexture texture) { graph_->addAccess(pass_, texture, TextureAccessType::ShaderRead); }
+
+		//! draw into a texture. textures are bound in the order of calls
+		void WriteColor(RenderGraphTexture texture) { graph_->addAccess(pass_, texture, TextureAccessType::RenderTarget); }
+
+		void WriteDepth(RenderGraphTexture texture) { graph_->addAccess(pass_, texture, TextureAccessType::DepthStencil); }
+
+		//! read a texture with CommandList::CopyTexture
+		void CopyFrom(RenderGraphTexture texture) { graph_->addAccess(pass_, texture, TextureAccessType::CopySource); }
+
+		//! write a texture with CommandList::CopyTexture
+		void CopyTo(RenderGraphTexture texture) { graph_->addAccess(pass_, texture, TextureAccessType::CopyDestination); }
+
+		void SetClearColor(const Color8& color)
+		{
+			graph_->passes_[pass_].IsColorCleared = true;
+			graph_->passes_[pass_].ClearColor = color;
+		}
+
+		void SetIsDepthCleared(bool isDepthCleared) { graph_->passes_[pass_].IsDepthCleared = isDepthCleared; }
+
+		/**
+			@brief	keep the pass even if nothing reads its outputs
+			@note
+			It is required by a pass which draws into a screen or doesn't write textures.
+		*/
+		void SetHasSideEffect() { graph_->passes_[pass_].HasSideEffect = true; }
+	};
+
+	typedef std::function<void(Builder& builder)> SetupFunc;
+	typedef std::function<void(const RenderGraph& graph, CommandList* commandList)> ExecuteFunc;
+
+private:
+	struct TextureNode
+	{
+		std::string Name;
+		TransientTextureParameter Parameter;
+		Texture* Target = nullptr;
+		bool IsImported = false;
+		std::vector<int32_t> Writers;
+		int32_t ReaderCount = 0;
+	};
+
+	struct Access
+	{
+		int32_t TextureIndex = 0;
+		TextureAccessType Type = TextureAccessType::ShaderRead;
+	};
+
+	struct PassNode
+	{
+		std::string Name;
+		std::vector<Access> Accesses;
+		ExecuteFunc Execute;
+		bool HasSideEffect = false;
+		bool IsColorCleared = false;
+		Color8 ClearColor;
+		bool IsDepthCleared = false;
+
+		int32_t ReferenceCount = 0;
+		bool IsCulled = false;
+		RenderPass* RenderPassTarget = nullptr;
+		std::vector<TextureBarrier> Barriers;
+	};
+
+	Graphics* graphics_ = nullptr;
+	std::vector<TextureNode> textures_;
+	std::vector<PassNode> passes_;
+	bool isCompiled_ = false;
+
+	static void LogError(const std::string& message) { Log(LogType::Error, ("RenderGraph : " + message).c_str()); }
+
+	static bool IsWrite(TextureAccessType type)
+	{
+		return type == TextureAccessType::RenderTarget || type == TextureAccessType::DepthStencil ||
+			   type == TextureAccessType::CopyDestination;
+	}
+
+	void addAccess(int32_t pass, RenderGraphTexture texture, TextureAccessType type)
+	{
+		if (!texture.IsValid() || texture.Index >= static_cast<int32_t>(textures_.size()))
+		{
+			LogError("an invalid texture is specified in " + passes_[pass].Name);
+			return;
+		}
+
+		for (const auto& access : passes_[pass].Accesses)
+		{
+			if (access.TextureIndex == texture.Index)
+			{
+				LogError(textures_[texture.Index].Name + " is used twice in " + passes_[pass].Name);
+				return;
+			}
+		}
+
+		Access access;
+		access.TextureIndex = texture.Index;
+		access.Type = type;
+		passes_[pass].Accesses.push_back(access);
+
+		if (IsWrite(type))
+		{
+			textures_[texture.Index].Writers.push_back(pass);
+		}
+	}
+
+	void releaseResources()
+	{
+		for (auto& pass : passes_)
+		{
+			SafeRelease(pass.RenderPassTarget);
+			pass.Barriers.clear();
+		}
+
+		for (auto& texture : textures_)
+		{
+			if (!texture.IsImported)
+			{
+				SafeRelease(texture.Target);
+			}
+		}
+
+		isCompiled_ = false;
+	}
+
+	void cull()
+	{
+		for (auto& texture : textures_)
+		{
+			// imported textures are read outside of the graph
+			texture.ReaderCount = texture.IsImported ? 1 : 0;
+		}
+
+		for (auto& pass : passes_)
+		{
+			pass.ReferenceCount = 0;
+			pass.IsCulled = false;
+
+			for (const auto& access : pass.Accesses)
+			{
+				if (IsWrite(access.Type))
+				{
+					pass.ReferenceCount++;
+				}
+				else
+				{
+					textures_[access.TextureIndex].ReaderCount++;
+				}
+			}
+		}
+
+		std::vector<int32_t> unusedTextures;
+		for (size_t i = 0; i < textures_.size(); i++)
+		{
+			if (textures_[i].ReaderCount == 0)
+			{
+				unusedTextures.push_back(static_cast<int32_t>(i));
+			}
+		}
+
+		auto cullPass = [this, &unusedTextures](PassNode& pass) -> void {
+			pass.IsCulled = true;
+
+			for (const auto& access : pass.Accesses)
+			{
+				if (IsWrite(access.Type))
+					continue;
+
+				auto& texture = textures_[access.TextureIndex];
+				texture.ReaderCount--;
+				if (texture.ReaderCount == 0)
+				{
+					unusedTextures.push_back(access.TextureIndex);
+				}
+			}
+		};
+
+		for (auto& pass : passes_)
+		{
+			if (pass.ReferenceCount == 0 && !pass.HasSideEffect)
+			{
+				cullPass(pass);
+			}
+		}
+
+		while (unusedTextures.size() > 0)
+		{
+			auto index = unusedTextures.back();
+			unusedTextures.pop_back();
+
+			for (auto writer : textures_[index].Writers)
+			{
+				auto& pass = passes_[writer];
+				if (pass.IsCulled || pass.HasSideEffect)
+					continue;
+
+				pass.ReferenceCount--;
+				if (pass.ReferenceCount == 0)
+				{
+					cullPass(pass);
+				}
+			}
+		}
+	}
+
+	bool createTextures()
+	{
+		std::vector<int32_t> firstPasses(textures_.size(), -1);
+		std::vector<int32_t> lastPasses(textures_.size(), -1);
+		int32_t executedIndex = 0;
+
+		for (auto& pass : passes_)
+		{
+			if (pass.IsCulled)
+				continue;
+
+			for (const auto& access : pass.Accesses)
+			{
+				auto index = access.TextureIndex;
+				if (firstPasses[index] < 0)
+				{
+					if (!textures_[index].IsImported && !IsWrite(access.Type))
+					{
+						LogError(textures_[index].Name + " is read before it is written in " + pass.Name);
+						return false;
+					}
+
+					firstPasses[index] = executedIndex;
+				}
+
+				lastPasses[index] = executedIndex;
+			}
+
+			executedIndex++;
+		}
+
+		std::vector<int32_t> indexes;
+		std::vector<TransientTextureParameter> parameters;
+		for (size_t i = 0; i < textures_.size(); i++)
+		{
+			if (textures_[i].IsImported || firstPasses[i] < 0)
+				continue;
+
+			auto parameter = textures_[i].Parameter;
+			parameter.FirstPass = firstPasses[i];
+			parameter.LastPass = lastPasses[i];
+			indexes.push_back(static_cast<int32_t>(i));
+			parameters.push_back(parameter);
+		}
+
+		if (parameters.size() == 0)
+			return true;
+
+		std::vector<Texture*> created(parameters.size(), nullptr);
+		if (!graphics_->CreateTransientTextures(parameters.data(), static_cast<int32_t>(parameters.size()), created.data()))
+		{
+			LogError("failed to create transient textures.");
+			return false;
+		}
+
+		for (size_t i = 0; i < indexes.size(); i++)
+		{
+			textures_[indexes[i]].Target = created[i];
+		}
+
+		return true;
+	}
+
+	void createBarriers()
+	{
+		std::vector<bool> isUsed(textures_.size(), false);
+
+		for (auto& pass : passes_)
+		{
+			if (pass.IsCulled)
+				continue;
+
+			for (const auto& access : pass.Accesses)
+			{
+				const auto& texture = textures_[access.TextureIndex];
+
+				// contents of memory which may be used by another texture are discarded at the first pass
+				TextureBarrier barrier;
+				barrier.Target = texture.Target;
+				barrier.Access = access.Type;
+				barrier.IsDiscarded = !texture.IsImported && !isUsed[access.TextureIndex];
+				pass.Barriers.push_back(barrier);
+
+				isUsed[access.TextureIndex] = true;
+			}
+		}
+	}
+
+	bool createRenderPasses()
+	{
+		for (auto& pass : passes_)
+		{
+			if (pass.IsCulled)
+				continue;
+
+			std::vector<const Texture*> colors;
+			Texture* depth = nullptr;
+
+			for (const auto& access : pass.Accesses)
+			{
+				if (access.Type == TextureAccessType::RenderTarget)
+				{
+					colors.push_back(textures_[access.TextureIndex].Target);
+				}
+				else if (access.Type == TextureAccessType::DepthStencil)
+				{
+					depth = textures_[access.TextureIndex].Target;
+				}
+			}
+
+			if (colors.size() == 0)
+			{
+				if (depth != nullptr)
+				{
+					LogError("a color target is required with a depth target in " + pass.Name);
+					return false;
+				}
+				continue;
+			}
+
+			pass.RenderPassTarget = graphics_->CreateRenderPass(colors.data(), static_cast<int32_t>(colors.size()), depth);
+			if (pass.RenderPassTarget == nullptr)
+			{
+				LogError("failed to create a render pass in " + pass.Name);
+				return false;
+			}
+
+			pass.RenderPassTarget->SetIsColorCleared(pass.IsColorCleared);
+			pass.RenderPassTarget->SetClearColor(pass.ClearColor);
+			pass.RenderPassTarget->SetIsDepthCleared(pass.IsDepthCleared);
+		}
+
+		return true;
+	}
+
+public:
+	RenderGraph(Graphics* graphics) { SafeAssign(graphics_, graphics); }
+
+	RenderGraph(const RenderGraph&) = delete;
+	RenderGraph& operator=(const RenderGraph&) = delete;
+
+	~RenderGraph()
+	{
+		Reset();
+		SafeRelease(graphics_);
+	}
+
+	/**
+		@brief	declare a texture which is created by the graph
+		@note
+		Its contents are undefined at the first pass which uses it.
+	*/
+	RenderGraphTexture CreateTexture(const char* name, const Vec2I& size, TextureFormatType format, bool isDepth = false)
+	{
+		TextureNode node;
+		node.Name = name;
+		node.Parameter.Size = size;
+		node.Parameter.Format = format;
+		node.Parameter.IsDepth = isDepth;
+		textures_.push_back(node);
+
+		RenderGraphTexture ret;
+		ret.Index = static_cast<int32_t>(textures_.size()) - 1;
+		return ret;
+	}
+
+	/**
+		@brief	declare a texture which is created outside of the graph
+		@note
+		Passes which write it are not culled.
+	*/
+	RenderGraphTexture ImportTexture(const char* name, Texture* texture)
+	{
+		TextureNode node;
+		node.Name = name;
+		node.Parameter.Size = texture->GetSizeAs2D();
+		node.Parameter.Format = texture->GetFormat();
+		node.Parameter.IsDepth = texture->GetType() == TextureType::Depth;
+		node.IsImported = true;
+		SafeAssign(node.Target, texture);
+		textures_.push_back(node);
+
+		RenderGraphTexture ret;
+		ret.Index = static_cast<int32_t>(textures_.size()) - 1;
+		return ret;
+	}
+
+	/**
+		@brief	add a pass
+		@param	setup	a function which declares textures with a builder. It is called immediately.
+		@param	execute	a function which records commands. A render pass is begun before it if the pass writes colors.
+	*/
+	void AddPass(const char* name, const SetupFunc& setup, const ExecuteFunc& execute)
+	{
+		if (isCompiled_)
+		{
+			LogError("a pass can't be added after Compile.");
+			return;
+		}
+
+		PassNode pass;
+		pass.Name = name;
+		pass.Execute = execute;
+		passes_.push_back(pass);
+
+		Builder builder(this, static_cast<int32_t>(passes_.size()) - 1);
+		setup(builder);
+	}
+
+	bool Compile()
+	{
+		if (isCompiled_)
+			return true;
+
+		cull();
+
+		if (!createTextures() || !createRenderPasses())
+		{
+			releaseResources();
+			return false;
+		}
+
+		createBarriers();
+
+		isCompiled_ = true;
+		return true;
+	}
+
+	void Execute(CommandList* commandList)
+	{
+		if (!isCompiled_)
+		{
+			LogError("Compile is not called.");
+			return;
+		}
+
+		for (const auto& pass : passes_)
+		{
+			if (pass.IsCulled)
+				continue;
+
+			if (pass.Barriers.size() > 0)
+			{
+				commandList->TransitionTextures(pass.Barriers.data(), static_cast<int32_t>(pass.Barriers.size()));
+			}
+
+			if (pass.RenderPassTarget != nullptr)
+			{
+				commandList->BeginRenderPass(pass.RenderPassTarget);
+			}
+
+			if (pass.Execute != nullptr)
+			{
+				pass.Execute(*this, commandList);
+			}
+
+			if (pass.RenderPassTarget != nullptr)
+			{
+				commandList->EndRenderPass();
+			}
+		}
+	}
+
+	//! get a texture. a transient texture is available after Compile
+	Texture* GetTexture(RenderGraphTexture texture) const
+	{
+		if (!texture.IsValid() || texture.Index >= static_cast<int32_t>(textures_.size()))
+			return nullptr;
+		return textures_[texture.Index].Target;
+	}
+
+	/**
+		@brief	get a render pass which is begun before a pass
+		@note
+		It is available after Compile and is used to create RenderPassPipelineState.
+		nullptr is returned if the pass doesn't write colors or is culled.
+	*/
+	RenderPass* GetRenderPass(const char* name) const
+	{
+		for (const auto& pass : passes_)
+		{
+			if (pass.Name == name)
+				return pass.RenderPassTarget;
+		}
+		return nullptr;
+	}
+
+	bool GetIsCulled(const char* name) const
+	{
+		for (const auto& pass : passes_)
+		{
+			if (pass.Name == name)
+				return pass.IsCulled;
+		}
+		return false;
+	}
+
+	//! release textures and passes to build another graph
+	void Reset()
+	{
+		releaseResources();
+
+		for (auto& texture : textures_)
+		{
+			SafeRelease(texture.Target);
+		}
+
+		textures_.clear();
+		passes_.clear();
+	}
+};
+
+} // namespace LLGI
@@ -0,0 +1,229 @@
+
+#pragma once
+
+#include "../LLGI.Graphics.h"
+#include "../LLGI.Texture.h"
+#include <unordered_map>
+#include <vector>
+
+namespace LLGI
+{
+
+/**
+	@brief	a pool which recycles render textures and depth textures
+	@note
+	Release an acquired texture as usual when it is not needed.
+	Command lists keep references to textures until gpu finishes using them,
+	so a texture is reused only after it is released by the user and all command lists.
+	Textures which are not used for some frames are destroyed by NewFrame.
+*/
+class RenderTexturePool
+{
+private:
+	struct Key
+	{
+		Vec2I Size;
+		TextureFormatType Format = TextureFormatType::R8G8B8A8_UNORM;
+		bool IsDepth = false;
+		bool IsMultiSampling = false;
+		int32_t SamplingCount = 1;
+		bool IsTransient = false;
+
+		bool operator==(const Key& value) const
+		{
+			return Size.X == value.Size.X && Size.Y == value.Size.Y && Format == value.Format && IsDepth == value.IsDepth &&
+				   IsMultiSampling == value.IsMultiSampling && SamplingCount == value.SamplingCount && IsTransient == value.IsTransient;
+		}
+
+		struct Hash
+		{
+			typedef std::size_t result_type;
+
+			std::size_t operator()(const Key& key) const
+			{
+				auto ret = std::hash<int32_t>()(key.Size.X);
+				ret = ret * 31 + std::hash<int32_t>()(key.Size.Y);
+				ret = ret * 31 + std::hash<int32_t>()(static_cast<int32_t>(key.Format));
+				ret = ret * 31 + std::hash<bool>()(key.IsDepth);
+				ret = ret * 31 + std::hash<bool>()(key.IsMultiSampling);
+				ret = ret * 31 + std::hash<int32_t>()(key.SamplingCount);
+				ret = ret * 31 + std::hash<bool>()(key.IsTransient);
+				return ret;
+			}
+		};
+	};
+
+	struct Entry
+	{
+		Texture* Target = nullptr;
+		int32_t LastUsedFrame = 0;
+	};
+
+	Graphics* graphics_ = nullptr;
+	int32_t frame_ = 0;
+	int32_t evictionFrames_ = 0;
+	std::unordered_map<Key, std::vector<Entry>, Key::Hash> entries_;
+
+	//! a texture which is referred only by the pool is not used
+	static bool IsUsed(Texture* texture) { return texture->GetRef() > 1; }
+
+	Texture* acquire(const Key& key)
+	{
+		auto& entries = entries_[key];
+
+		for (auto& entry : entries)
+		{
+			if (!IsUsed(entry.Target))
+			{
+				entry.LastUsedFrame = frame_;
+				SafeAddRef(entry.Target);
+				return entry.Target;
+			}
+		}
+
+		Texture* texture = nullptr;
+		if (key.IsDepth)
+		{
+			DepthTextureInitializationParameter parameter;
+			parameter.Size = key.Size;
+			parameter.IsMultiSampling = key.IsMultiSampling;
+			parameter.SamplingCount = key.SamplingCount;
+			parameter.IsTransient = key.IsTransient;
+			texture = graphics_->CreateDepthTexture(parameter);
+		}
+		else
+		{
+			RenderTextureInitializationParameter parameter;
+			parameter.Size = key.Size;
+			parameter.Format = key.Format;
+			parameter.IsMultiSampling = key.IsMultiSampling;
+			parameter.SamplingCount = key.SamplingCount;
+			parameter.IsTransient = key.IsTransient;
+			texture = graphics_->CreateRenderTexture(parameter);
+		}
+
+		if (texture == nullptr)
+			return nullptr;
+
+		Entry entry;
+		entry.Target = texture;
+		entry.LastUsedFrame = frame_;
+		entries.push_back(entry);
+
+		SafeAddRef(texture);
+		return texture;
+	}
+
+public:
+	/**
+		@param	graphics	graphics
+		@param	evictionFrames	the number of frames after which an unused texture is destroyed
+	*/
+	RenderTexturePool(Graphics* graphics, int32_t evictionFrames = 60) : evictionFrames_(evictionFrames)
+	{
+		SafeAssign(graphics_, graphics);
+	}
+
+	RenderTexturePool(const RenderTexturePool&) = delete;
+	RenderTexturePool& operator=(const RenderTexturePool&) = delete;
+
+	~RenderTexturePool()
+	{
+		for (auto& entries : entries_)
+		{
+			for (auto& entry : entries.second)
+			{
+				SafeRelease(entry.Target);
+			}
+		}
+		entries_.clear();
+
+		SafeRelease(graphics_);
+	}
+
+	/**
+		@brief	get an unused render texture which has the same parameter or create it
+		@note
+		Contents of a reused texture are undefined.
+	*/
+	Texture* AcquireRenderTexture(const RenderTextureInitializationParameter& parameter)
+	{
+		Key key;
+		key.Size = parameter.Size;
+		key.Format = parameter.Format;
+		key.IsMultiSampling = parameter.IsMultiSampling;
+		key.SamplingCount = parameter.IsMultiSampling ? parameter.SamplingCount : 1;
+		key.IsTransient = parameter.IsTransient;
+		return acquire(key);
+	}
+
+	/**
+		@brief	get an unused depth texture which has the same parameter or create it
+		@note
+		Contents of a reused texture are undefined.
+	*/
+	Texture* AcquireDepthTexture(const DepthTextureInitializationParameter& parameter)
+	{
+		Key key;
+		key.Size = parameter.Size;
+		key.Format = TextureFormatType::Uknown;
+		key.IsDepth = true;
+		key.IsMultiSampling = parameter.IsMultiSampling;
+		key.SamplingCount = parameter.IsMultiSampling ? parameter.SamplingCount : 1;
+		key.IsTransient = parameter.IsTransient;
+		return acquire(key);
+	}
+
+	/**
+		@brief	start a new frame and destroy textures which are not used for evictionFrames
+	*/
+	void NewFrame()
+	{
+		frame_++;
+
+		for (auto it = entries_.begin(); it != entries_.end();)
+		{
+			auto& entries = it->second;
+
+			for (size_t i = 0; i < entries.size();)
+			{
+				auto& entry = entries[i];
+				if (IsUsed(entry.Target))
+				{
+					entry.LastUsedFrame = frame_;
+				}
+				else if (frame_ - entry.LastUsedFrame > evictionFrames_)
+				{
+					SafeRelease(entry.Target);
+					entries[i] = entries.back();
+					entries.pop_back();
+					continue;
+				}
+
+				i++;
+			}
+
+			if (entries.size() == 0)
+			{
+				it = entries_.erase(it);
+			}
+			else
+			{
+				it++;
+			}
+		}
+	}
+
+	//! get the number of textures which the pool has, including used textures
+	int32_t GetTextureCount() const
+	{
+		int32_t count = 0;
+		for (const auto& entries : entries_)
+		{
+			count += static_cast<int32_t>(entries.second.size());
+		}
+		return count;
+	}
+};
+
+} // namespace LLGI
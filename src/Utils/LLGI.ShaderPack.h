@@ -0,0 +1,119 @@
+
+#pragma once
+
+#include "LLGI.Hash.h"
+#include <algorithm>
+#include <fstream>
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace LLGI
+{
+
+/**
+	@brief	a file which contains compiled shaders
+	@note
+	A file consists of ShaderPackHeader, ShaderPackEntry sorted by NameHash and binaries aligned to ShaderPackAlignment.
+	It is designed to be mapped into memory and used without copying or hashing binaries again.
+*/
+static const char ShaderPackMagic[4] = {'L', 'S', 'P', 'K'};
+static const uint32_t ShaderPackVersion = 2;
+static const uint64_t ShaderPackAlignment = 16;
+
+struct ShaderPackHeader
+{
+	char Magic[4];
+	uint32_t Version;
+	uint32_t EntryCount;
+	uint32_t Reserved;
+};
+
+struct ShaderPackEntry
+{
+	//! a FNV-1a hash of a name
+	uint64_t NameHash;
+
+	//! a FNV-1a hash of a binary, which is same as ShaderVulkan::GetHash
+	uint64_t BinaryHash;
+
+	//! a MurmurHash64A of a binary, which is same as ShaderVulkan::GetContentHash
+	uint64_t ContentHash;
+
+	//! an offset from the beginning of the file
+	uint64_t Offset;
+
+	uint64_t Size;
+};
+
+inline uint64_t GetShaderPackNameHash(const char* name) { return CalculateFNV1a64(name, strlen(name)); }
+
+/**
+	@brief	write shaders into a pack
+	@return	false if it failed to write or names are duplicated
+*/
+inline bool WriteShaderPack(const char* path, const std::vector<std::string>& names, const std::vector<std::vector<uint8_t>>& binaries)
+{
+	if (names.size() != binaries.size())
+		return false;
+
+	// entries with indexes of binaries
+	typedef std::pair<ShaderPackEntry, size_t> IndexedEntry;
+	std::vector<IndexedEntry> entries(names.size());
+
+	for (size_t i = 0; i < names.size(); i++)
+	{
+		auto& entry = entries[i].first;
+		entry.NameHash = GetShaderPackNameHash(names[i].c_str());
+		entry.BinaryHash = CalculateFNV1a64(binaries[i].data(), binaries[i].size());
+		entry.ContentHash = CalculateMurmur64(binaries[i].data(), binaries[i].size());
+		entry.Size = binaries[i].size();
+		entries[i].second = i;
+	}
+
+	std::sort(entries.begin(), entries.end(), [](const IndexedEntry& a, const IndexedEntry& b) {
+		return a.first.NameHash < b.first.NameHash;
+	});
+
+	for (size_t i = 1; i < entries.size(); i++)
+	{
+		if (entries[i - 1].first.NameHash == entries[i].first.NameHash)
+			return false;
+	}
+
+	auto align = [](uint64_t offset) -> uint64_t {
+		return (offset + ShaderPackAlignment - 1) / ShaderPackAlignment * ShaderPackAlignment;
+	};
+
+	auto offset = align(sizeof(ShaderPackHeader) + sizeof(ShaderPackEntry) * entries.size());
+	for (auto& entry : entries)
+	{
+		entry.first.Offset = offset;
+		offset = align(offset + entry.first.Size);
+	}
+
+	std::vector<uint8_t> buffer(offset, 0);
+
+	ShaderPackHeader header;
+	memcpy(header.Magic, ShaderPackMagic, sizeof(ShaderPackMagic));
+	header.Version = ShaderPackVersion;
+	header.EntryCount = static_cast<uint32_t>(entries.size());
+	header.Reserved = 0;
+	memcpy(buffer.data(), &header, sizeof(ShaderPackHeader));
+
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		const auto& entry = entries[i].first;
+		memcpy(buffer.data() + sizeof(ShaderPackHeader) + sizeof(ShaderPackEntry) * i, &entry, sizeof(ShaderPackEntry));
+		memcpy(buffer.data() + entry.Offset, binaries[entries[i].second].data(), entry.Size);
+	}
+
+	std::ofstream file(path, std::ios::binary);
+	if (!file)
+		return false;
+
+	file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+	return static_cast<bool>(file);
+}
+
+} // namespace LLGI
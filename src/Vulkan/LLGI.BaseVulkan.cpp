@@ -81,7 +81,7 @@ VkFormat VulkanHelper::TextureFormatToVkFormat(TextureFormatType format)
 
 TextureFormatType VulkanHelper::VkFormatToTextureFormat(VkFormat format)
 {
-	for (size_t i = 0; i < sizeof(s_formatConversionTable); i++)
+	for (size_t i = 0; i < sizeof(s_formatConversionTable) / sizeof(s_formatConversionTable[0]); i++)
 	{
 		if (s_formatConversionTable[i].vulkanFormat == format)
 			return s_formatConversionTable[i].format;
@@ -280,6 +280,40 @@ uint32_t GetMemoryTypeIndex(vk::PhysicalDevice& phDevice, uint32_t bits, const v
 	return 0xffffffff;
 }
 
+uint32_t GetTransientMemoryTypeIndex(vk::PhysicalDevice& phDevice, uint32_t bits)
+{
+	const auto lazyProperties = vk::MemoryPropertyFlagBits::eDeviceLocal | vk::MemoryPropertyFlagBits::eLazilyAllocated;
+
+	vk::PhysicalDeviceMemoryProperties deviceMemoryProperties = phDevice.getMemoryProperties();
+	for (uint32_t i = 0; i < deviceMemoryProperties.memoryTypeCount; i++)
+	{
+		if ((bits & (1u << i)) != 0 && (deviceMemoryProperties.memoryTypes[i].propertyFlags & lazyProperties) == lazyProperties)
+		{
+			return i;
+		}
+	}
+
+	return GetMemoryTypeIndex(phDevice, bits, vk::MemoryPropertyFlagBits::eDeviceLocal);
+}
+
+int32_t GetSupportedSamplingCount(vk::PhysicalDevice& phDevice, int32_t count)
+{
+	auto limits = phDevice.getProperties().limits;
+	auto supported = limits.framebufferColorSampleCounts & limits.framebufferDepthSampleCounts;
+
+	// flags of sample counts are same as the numbers
+	int32_t result = 1;
+	for (int32_t c = 2; c <= count && c <= 64; c *= 2)
+	{
+		if (supported & static_cast<vk::SampleCountFlagBits>(c))
+		{
+			result = c;
+		}
+	}
+
+	return result;
+}
+
 bool CreateDepthBuffer(vk::Image& image,
 					   vk::ImageView view,
 					   vk::DeviceMemory devMem,
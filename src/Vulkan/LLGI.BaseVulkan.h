@@ -86,6 +86,31 @@ private:
 	VkDeviceSize size_;
 };
 
+/**
+	@brief	memory which is shared by resources
+	@note
+	Resources keep a reference to it and it is freed when all resources are released.
+*/
+class DeviceMemoryVulkan : public ReferenceObject
+{
+private:
+	vk::Device device_;
+	vk::DeviceMemory memory_;
+
+public:
+	DeviceMemoryVulkan(vk::Device device, vk::DeviceMemory memory) : device_(device), memory_(memory) {}
+
+	virtual ~DeviceMemoryVulkan()
+	{
+		if (memory_)
+		{
+			device_.freeMemory(memory_);
+		}
+	}
+
+	vk::DeviceMemory GetMemory() const { return memory_; }
+};
+
 void SetImageLayout(vk::CommandBuffer cmdbuffer,
 					vk::Image image,
 					vk::ImageLayout oldImageLayout,
@@ -94,6 +119,18 @@ void SetImageLayout(vk::CommandBuffer cmdbuffer,
 
 uint32_t GetMemoryTypeIndex(vk::PhysicalDevice& phDevice, uint32_t bits, const vk::MemoryPropertyFlags& properties);
 
+/**
+	@brief	get a type of memory for a transient attachment
+	@note
+	Lazily allocated memory is preferred. It is not backed by physical memory on a tile based gpu if contents are not stored.
+*/
+uint32_t GetTransientMemoryTypeIndex(vk::PhysicalDevice& phDevice, uint32_t bits);
+
+/**
+	@brief	get the largest number of samples which is less than or equal to count and is supported by color and depth attachments
+*/
+int32_t GetSupportedSamplingCount(vk::PhysicalDevice& phDevice, int32_t count);
+
 bool CreateDepthBuffer(vk::Image& image,
 					   vk::ImageView view,
 					   vk::DeviceMemory devMem,
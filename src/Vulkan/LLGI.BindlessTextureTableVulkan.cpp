@@ -0,0 +1,175 @@
+#include "LLGI.BindlessTextureTableVulkan.h"
+
+namespace LLGI
+{
+
+BindlessTextureTableVulkan::~BindlessTextureTableVulkan()
+{
+	if (!device_)
+		return;
+
+	if (descriptorPool_)
+	{
+		device_.destroyDescriptorPool(descriptorPool_);
+	}
+
+	if (descriptorSetLayout_)
+	{
+		device_.destroyDescriptorSetLayout(descriptorSetLayout_);
+	}
+
+	for (auto& sampler : samplers_)
+	{
+		if (sampler)
+		{
+			device_.destroySampler(sampler);
+		}
+	}
+}
+
+bool BindlessTextureTableVulkan::Initialize(vk::Device device, int32_t maxCount)
+{
+#if defined(VK_EXT_descriptor_indexing)
+	device_ = device;
+	maxCount_ = maxCount;
+
+	// samplers
+	for (int32_t w = 0; w < 2; w++)
+	{
+		for (int32_t f = 0; f < 2; f++)
+		{
+			auto wrapMode = static_cast<TextureWrapMode>(w);
+			auto minMagFilter = static_cast<TextureMinMagFilter>(f);
+
+			auto filter = minMagFilter == TextureMinMagFilter::Linear ? vk::Filter::eLinear : vk::Filter::eNearest;
+			auto address = wrapMode == TextureWrapMode::Repeat ? vk::SamplerAddressMode::eRepeat : vk::SamplerAddressMode::eClampToEdge;
+
+			vk::SamplerCreateInfo samplerInfo;
+			samplerInfo.magFilter = filter;
+			samplerInfo.minFilter = filter;
+			samplerInfo.anisotropyEnable = false;
+			samplerInfo.maxAnisotropy = 1;
+			samplerInfo.addressModeU = address;
+			samplerInfo.addressModeV = address;
+			samplerInfo.addressModeW = address;
+			samplerInfo.borderColor = vk::BorderColor::eIntOpaqueBlack;
+			samplerInfo.unnormalizedCoordinates = false;
+			samplerInfo.compareEnable = false;
+			samplerInfo.compareOp = vk::CompareOp::eAlways;
+			samplerInfo.mipmapMode =
+				minMagFilter == TextureMinMagFilter::Linear ? vk::SamplerMipmapMode::eLinear : vk::SamplerMipmapMode::eNearest;
+			samplerInfo.mipLodBias = 0.0f;
+			samplerInfo.minLod = 0.0f;
+			samplerInfo.maxLod = 0.0f;
+
+			samplers_[GetSamplerIndex(wrapMode, minMagFilter)] = device_.createSampler(samplerInfo);
+		}
+	}
+
+	// layout
+	std::array<vk::DescriptorSetLayoutBinding, 2> bindings;
+	bindings[0].binding = 0;
+	bindings[0].descriptorType = vk::DescriptorType::eSampledImage;
+	bindings[0].descriptorCount = maxCount_;
+	bindings[0].stageFlags = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
+
+	bindings[1].binding = 1;
+	bindings[1].descriptorType = vk::DescriptorType::eSampler;
+	bindings[1].descriptorCount = static_cast<uint32_t>(samplers_.size());
+	bindings[1].stageFlags = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
+	bindings[1].pImmutableSamplers = samplers_.data();
+
+	// textures are updated while command buffers which use the table are executed
+	std::array<vk::DescriptorBindingFlagsEXT, 2> bindingFlags;
+	bindingFlags[0] = vk::DescriptorBindingFlagBitsEXT::ePartiallyBound | vk::DescriptorBindingFlagBitsEXT::eUpdateAfterBind;
+	bindingFlags[1] = vk::DescriptorBindingFlagsEXT();
+
+	vk::DescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsInfo;
+	bindingFlagsInfo.bindingCount = static_cast<uint32_t>(bindingFlags.size());
+	bindingFlagsInfo.pBindingFlags = bindingFlags.data();
+
+	vk::DescriptorSetLayoutCreateInfo layoutInfo;
+	layoutInfo.pNext = &bindingFlagsInfo;
+	layoutInfo.flags = vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPoolEXT;
+	layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+	layoutInfo.pBindings = bindings.data();
+	descriptorSetLayout_ = device_.createDescriptorSetLayout(layoutInfo);
+
+	// pool
+	std::array<vk::DescriptorPoolSize, 2> poolSizes;
+	poolSizes[0].type = vk::DescriptorType::eSampledImage;
+	poolSizes[0].descriptorCount = maxCount_;
+	poolSizes[1].type = vk::DescriptorType::eSampler;
+	poolSizes[1].descriptorCount = static_cast<uint32_t>(samplers_.size());
+
+	vk::DescriptorPoolCreateInfo poolInfo;
+	poolInfo.flags = vk::DescriptorPoolCreateFlagBits::eUpdateAfterBindEXT;
+	poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+	poolInfo.pPoolSizes = poolSizes.data();
+	poolInfo.maxSets = 1;
+	descriptorPool_ = device_.createDescriptorPool(poolInfo);
+
+	vk::DescriptorSetAllocateInfo allocateInfo;
+	allocateInfo.descriptorPool = descriptorPool_;
+	allocateInfo.descriptorSetCount = 1;
+	allocateInfo.pSetLayouts = &descriptorSetLayout_;
+	descriptorSet_ = device_.allocateDescriptorSets(allocateInfo)[0];
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+int32_t BindlessTextureTableVulkan::Register(vk::ImageView view)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	int32_t index = -1;
+	if (freeIndexes_.size() > 0)
+	{
+		index = freeIndexes_.back();
+		freeIndexes_.pop_back();
+	}
+	else if (nextIndex_ < maxCount_)
+	{
+		index = nextIndex_;
+		nextIndex_++;
+	}
+	else
+	{
+		Log(LogType::Warning, "The bindless texture table is full.");
+		return -1;
+	}
+
+	vk::DescriptorImageInfo imageInfo;
+	imageInfo.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+	imageInfo.imageView = view;
+
+	vk::WriteDescriptorSet desc;
+	desc.dstSet = descriptorSet_;
+	desc.dstBinding = 0;
+	desc.dstArrayElement = index;
+	desc.descriptorCount = 1;
+	desc.descriptorType = vk::DescriptorType::eSampledImage;
+	desc.pImageInfo = &imageInfo;
+	device_.updateDescriptorSets(1, &desc, 0, nullptr);
+
+	return index;
+}
+
+void BindlessTextureTableVulkan::Unregister(int32_t index)
+{
+	if (index < 0)
+		return;
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	freeIndexes_.push_back(index);
+}
+
+int32_t BindlessTextureTableVulkan::GetSamplerIndex(TextureWrapMode wrapMode, TextureMinMagFilter minMagFilter)
+{
+	return static_cast<int32_t>(wrapMode) * 2 + static_cast<int32_t>(minMagFilter);
+}
+
+} // namespace LLGI
@@ -0,0 +1,59 @@
+
+#pragma once
+
+#include "LLGI.BaseVulkan.h"
+#include <mutex>
+
+namespace LLGI
+{
+
+/**
+	@brief	a global table of textures which is accessed with an index in shaders
+	@note
+	The table is bound as the set 2.
+	binding 0 : texture2D textures[] (an index is TextureVulkan::GetBindlessIndex)
+	binding 1 : sampler samplers[4] (an index is GetSamplerIndex)
+*/
+class BindlessTextureTableVulkan
+{
+private:
+	vk::Device device_;
+	vk::DescriptorPool descriptorPool_;
+	vk::DescriptorSetLayout descriptorSetLayout_;
+	vk::DescriptorSet descriptorSet_;
+	std::array<vk::Sampler, 4> samplers_;
+
+	int32_t maxCount_ = 0;
+	int32_t nextIndex_ = 0;
+	std::vector<int32_t> freeIndexes_;
+	std::mutex mutex_;
+
+public:
+	BindlessTextureTableVulkan() = default;
+	~BindlessTextureTableVulkan();
+
+	bool Initialize(vk::Device device, int32_t maxCount);
+
+	/**
+		@brief	register a view and get a stable index
+		@return	an index or -1 if the table is full
+	*/
+	int32_t Register(vk::ImageView view);
+
+	/**
+		@brief	release an index
+		@note
+		It must be called after gpu finished using the index.
+	*/
+	void Unregister(int32_t index);
+
+	vk::DescriptorSetLayout GetDescriptorSetLayout() const { return descriptorSetLayout_; }
+
+	vk::DescriptorSet GetDescriptorSet() const { return descriptorSet_; }
+
+	int32_t GetMaxCount() const { return maxCount_; }
+
+	static int32_t GetSamplerIndex(TextureWrapMode wrapMode, TextureMinMagFilter minMagFilter);
+};
+
+} // namespace LLGI
@@ -6,6 +6,7 @@
 #include "LLGI.ConstantBufferVulkan.h"
 #include "LLGI.GraphicsVulkan.h"
 #include "LLGI.IndexBufferVulkan.h"
+#include "LLGI.IndirectBufferVulkan.h"
 #include "LLGI.PipelineStateVulkan.h"
 #include "LLGI.TextureVulkan.h"
 #include "LLGI.VertexBufferVulkan.h"
@@ -16,16 +17,19 @@ namespace LLGI
 DescriptorPoolVulkan::DescriptorPoolVulkan(std::shared_ptr<GraphicsVulkan> graphics, int32_t size, int stage)
 	: graphics_(graphics), size_(size), stage_(stage)
 {
+	// sets cached in previous frames occupy up to a half of the pool, so the other half is enough for sets of a frame
 	std::array<vk::DescriptorPoolSize, 3> poolSizes;
 	poolSizes[0].type = vk::DescriptorType::eUniformBufferDynamic;
-	poolSizes[0].descriptorCount = size * stage;
+	poolSizes[0].descriptorCount = size * stage * 2;
 	poolSizes[1].type = vk::DescriptorType::eCombinedImageSampler;
-	poolSizes[1].descriptorCount = size * stage;
+	poolSizes[1].descriptorCount = size * stage * 2;
+	poolSizes[2].type = vk::DescriptorType::eInputAttachment;
+	poolSizes[2].descriptorCount = size * 2;
 
 	vk::DescriptorPoolCreateInfo poolInfo;
-	poolInfo.poolSizeCount = 2;
+	poolInfo.poolSizeCount = 3;
 	poolInfo.pPoolSizes = poolSizes.data();
-	poolInfo.maxSets = size * stage;
+	poolInfo.maxSets = size * stage * 2;
 
 	descriptorPool_ = graphics_->GetDevice().createDescriptorPool(poolInfo);
 }
@@ -41,30 +45,54 @@ DescriptorPoolVulkan ::~DescriptorPoolVulkan()
 
 const std::vector<vk::DescriptorSet>& DescriptorPoolVulkan::Get(PipelineStateVulkan* pip)
 {
-	if (cache.size() > static_cast<size_t>(offset))
+	const auto& layouts = pip->GetDescriptorSetLayout();
+	auto key = std::make_pair(static_cast<VkDescriptorSetLayout>(layouts[0]),
+							  pip->GetIsPushDescriptorEnabled() ? VK_NULL_HANDLE : static_cast<VkDescriptorSetLayout>(layouts[1]));
+
+	auto& cache = caches_[key];
+
+	if (cache.Sets.size() > static_cast<size_t>(cache.Offset))
 	{
-		offset++;
-		return cache[offset - 1];
+		cache.Offset++;
+		return cache.Sets[cache.Offset - 1];
 	}
 
-	// TODO : improve it
 	vk::DescriptorSetAllocateInfo allocateInfo;
 	allocateInfo.descriptorPool = descriptorPool_;
-	allocateInfo.descriptorSetCount = 2;
-	allocateInfo.pSetLayouts = (pip->GetDescriptorSetLayout().data());
+	allocateInfo.descriptorSetCount = pip->GetIsPushDescriptorEnabled() ? 1 : 2;
+	allocateInfo.pSetLayouts = layouts.data();
 
 	std::vector<vk::DescriptorSet> descriptorSets = graphics_->GetDevice().allocateDescriptorSets(allocateInfo);
-	cache.push_back(descriptorSets);
-	offset++;
-	return cache[offset - 1];
+	allocatedSetCount_ += static_cast<int32_t>(allocateInfo.descriptorSetCount);
+	cache.Sets.push_back(descriptorSets);
+	cache.Offset++;
+	return cache.Sets[cache.Offset - 1];
 }
 
-void DescriptorPoolVulkan::Reset() { offset = 0; }
+void DescriptorPoolVulkan::Reset()
+{
+	bool hasUnused = false;
+	for (auto& cache : caches_)
+	{
+		hasUnused |= cache.second.Offset == 0;
+		cache.second.Offset = 0;
+	}
+
+	// sets of a frame may have different layouts from cached sets, so cached sets must leave a half of the pool
+	if (hasUnused || allocatedSetCount_ > size_ * stage_)
+	{
+		graphics_->GetDevice().resetDescriptorPool(descriptorPool_);
+		caches_.clear();
+		allocatedSetCount_ = 0;
+	}
+}
 
 CommandListVulkan::CommandListVulkan() {}
 
 CommandListVulkan::~CommandListVulkan()
 {
+	readbackRing_.Dispose();
+
 	commandBuffers.clear();
 
 	descriptorPools.clear();
@@ -112,8 +140,12 @@ void CommandListVulkan::BeginExternal(VkCommandBuffer nativeCommandBuffer)
 
 	commandBuffers[currentSwapBufferIndex_] = vk::CommandBuffer(nativeCommandBuffer);
 
+	// copies which were recorded when the swap buffer was used last time have finished
+	readbackRing_.Complete(currentSwapBufferIndex_);
+
 	auto& dp = descriptorPools[currentSwapBufferIndex_];
 	dp->Reset();
+	vertexDescriptorSet_ = vk::DescriptorSet();
 
 	CommandList::Begin();
 }
@@ -127,6 +159,9 @@ void CommandListVulkan::Begin()
 
 	graphics_->GetDevice().resetFences(1, &(fences_[currentSwapBufferIndex_]));
 
+	// copies which were recorded when the swap buffer was used last time have finished
+	readbackRing_.Complete(currentSwapBufferIndex_);
+
 	auto& cmdBuffer = commandBuffers[currentSwapBufferIndex_];
 
 	cmdBuffer.reset(vk::CommandBufferResetFlagBits::eReleaseResources);
@@ -135,6 +170,7 @@ void CommandListVulkan::Begin()
 
 	auto& dp = descriptorPools[currentSwapBufferIndex_];
 	dp->Reset();
+	vertexDescriptorSet_ = vk::DescriptorSet();
 
 	CommandList::Begin();
 }
@@ -153,22 +189,281 @@ void CommandListVulkan::SetScissor(int32_t x, int32_t y, int32_t width, int32_t
 	cmdBuffer.setScissor(0, scissor);
 }
 
-void CommandListVulkan::Draw(int32_t pritimiveCount)
+bool CommandListVulkan::GatherDescriptorWrites(ShaderStageType stage,
+											   int32_t bindingMask,
+											   int32_t inputAttachmentMask,
+											   vk::DescriptorSet dstSet,
+											   vk::DescriptorType constantBufferType,
+											   bool isOffsetDynamic,
+											   DescriptorWritesVulkan& writes)
+{
+	bool hasBinding = false;
+	auto stage_ind = static_cast<int>(stage);
+
+	ConstantBuffer* cb = nullptr;
+	GetCurrentConstantBuffer(stage, cb);
+	if (cb != nullptr && (bindingMask & 1) != 0)
+	{
+		auto cb_ = static_cast<ConstantBufferVulkan*>(cb);
+
+		auto& bufferInfo = writes.bufferInfos[writes.bufferInfoCount];
+		bufferInfo.buffer = cb_->GetBuffer();
+		bufferInfo.offset = isOffsetDynamic ? 0 : cb_->GetOffset();
+		bufferInfo.range = cb_->GetSize();
+
+		vk::WriteDescriptorSet desc;
+		desc.descriptorType = constantBufferType;
+		desc.dstSet = dstSet;
+		desc.dstBinding = 0;
+		desc.dstArrayElement = 0;
+		desc.pBufferInfo = &bufferInfo;
+		desc.descriptorCount = 1;
+
+		writes.writes[writes.writeCount] = desc;
+
+		writes.bufferInfoCount++;
+		writes.writeCount++;
+		hasBinding = true;
+	}
+
+	// Assign textures
+	for (int unit_ind = 0; unit_ind < currentTextures[stage_ind].size(); unit_ind++)
+	{
+		if (currentTextures[stage_ind][unit_ind].texture == nullptr || (bindingMask & (1 << (unit_ind + 1))) == 0)
+			continue;
+
+		auto texture = (TextureVulkan*)currentTextures[stage_ind][unit_ind].texture;
+		bool isInputAttachment = (inputAttachmentMask & (1 << (unit_ind + 1))) != 0;
+
+		auto& imageInfo = writes.imageInfos[writes.imageInfoCount];
+		if (isInputAttachment)
+		{
+			imageInfo.imageLayout = texture->GetInputAttachmentLayout();
+			imageInfo.imageView = texture->GetInputAttachmentView();
+			imageInfo.sampler = nullptr;
+		}
+		else
+		{
+			imageInfo.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+			imageInfo.imageView = texture->GetView();
+			imageInfo.sampler = graphics_->GetDefaultSampler();
+		}
+
+		vk::WriteDescriptorSet desc;
+		desc.dstSet = dstSet;
+		desc.dstBinding = unit_ind + 1;
+		desc.dstArrayElement = 0;
+		desc.pImageInfo = &imageInfo;
+		desc.descriptorCount = 1;
+		desc.descriptorType = isInputAttachment ? vk::DescriptorType::eInputAttachment : vk::DescriptorType::eCombinedImageSampler;
+
+		writes.writes[writes.writeCount] = desc;
+
+		writes.imageInfoCount++;
+		writes.writeCount++;
+		hasBinding = true;
+	}
+
+	return hasBinding;
+}
+
+bool CommandListVulkan::UpdateDescriptorSet(PipelineStateVulkan* pip, ShaderStageType stage, vk::DescriptorSet dstSet, bool isOffsetDynamic)
+{
+	auto stage_ind = static_cast<int>(stage);
+
+	// bindings which the set doesn't contain are not written
+	auto setBindingMask = pip->GetBindingMask(stage);
+	auto inputAttachmentMask = pip->GetInputAttachmentMask(stage);
+
+	if (graphics_->GetDeviceExtensions().IsDescriptorUpdateTemplateSupported)
+	{
+		PipelineStateVulkan::DescriptorBindings bindings = {};
+		int32_t bindingMask = 0;
+
+		ConstantBuffer* cb = nullptr;
+		GetCurrentConstantBuffer(stage, cb);
+		if (cb != nullptr)
+		{
+			auto cb_ = static_cast<ConstantBufferVulkan*>(cb);
+			bindings.ConstantBuffer.buffer = static_cast<VkBuffer>(cb_->GetBuffer());
+			bindings.ConstantBuffer.offset = isOffsetDynamic ? 0 : cb_->GetOffset();
+			bindings.ConstantBuffer.range = cb_->GetSize();
+			bindingMask |= 1;
+		}
+
+		for (int unit_ind = 0; unit_ind < PipelineStateVulkan::TextureBindingCount; unit_ind++)
+		{
+			if (currentTextures[stage_ind][unit_ind].texture == nullptr)
+				continue;
+
+			auto texture = static_cast<TextureVulkan*>(currentTextures[stage_ind][unit_ind].texture);
+			if ((inputAttachmentMask & (1 << (unit_ind + 1))) != 0)
+			{
+				bindings.Textures[unit_ind].imageLayout = static_cast<VkImageLayout>(texture->GetInputAttachmentLayout());
+				bindings.Textures[unit_ind].imageView = static_cast<VkImageView>(texture->GetInputAttachmentView());
+				bindings.Textures[unit_ind].sampler = VK_NULL_HANDLE;
+			}
+			else
+			{
+				bindings.Textures[unit_ind].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+				bindings.Textures[unit_ind].imageView = static_cast<VkImageView>(texture->GetView());
+				bindings.Textures[unit_ind].sampler = static_cast<VkSampler>(graphics_->GetDefaultSampler());
+			}
+			bindingMask |= 1 << (unit_ind + 1);
+		}
+
+		bindingMask &= setBindingMask;
+		if (bindingMask == 0)
+			return false;
+
+		if (pip->UpdateDescriptorSet(dstSet, stage, bindingMask, bindings))
+			return true;
+	}
+
+	DescriptorWritesVulkan writes;
+	if (!GatherDescriptorWrites(
+			stage, setBindingMask, inputAttachmentMask, dstSet, vk::DescriptorType::eUniformBufferDynamic, isOffsetDynamic, writes))
+		return false;
+
+	graphics_->GetDevice().updateDescriptorSets(writes.writeCount, writes.writes.data(), 0, nullptr);
+	return true;
+}
+
+void CommandListVulkan::BindDescriptorSetsWithPool(PipelineStateVulkan* pip)
+{
+	auto& cmdBuffer = commandBuffers[currentSwapBufferIndex_];
+	auto& dp = descriptorPools[currentSwapBufferIndex_];
+
+	const auto& descriptorSets = dp->Get(pip);
+
+	bool hasBinding = false;
+
+	for (int stage_ind = 0; stage_ind < static_cast<int>(ShaderStageType::Max); stage_ind++)
+	{
+		hasBinding |= UpdateDescriptorSet(pip, static_cast<ShaderStageType>(stage_ind), descriptorSets[stage_ind], false);
+	}
+
+	if (!hasBinding)
+		return;
+
+	// an offset is required for each set which contains a constant buffer
+	std::array<uint32_t, static_cast<int>(ShaderStageType::Max)> offsets;
+	offsets.fill(0);
+	uint32_t offsetCount = 0;
+
+	for (int stage_ind = 0; stage_ind < static_cast<int>(ShaderStageType::Max); stage_ind++)
+	{
+		if ((pip->GetBindingMask(static_cast<ShaderStageType>(stage_ind)) & 1) != 0)
+		{
+			offsetCount++;
+		}
+	}
+
+	cmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics,
+								 pip->GetPipelineLayout(),
+								 0,
+								 static_cast<uint32_t>(descriptorSets.size()),
+								 descriptorSets.data(),
+								 offsetCount,
+								 offsets.data());
+}
+
+void CommandListVulkan::BindDescriptorSetsWithPush(PipelineStateVulkan* pip)
+{
+#if defined(VK_KHR_push_descriptor)
+	auto& cmdBuffer = commandBuffers[currentSwapBufferIndex_];
+
+	// a set of the vertex shader is reused while bindings except an offset of the constant buffer are not changed.
+	{
+		auto bindingMask = pip->GetBindingMask(ShaderStageType::Vertex);
+
+		ConstantBuffer* cb = nullptr;
+		GetCurrentConstantBuffer(ShaderStageType::Vertex, cb);
+		auto cb_ = (bindingMask & 1) != 0 ? static_cast<ConstantBufferVulkan*>(cb) : nullptr;
+
+		VertexDescriptorKey key;
+		key.layout = pip->GetDescriptorSetLayout()[0];
+		key.buffer = cb_ != nullptr ? cb_->GetBuffer() : vk::Buffer();
+		key.range = cb_ != nullptr ? cb_->GetSize() : 0;
+
+		bool hasBinding = cb_ != nullptr;
+		for (size_t unit_ind = 0; unit_ind < key.views.size(); unit_ind++)
+		{
+			auto texture = static_cast<TextureVulkan*>(currentTextures[static_cast<int>(ShaderStageType::Vertex)][unit_ind].texture);
+			if ((bindingMask & (1 << (unit_ind + 1))) == 0)
+			{
+				texture = nullptr;
+			}
+
+			key.views[unit_ind] = texture != nullptr ? texture->GetView() : vk::ImageView();
+			hasBinding |= texture != nullptr;
+		}
+
+		if (hasBinding)
+		{
+			if (!vertexDescriptorSet_ || !(vertexDescriptorKey_ == key))
+			{
+				auto& dp = descriptorPools[currentSwapBufferIndex_];
+				vertexDescriptorSet_ = dp->Get(pip)[0];
+				vertexDescriptorKey_ = key;
+
+				UpdateDescriptorSet(pip, ShaderStageType::Vertex, vertexDescriptorSet_, true);
+			}
+
+			uint32_t dynamicOffset = cb_ != nullptr ? cb_->GetOffset() : 0;
+			uint32_t dynamicOffsetCount = (bindingMask & 1) != 0 ? 1 : 0;
+			cmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics,
+										 pip->GetPipelineLayout(),
+										 0,
+										 1,
+										 &vertexDescriptorSet_,
+										 dynamicOffsetCount,
+										 &dynamicOffset);
+		}
+	}
+
+	// a set of the pixel shader is written into the command buffer directly
+	{
+		DescriptorWritesVulkan writes;
+		if (GatherDescriptorWrites(ShaderStageType::Pixel,
+								   pip->GetBindingMask(ShaderStageType::Pixel),
+								   pip->GetInputAttachmentMask(ShaderStageType::Pixel),
+								   vk::DescriptorSet(),
+								   vk::DescriptorType::eUniformBuffer,
+								   false,
+								   writes))
+		{
+			graphics_->GetDeviceExtensions().CmdPushDescriptorSet(static_cast<VkCommandBuffer>(cmdBuffer),
+																  VK_PIPELINE_BIND_POINT_GRAPHICS,
+																  static_cast<VkPipelineLayout>(pip->GetPipelineLayout()),
+																  1,
+																  writes.writeCount,
+																  reinterpret_cast<const VkWriteDescriptorSet*>(writes.writes.data()));
+		}
+	}
+#endif
+}
+
+PipelineStateVulkan* CommandListVulkan::BindDrawingStates(bool isIndexed)
 {
 	BindingVertexBuffer vb_;
 	BindingIndexBuffer ib_;
 	PipelineState* pip_ = nullptr;
 
+	DynamicPipelineState dynamicState;
+
 	bool isVBDirtied = false;
 	bool isIBDirtied = false;
 	bool isPipDirtied = false;
+	bool isDynamicStateDirtied = false;
 
 	GetCurrentVertexBuffer(vb_, isVBDirtied);
 	GetCurrentIndexBuffer(ib_, isIBDirtied);
 	GetCurrentPipelineState(pip_, isPipDirtied);
+	GetCurrentDynamicState(dynamicState, isDynamicStateDirtied);
 
 	assert(vb_.vertexBuffer != nullptr);
-	assert(ib_.indexBuffer != nullptr);
+	assert(!isIndexed || ib_.indexBuffer != nullptr);
 	assert(pip_ != nullptr);
 
 	auto vb = static_cast<VertexBufferVulkan*>(vb_.vertexBuffer);
@@ -186,7 +481,7 @@ void CommandListVulkan::Draw(int32_t pritimiveCount)
 	}
 
 	// assign an index vuffer
-	if (isIBDirtied)
+	if (isIBDirtied && ib != nullptr)
 	{
 		vk::DeviceSize indexOffset = ib_.offset;
 		vk::IndexType indexType = vk::IndexType::eUint16;
@@ -199,162 +494,259 @@ void CommandListVulkan::Draw(int32_t pritimiveCount)
 		cmdBuffer.bindIndexBuffer(ib->GetBuffer(), indexOffset, indexType);
 	}
 
-	auto& dp = descriptorPools[currentSwapBufferIndex_];
-
-	std::vector<vk::DescriptorSet> descriptorSets = dp->Get(pip);
-	/*
-	vk::DescriptorSetAllocateInfo allocateInfo;
-	allocateInfo.descriptorPool = descriptorPool;
-	allocateInfo.descriptorSetCount = 2;
-	allocateInfo.pSetLayouts = (pip->GetDescriptorSetLayout().data());
+	// assign descriptors
+	if (pip->GetIsPushDescriptorEnabled())
+	{
+		BindDescriptorSetsWithPush(pip);
+	}
+	else
+	{
+		BindDescriptorSetsWithPool(pip);
+	}
 
-	std::vector<vk::DescriptorSet> descriptorSets = graphics_->GetDevice().allocateDescriptorSets(allocateInfo);
-	*/
+	// sampling in the same layout doesn't need barriers, but later writes must wait for it
+	for (int stage_ind = 0; stage_ind < static_cast<int>(ShaderStageType::Max); stage_ind++)
+	{
+		auto stage = stage_ind == static_cast<int>(ShaderStageType::Vertex) ? vk::PipelineStageFlagBits::eVertexShader
+																		   : vk::PipelineStageFlagBits::eFragmentShader;
 
-	std::array<vk::WriteDescriptorSet, 16> writeDescriptorSets;
-	int writeDescriptorIndex = 0;
+		for (const auto& binding : currentTextures[stage_ind])
+		{
+			if (binding.texture == nullptr)
+				continue;
 
-	std::array<vk::DescriptorBufferInfo, 16> descriptorBufferInfos;
-	int descriptorBufferIndex = 0;
+			static_cast<TextureVulkan*>(binding.texture)->AddAccess(stage, vk::AccessFlagBits::eShaderRead);
+		}
+	}
 
-	std::array<vk::DescriptorImageInfo, 16> descriptorImageInfos;
-	int descriptorImageIndex = 0;
+	// assign a pipeline
+	if (isPipDirtied || isDynamicStateDirtied)
+	{
+		cmdBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pip->GetPipeline(dynamicState));
 
-	std::array<bool, static_cast<int>(ShaderStageType::Max)> stages;
-	stages.fill(false);
+#if defined(VK_EXT_extended_dynamic_state)
+		const auto& extensions = graphics_->GetDeviceExtensions();
+		if (extensions.IsExtendedDynamicStateSupported)
+		{
+			auto cmd = static_cast<VkCommandBuffer>(cmdBuffer);
+			extensions.CmdSetCullMode(cmd, static_cast<VkCullModeFlags>(PipelineStateVulkan::GetCullMode(dynamicState.Culling)));
+			extensions.CmdSetPrimitiveTopology(
+				cmd, static_cast<VkPrimitiveTopology>(PipelineStateVulkan::GetPrimitiveTopology(dynamicState.Topology)));
+			extensions.CmdSetDepthTestEnable(cmd, dynamicState.IsDepthTestEnabled ? VK_TRUE : VK_FALSE);
+			extensions.CmdSetDepthWriteEnable(cmd, dynamicState.IsDepthWriteEnabled ? VK_TRUE : VK_FALSE);
+			extensions.CmdSetDepthCompareOp(cmd, static_cast<VkCompareOp>(PipelineStateVulkan::GetCompareOp(dynamicState.DepthFunc)));
+			extensions.CmdSetStencilTestEnable(cmd, dynamicState.IsStencilTestEnabled ? VK_TRUE : VK_FALSE);
+		}
+#endif
+	}
 
-	ConstantBuffer* vcb = nullptr;
-	GetCurrentConstantBuffer(ShaderStageType::Vertex, vcb);
-	if (vcb != nullptr)
+	if (isPipDirtied)
 	{
-		stages[0] = true;
+		const auto& bindlessTextureTable = graphics_->GetBindlessTextureTable();
+		if (bindlessTextureTable != nullptr)
+		{
+			auto descriptorSet = bindlessTextureTable->GetDescriptorSet();
+			cmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pip->GetPipelineLayout(), 2, 1, &descriptorSet, 0, nullptr);
+		}
+	}
 
-		descriptorBufferInfos[descriptorBufferIndex].buffer = (static_cast<ConstantBufferVulkan*>(vcb)->GetBuffer());
-		descriptorBufferInfos[descriptorBufferIndex].offset = 0;
-		descriptorBufferInfos[descriptorBufferIndex].range = vcb->GetSize();
+	return pip;
+}
 
-		vk::WriteDescriptorSet desc;
-		desc.descriptorType = vk::DescriptorType::eUniformBufferDynamic;
-		desc.dstSet = descriptorSets[0];
-		desc.dstBinding = 0;
-		desc.dstArrayElement = 0;
-		desc.pBufferInfo = &(descriptorBufferInfos[descriptorBufferIndex]);
-		desc.descriptorCount = 1;
+void CommandListVulkan::Draw(int32_t pritimiveCount)
+{
+	BindDrawingStates(true);
+	auto& cmdBuffer = commandBuffers[currentSwapBufferIndex_];
 
-		writeDescriptorSets[writeDescriptorIndex] = desc;
+	DynamicPipelineState dynamicState;
+	bool isDynamicStateDirtied = false;
+	GetCurrentDynamicState(dynamicState, isDynamicStateDirtied);
 
-		descriptorBufferIndex++;
-		writeDescriptorIndex++;
-	}
+	// draw
+	cmdBuffer.drawIndexed(GetVertexCountFromPrimitiveCount(dynamicState.Topology, pritimiveCount), 1, 0, 0, 0);
 
-	ConstantBuffer* pcb = nullptr;
-	GetCurrentConstantBuffer(ShaderStageType::Pixel, pcb);
-	if (pcb != nullptr)
-	{
-		stages[1] = true;
+	CommandList::Draw(pritimiveCount);
+}
 
-		descriptorBufferInfos[descriptorBufferIndex].buffer = (static_cast<ConstantBufferVulkan*>(pcb)->GetBuffer());
-		descriptorBufferInfos[descriptorBufferIndex].offset = 0;
-		descriptorBufferInfos[descriptorBufferIndex].range = pcb->GetSize();
-		vk::WriteDescriptorSet desc;
-		desc.descriptorType = vk::DescriptorType::eUniformBufferDynamic;
-		desc.dstSet = descriptorSets[1];
-		desc.dstBinding = 0;
-		desc.dstArrayElement = 0;
-		desc.pBufferInfo = &(descriptorBufferInfos[descriptorBufferIndex]);
-		desc.descriptorCount = 1;
+void CommandListVulkan::DrawIndexed(int32_t indexCount, int32_t firstIndex, int32_t baseVertex)
+{
+	BindDrawingStates(true);
+	auto& cmdBuffer = commandBuffers[currentSwapBufferIndex_];
 
-		writeDescriptorSets[writeDescriptorIndex] = desc;
+	cmdBuffer.drawIndexed(indexCount, 1, firstIndex, baseVertex, 0);
 
-		descriptorBufferIndex++;
-		writeDescriptorIndex++;
-	}
+	CommandList::DrawIndexed(indexCount, firstIndex, baseVertex);
+}
 
-	// Assign textures
-	for (int stage_ind = 0; stage_ind < (int32_t)ShaderStageType::Max; stage_ind++)
-	{
-		for (int unit_ind = 0; unit_ind < currentTextures[stage_ind].size(); unit_ind++)
-		{
-			if (currentTextures[stage_ind][unit_ind].texture == nullptr)
-				continue;
+void CommandListVulkan::DrawNonIndexed(int32_t vertexCount, int32_t firstVertex)
+{
+	BindDrawingStates(false);
+	auto& cmdBuffer = commandBuffers[currentSwapBufferIndex_];
 
-			stages[stage_ind] = true;
+	cmdBuffer.draw(vertexCount, 1, firstVertex, 0);
 
-			auto texture = (TextureVulkan*)currentTextures[stage_ind][unit_ind].texture;
-			auto wm = (int32_t)currentTextures[stage_ind][unit_ind].wrapMode;
-			auto mm = (int32_t)currentTextures[stage_ind][unit_ind].minMagFilter;
+	CommandList::DrawNonIndexed(vertexCount, firstVertex);
+}
 
-			vk::DescriptorImageInfo imageInfo;
-			imageInfo.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-			imageInfo.imageView = texture->GetView();
-			imageInfo.sampler = graphics_->GetDefaultSampler();
-			descriptorImageInfos[descriptorImageIndex] = imageInfo;
+void CommandListVulkan::DrawIndirect(IndirectBuffer* argumentBuffer, int32_t offset, int32_t drawCount, int32_t stride)
+{
+	BindDrawingStates(false);
+	auto& cmdBuffer = commandBuffers[currentSwapBufferIndex_];
 
-			vk::WriteDescriptorSet desc;
-			desc.dstSet = descriptorSets[stage_ind];
-			desc.dstBinding = unit_ind + 1;
-			desc.dstArrayElement = 0;
-			desc.pImageInfo = &descriptorImageInfos[descriptorImageIndex];
-			desc.descriptorCount = 1;
-			desc.descriptorType = vk::DescriptorType::eCombinedImageSampler;
+	auto buffer = static_cast<IndirectBufferVulkan*>(argumentBuffer);
+	cmdBuffer.drawIndirect(buffer->GetBuffer(), offset, drawCount, stride);
 
-			writeDescriptorSets[writeDescriptorIndex] = desc;
+	RegisterReferencedObject(argumentBuffer);
+	ResetDirtiedStates();
+}
 
-			descriptorImageIndex++;
-			writeDescriptorIndex++;
-		}
+void CommandListVulkan::DrawIndexedIndirect(IndirectBuffer* argumentBuffer, int32_t offset, int32_t drawCount, int32_t stride)
+{
+	BindDrawingStates(true);
+	auto& cmdBuffer = commandBuffers[currentSwapBufferIndex_];
+
+	auto buffer = static_cast<IndirectBufferVulkan*>(argumentBuffer);
+	cmdBuffer.drawIndexedIndirect(buffer->GetBuffer(), offset, drawCount, stride);
+
+	RegisterReferencedObject(argumentBuffer);
+	ResetDirtiedStates();
+}
+
+void CommandListVulkan::DrawIndirectCount(
+	IndirectBuffer* argumentBuffer, int32_t offset, IndirectBuffer* countBuffer, int32_t countOffset, int32_t maxDrawCount, int32_t stride)
+{
+	const auto& extensions = graphics_->GetDeviceExtensions();
+	if (!extensions.IsDrawIndirectCountSupported)
+	{
+		Log(LogType::Error, "DrawIndirectCount is not supported in this device.");
+		return;
 	}
 
-	graphics_->GetDevice().updateDescriptorSets(writeDescriptorIndex, writeDescriptorSets.data(), 0, nullptr);
+#if defined(VK_KHR_draw_indirect_count)
+	BindDrawingStates(false);
+	auto& cmdBuffer = commandBuffers[currentSwapBufferIndex_];
 
-	std::array<vk::DescriptorSet, static_cast<int>(ShaderStageType::Max)> descriptorSets_;
-	std::array<uint32_t, static_cast<int>(ShaderStageType::Max)> offsets_;
-	int descriptorIndex = 0;
-	int firstSet = -1;
+	auto buffer = static_cast<IndirectBufferVulkan*>(argumentBuffer);
+	auto count = static_cast<IndirectBufferVulkan*>(countBuffer);
+	extensions.CmdDrawIndirectCount(static_cast<VkCommandBuffer>(cmdBuffer),
+									static_cast<VkBuffer>(buffer->GetBuffer()),
+									offset,
+									static_cast<VkBuffer>(count->GetBuffer()),
+									countOffset,
+									maxDrawCount,
+									stride);
+
+	RegisterReferencedObject(argumentBuffer);
+	RegisterReferencedObject(countBuffer);
+	ResetDirtiedStates();
+#endif
+}
 
-	for (int i = 0; i < static_cast<int>(ShaderStageType::Max); i++)
+void CommandListVulkan::DrawIndexedIndirectCount(
+	IndirectBuffer* argumentBuffer, int32_t offset, IndirectBuffer* countBuffer, int32_t countOffset, int32_t maxDrawCount, int32_t stride)
+{
+	const auto& extensions = graphics_->GetDeviceExtensions();
+	if (!extensions.IsDrawIndirectCountSupported)
 	{
-		if (!stages[i])
-			continue;
+		Log(LogType::Error, "DrawIndexedIndirectCount is not supported in this device.");
+		return;
+	}
+
+#if defined(VK_KHR_draw_indirect_count)
+	BindDrawingStates(true);
+	auto& cmdBuffer = commandBuffers[currentSwapBufferIndex_];
+
+	auto buffer = static_cast<IndirectBufferVulkan*>(argumentBuffer);
+	auto count = static_cast<IndirectBufferVulkan*>(countBuffer);
+	extensions.CmdDrawIndexedIndirectCount(static_cast<VkCommandBuffer>(cmdBuffer),
+										   static_cast<VkBuffer>(buffer->GetBuffer()),
+										   offset,
+										   static_cast<VkBuffer>(count->GetBuffer()),
+										   countOffset,
+										   maxDrawCount,
+										   stride);
+
+	RegisterReferencedObject(argumentBuffer);
+	RegisterReferencedObject(countBuffer);
+	ResetDirtiedStates();
+#endif
+}
+
+void CommandListVulkan::DrawIndexedMulti(const DrawIndexedRange* ranges, int32_t count)
+{
+	if (count <= 0)
+		return;
+
+	BindDrawingStates(true);
+	auto& cmdBuffer = commandBuffers[currentSwapBufferIndex_];
+
+	const auto& extensions = graphics_->GetDeviceExtensions();
 
-		descriptorSets_[descriptorIndex] = descriptorSets[i];
-		offsets_[descriptorIndex] = 0;
+#if defined(VK_EXT_multi_draw)
+	if (extensions.IsMultiDrawSupported)
+	{
+		static_assert(sizeof(DrawIndexedRange) == sizeof(VkMultiDrawIndexedInfoEXT),
+					  "DrawIndexedRange must be same as VkMultiDrawIndexedInfoEXT");
 
-		if (firstSet < 0)
+		// split ranges because the number of draws is limited
+		for (int32_t i = 0; i < count; i += extensions.MaxMultiDrawCount)
 		{
-			firstSet = descriptorIndex;
+			auto drawCount = std::min(count - i, static_cast<int32_t>(extensions.MaxMultiDrawCount));
+			extensions.CmdDrawMultiIndexed(static_cast<VkCommandBuffer>(cmdBuffer),
+										   drawCount,
+										   reinterpret_cast<const VkMultiDrawIndexedInfoEXT*>(ranges + i),
+										   1,
+										   0,
+										   sizeof(DrawIndexedRange),
+										   nullptr);
 		}
 
-		descriptorIndex++;
+		ResetDirtiedStates();
+		return;
 	}
+#endif
 
-	if (firstSet >= 0)
+	for (int32_t i = 0; i < count; i++)
 	{
-		cmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics,
-									 pip->GetPipelineLayout(),
-									 firstSet,
-									 descriptorIndex,
-									 descriptorSets_.data(),
-									 descriptorIndex,
-									 offsets_.data());
+		cmdBuffer.drawIndexed(ranges[i].IndexCount, 1, ranges[i].FirstIndex, ranges[i].VertexOffset, 0);
 	}
 
-	// assign a pipeline
-	if (isPipDirtied)
+	// the loop is recorded here because states are bound only once
+	ResetDirtiedStates();
+}
+
+void CommandListVulkan::SetPushConstants(ShaderStageType shaderStage, int32_t offset, int32_t size, const void* data)
+{
+	PipelineState* pip_ = nullptr;
+	bool isPipDirtied = false;
+	GetCurrentPipelineState(pip_, isPipDirtied);
+
+	if (pip_ == nullptr)
 	{
-		cmdBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pip->GetPipeline());
+		Log(LogType::Error, "Please call SetPushConstants after SetPipelineState");
+		return;
 	}
 
-	// draw
-	int indexPerPrim = 0;
-	if (pip->Topology == TopologyType::Triangle)
-		indexPerPrim = 3;
-	if (pip->Topology == TopologyType::Line)
-		indexPerPrim = 2;
+	auto pip = static_cast<PipelineStateVulkan*>(pip_);
 
-	cmdBuffer.drawIndexed(indexPerPrim * pritimiveCount, 1, 0, 0, 0);
+	if (offset < 0 || offset + size > pip->PushConstantSizes[static_cast<int>(shaderStage)])
+	{
+		Log(LogType::Error, "SetPushConstants : a range is out of PipelineState::PushConstantSizes");
+		return;
+	}
 
-	CommandList::Draw(pritimiveCount);
+	if (offset % 4 != 0 || size % 4 != 0)
+	{
+		Log(LogType::Error, "SetPushConstants : an offset and a size must be multiples of 4");
+		return;
+	}
+
+	auto& cmdBuffer = commandBuffers[currentSwapBufferIndex_];
+	cmdBuffer.pushConstants(pip->GetPipelineLayout(),
+							PipelineStateVulkan::GetShaderStageFlag(shaderStage),
+							pip->GetPushConstantOffset(shaderStage) + offset,
+							size,
+							data);
 }
 
 void CommandListVulkan::CopyTexture(Texture* src, Texture* dst)
@@ -384,20 +776,356 @@ void CommandListVulkan::CopyTexture(Texture* src, Texture* dst)
 	imageCopy[0].dstSubresource.layerCount = 1;
 	imageCopy[0].dstSubresource.baseArrayLayer = 0;
 
-	srcTex->ResourceBarrior(cmdBuffer, vk::ImageLayout::eTransferSrcOptimal);
-	dstTex->ResourceBarrior(cmdBuffer, vk::ImageLayout::eTransferDstOptimal);
-	cmdBuffer.copyImage(srcTex->GetImage(), srcTex->GetImageLayout(), dstTex->GetImage(), dstTex->GetImageLayout(), imageCopy);
-	dstTex->ResourceBarrior(cmdBuffer, vk::ImageLayout::eShaderReadOnlyOptimal);
-	srcTex->ResourceBarrior(cmdBuffer, vk::ImageLayout::eShaderReadOnlyOptimal);
+	const auto& extensions = graphics_->GetDeviceExtensions();
+
+	// the whole of dst is overwritten
+	barrierBatch_.Transition(srcTex, ImageStateVulkan::FromLayout(vk::ImageLayout::eTransferSrcOptimal));
+	barrierBatch_.Transition(dstTex, ImageStateVulkan::FromLayout(vk::ImageLayout::eTransferDstOptimal), true);
+	barrierBatch_.Flush(cmdBuffer, &extensions);
+
+	cmdBuffer.copyImage(
+		srcTex->GetImage(), vk::ImageLayout::eTransferSrcOptimal, dstTex->GetImage(), vk::ImageLayout::eTransferDstOptimal, imageCopy);
+
+	barrierBatch_.Transition(dstTex, ImageStateVulkan::FromLayout(vk::ImageLayout::eShaderReadOnlyOptimal));
+	barrierBatch_.Transition(srcTex, ImageStateVulkan::FromLayout(vk::ImageLayout::eShaderReadOnlyOptimal));
+	barrierBatch_.Flush(cmdBuffer, &extensions);
 
 	RegisterReferencedObject(src);
 	RegisterReferencedObject(dst);
 }
 
+static vk::ImageLayout GetImageLayoutForAccess(TextureAccessType access)
+{
+	switch (access)
+	{
+	case TextureAccessType::ShaderRead:
+		return vk::ImageLayout::eShaderReadOnlyOptimal;
+	case TextureAccessType::RenderTarget:
+		// render passes which don't clear colors require this layout
+		return vk::ImageLayout::eShaderReadOnlyOptimal;
+	case TextureAccessType::DepthStencil:
+		return vk::ImageLayout::eDepthStencilAttachmentOptimal;
+	case TextureAccessType::CopySource:
+		return vk::ImageLayout::eTransferSrcOptimal;
+	case TextureAccessType::CopyDestination:
+		return vk::ImageLayout::eTransferDstOptimal;
+	}
+
+	return vk::ImageLayout::eUndefined;
+}
+
+static void GetDstStageAndAccess(TextureAccessType access, vk::PipelineStageFlags& stage, vk::AccessFlags& accessMask)
+{
+	switch (access)
+	{
+	case TextureAccessType::ShaderRead:
+		stage = vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader;
+		accessMask = vk::AccessFlagBits::eShaderRead;
+		break;
+	case TextureAccessType::RenderTarget:
+		stage = vk::PipelineStageFlagBits::eColorAttachmentOutput;
+		accessMask = vk::AccessFlagBits::eColorAttachmentRead | vk::AccessFlagBits::eColorAttachmentWrite;
+		break;
+	case TextureAccessType::DepthStencil:
+		stage = vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests;
+		accessMask = vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eDepthStencilAttachmentWrite;
+		break;
+	case TextureAccessType::CopySource:
+		stage = vk::PipelineStageFlagBits::eTransfer;
+		accessMask = vk::AccessFlagBits::eTransferRead;
+		break;
+	case TextureAccessType::CopyDestination:
+		stage = vk::PipelineStageFlagBits::eTransfer;
+		accessMask = vk::AccessFlagBits::eTransferWrite;
+		break;
+	}
+}
+
+void CommandListVulkan::TransitionTextures(const TextureBarrier* barriers, int32_t count)
+{
+	if (isInRenderPass_)
+	{
+		Log(LogType::Error, "Please call TransitionTextures outside of RenderPass");
+		return;
+	}
+
+	auto& cmdBuffer = commandBuffers[currentSwapBufferIndex_];
+
+	for (int32_t i = 0; i < count; i++)
+	{
+		const auto& barrier = barriers[i];
+		auto texture = static_cast<TextureVulkan*>(barrier.Target);
+
+		// layouts of a screen are changed by render passes
+		if (texture == nullptr || texture->GetType() == TextureType::Screen)
+			continue;
+
+		ImageStateVulkan state;
+		state.Layout = GetImageLayoutForAccess(barrier.Access);
+		GetDstStageAndAccess(barrier.Access, state.Stages, state.Accesses);
+
+		// memory may be used by another texture before
+		barrierBatch_.Transition(texture, state, barrier.IsDiscarded, barrier.IsDiscarded);
+		RegisterReferencedObject(texture);
+	}
+
+	barrierBatch_.Flush(cmdBuffer, &graphics_->GetDeviceExtensions());
+}
+
+static int32_t GetReadbackPixelSize(TextureFormatType format)
+{
+	switch (format)
+	{
+	case TextureFormatType::R8G8B8A8_UNORM:
+	case TextureFormatType::R8G8B8A8_UNORM_SRGB:
+	case TextureFormatType::B8G8R8A8_UNORM:
+	case TextureFormatType::R16G16_FLOAT:
+		return 4;
+	case TextureFormatType::R16G16B16A16_FLOAT:
+		return 8;
+	case TextureFormatType::R32G32B32A32_FLOAT:
+		return 16;
+	case TextureFormatType::R8_UNORM:
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+bool CommandListVulkan::ReadbackTexture(Texture* texture,
+										const TextureRegion& region,
+										const std::function<void(const void* data, int32_t size)>& callback)
+{
+	if (isInRenderPass_)
+	{
+		Log(LogType::Error, "Please call ReadbackTexture outside of RenderPass");
+		return false;
+	}
+
+	auto tex = static_cast<TextureVulkan*>(texture);
+	if (tex == nullptr || !tex->GetImage())
+		return false;
+
+	auto pixelSize = GetReadbackPixelSize(tex->GetFormat());
+	if (tex->GetType() == TextureType::Depth || pixelSize == 0)
+	{
+		Log(LogType::Error, "ReadbackTexture doesn't support a format of the texture.");
+		return false;
+	}
+
+	auto textureSize = tex->GetSizeAs2D();
+	auto size = (region.Size.X == 0 && region.Size.Y == 0) ? textureSize : region.Size;
+	if (region.Position.X < 0 || region.Position.Y < 0 || size.X <= 0 || size.Y <= 0 || region.Position.X + size.X > textureSize.X ||
+		region.Position.Y + size.Y > textureSize.Y)
+	{
+		Log(LogType::Error, "ReadbackTexture : a region is out of the texture.");
+		return false;
+	}
+
+	if (!readbackRing_.GetIsInitialized() && !readbackRing_.Initialize(graphics_.get(), ReadbackRingSize))
+		return false;
+
+	auto dataSize = static_cast<VkDeviceSize>(size.X) * size.Y * pixelSize;
+	VkDeviceSize offset = 0;
+	if (!readbackRing_.Allocate(dataSize, currentSwapBufferIndex_, callback, offset))
+	{
+		Log(LogType::Warning, "ReadbackTexture : a readback ring doesn't have enough space.");
+		return false;
+	}
+
+	auto& cmdBuffer = commandBuffers[currentSwapBufferIndex_];
+	const auto& extensions = graphics_->GetDeviceExtensions();
+
+	// a layout is restored because layouts of a screen and render targets are expected by render passes
+	auto previousLayout = tex->GetImageLayout();
+	barrierBatch_.Transition(tex, ImageStateVulkan::FromLayout(vk::ImageLayout::eTransferSrcOptimal));
+	barrierBatch_.Flush(cmdBuffer, &extensions);
+
+	vk::BufferImageCopy copyRegion;
+	copyRegion.bufferOffset = offset;
+	copyRegion.imageSubresource.aspectMask = tex->GetSubresourceRange().aspectMask;
+	copyRegion.imageSubresource.mipLevel = 0;
+	copyRegion.imageSubresource.baseArrayLayer = 0;
+	copyRegion.imageSubresource.layerCount = 1;
+	copyRegion.imageOffset = vk::Offset3D(region.Position.X, region.Position.Y, 0);
+	copyRegion.imageExtent = vk::Extent3D(size.X, size.Y, 1);
+	cmdBuffer.copyImageToBuffer(tex->GetImage(), vk::ImageLayout::eTransferSrcOptimal, readbackRing_.GetBuffer(), copyRegion);
+
+	// make results visible to cpu after a fence is signaled
+	vk::BufferMemoryBarrier bufferBarrier;
+	bufferBarrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+	bufferBarrier.dstAccessMask = vk::AccessFlagBits::eHostRead;
+	bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	bufferBarrier.buffer = readbackRing_.GetBuffer();
+	bufferBarrier.offset = offset;
+	bufferBarrier.size = dataSize;
+	cmdBuffer.pipelineBarrier(
+		vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eHost, vk::DependencyFlags(), nullptr, bufferBarrier, nullptr);
+
+	if (previousLayout != vk::ImageLayout::eUndefined)
+	{
+		barrierBatch_.Transition(tex, ImageStateVulkan::FromLayout(previousLayout));
+		barrierBatch_.Flush(cmdBuffer, &extensions);
+	}
+
+	RegisterReferencedObject(texture);
+	return true;
+}
+
+#if defined(VK_KHR_dynamic_rendering)
+static VkAttachmentLoadOp GetRenderingLoadOp(AttachmentLoadOp loadOp)
+{
+	if (loadOp == AttachmentLoadOp::Load)
+		return VK_ATTACHMENT_LOAD_OP_LOAD;
+	if (loadOp == AttachmentLoadOp::Clear)
+		return VK_ATTACHMENT_LOAD_OP_CLEAR;
+	return VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+}
+
+static VkAttachmentStoreOp GetRenderingStoreOp(AttachmentStoreOp storeOp)
+{
+	if (storeOp == AttachmentStoreOp::Store)
+		return VK_ATTACHMENT_STORE_OP_STORE;
+	return VK_ATTACHMENT_STORE_OP_DONT_CARE;
+}
+#endif
+
+void CommandListVulkan::BeginDynamicRendering(RenderPassVulkan* renderPass)
+{
+#if defined(VK_KHR_dynamic_rendering)
+	auto& cmdBuffer = commandBuffers[currentSwapBufferIndex_];
+	const auto& extensions = graphics_->GetDeviceExtensions();
+	const auto& key = renderPass->renderPassPipelineState->Key;
+	const bool isMultisampled = key.samplingCount > 1;
+	const auto colorState = ImageStateVulkan::FromLayout(vk::ImageLayout::eColorAttachmentOptimal);
+	const auto depthState = ImageStateVulkan::FromLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal);
+
+	VkClearValue clearColor = {};
+	clearColor.color.float32[0] = renderPass->GetClearColor().R / 255.0f;
+	clearColor.color.float32[1] = renderPass->GetClearColor().G / 255.0f;
+	clearColor.color.float32[2] = renderPass->GetClearColor().B / 255.0f;
+	clearColor.color.float32[3] = renderPass->GetClearColor().A / 255.0f;
+
+	std::array<VkRenderingAttachmentInfoKHR, RenderTargetMax> colorAttachments;
+
+	for (int32_t i = 0; i < renderPass->GetRenderTextureCount(); i++)
+	{
+		auto t = static_cast<TextureVulkan*>(renderPass->GetRenderTexture(i));
+
+		// a resolved texture is overwritten
+		auto isDiscarded = key.colorLoadOps.at(i) != AttachmentLoadOp::Load || isMultisampled;
+		barrierBatch_.Transition(t, colorState, isDiscarded);
+
+		auto& attachment = colorAttachments[i];
+		attachment = {};
+		attachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+		attachment.imageView = static_cast<VkImageView>(t->GetAttachmentView());
+		attachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+		attachment.loadOp = GetRenderingLoadOp(key.colorLoadOps.at(i));
+		attachment.storeOp = GetRenderingStoreOp(key.colorStoreOps.at(i));
+		attachment.clearValue = clearColor;
+
+		// a multisampled image is transient, so contents are resolved into a texture instead of being stored
+		if (isMultisampled)
+		{
+			barrierBatch_.TransitionTransient(t->GetMultisampledImage(), vk::ImageAspectFlagBits::eColor, colorState);
+
+			if (attachment.loadOp == VK_ATTACHMENT_LOAD_OP_LOAD)
+			{
+				attachment.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+			}
+			attachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+			attachment.resolveMode = VK_RESOLVE_MODE_AVERAGE_BIT;
+			attachment.resolveImageView = static_cast<VkImageView>(t->GetView());
+			attachment.resolveImageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+		}
+	}
+
+	// a stencil is handled with a depth because they are in the same texture
+	VkRenderingAttachmentInfoKHR depthAttachment = {};
+	if (renderPass->GetHasDepthTexture())
+	{
+		auto t = static_cast<TextureVulkan*>(renderPass->GetDepthTexture());
+		barrierBatch_.Transition(t, depthState, key.depthLoadOp != AttachmentLoadOp::Load);
+
+		depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+		depthAttachment.imageView = static_cast<VkImageView>(t->GetView());
+		depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+		depthAttachment.loadOp = GetRenderingLoadOp(key.depthLoadOp);
+		depthAttachment.storeOp = GetRenderingStoreOp(key.depthStoreOp);
+		depthAttachment.clearValue.depthStencil.depth = 1.0f;
+		depthAttachment.clearValue.depthStencil.stencil = 0;
+	}
+
+	barrierBatch_.Flush(cmdBuffer, &extensions);
+
+	VkRenderingInfoKHR renderingInfo = {};
+	renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+	renderingInfo.renderArea.extent.width = static_cast<uint32_t>(renderPass->GetImageSize().X);
+	renderingInfo.renderArea.extent.height = static_cast<uint32_t>(renderPass->GetImageSize().Y);
+	renderingInfo.layerCount = 1;
+	renderingInfo.colorAttachmentCount = static_cast<uint32_t>(renderPass->GetRenderTextureCount());
+	renderingInfo.pColorAttachments = colorAttachments.data();
+	renderingInfo.pDepthAttachment = renderPass->GetHasDepthTexture() ? &depthAttachment : nullptr;
+	renderingInfo.pStencilAttachment = renderPass->GetHasDepthTexture() ? &depthAttachment : nullptr;
+	extensions.CmdBeginRendering(static_cast<VkCommandBuffer>(cmdBuffer), &renderingInfo);
+
+	dynamicRenderingPass_ = renderPass;
+#endif
+}
+
+void CommandListVulkan::EndDynamicRendering()
+{
+#if defined(VK_KHR_dynamic_rendering)
+	auto& cmdBuffer = commandBuffers[currentSwapBufferIndex_];
+	const auto& extensions = graphics_->GetDeviceExtensions();
+	auto renderPass = dynamicRenderingPass_;
+	auto renderPassPipelineState = renderPass->renderPassPipelineState;
+	dynamicRenderingPass_ = nullptr;
+
+	extensions.CmdEndRendering(static_cast<VkCommandBuffer>(cmdBuffer));
+
+	// colors are left in the same layouts as render passes leave them
+	for (int32_t i = 0; i < renderPass->GetRenderTextureCount(); i++)
+	{
+		auto t = static_cast<TextureVulkan*>(renderPass->GetRenderTexture(i));
+		t->SetState(ImageStateVulkan(vk::ImageLayout::eColorAttachmentOptimal,
+									 vk::PipelineStageFlagBits::eColorAttachmentOutput,
+									 vk::AccessFlagBits::eColorAttachmentWrite));
+		barrierBatch_.Transition(t, ImageStateVulkan::FromLayout(renderPassPipelineState->finalLayouts_.at(i)));
+	}
+
+	if (renderPass->GetHasDepthTexture())
+	{
+		auto t = static_cast<TextureVulkan*>(renderPass->GetDepthTexture());
+		t->SetState(ImageStateVulkan(vk::ImageLayout::eDepthStencilAttachmentOptimal,
+									 vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests,
+									 vk::AccessFlagBits::eDepthStencilAttachmentWrite));
+	}
+
+	barrierBatch_.Flush(cmdBuffer, &extensions);
+#endif
+}
+
 void CommandListVulkan::BeginRenderPass(RenderPass* renderPass)
 {
 	auto renderPass_ = static_cast<RenderPassVulkan*>(renderPass);
 
+	if (renderPass_->renderPassPipelineState->GetIsDynamicRendering())
+	{
+		BeginDynamicRendering(renderPass_);
+
+		auto& cmdBuffer = commandBuffers[currentSwapBufferIndex_];
+		auto size = renderPass_->GetImageSize();
+		cmdBuffer.setViewport(0, vk::Viewport(0.0f, 0.0f, static_cast<float>(size.X), static_cast<float>(size.Y), 0.0f, 1.0f));
+		cmdBuffer.setScissor(0, vk::Rect2D(vk::Offset2D(), vk::Extent2D(size.X, size.Y)));
+
+		RegisterReferencedObject(renderPass);
+		CommandList::BeginRenderPass(renderPass);
+		return;
+	}
+
 	vk::ClearColorValue clearColor(std::array<float, 4>{renderPass_->GetClearColor().R / 255.0f,
 														renderPass_->GetClearColor().G / 255.0f,
 														renderPass_->GetClearColor().B / 255.0f,
@@ -416,32 +1144,49 @@ void CommandListVulkan::BeginRenderPass(RenderPass* renderPass)
 
 	auto& cmdBuffer = commandBuffers[currentSwapBufferIndex_];
 
+	// clear values are indexed by attachments, so they are specified for all attachments regardless of load actions
 	vk::ClearValue clear_values[RenderTargetMax + 1];
-	int clearValueCount = 0;
+	int clearValueCount = renderPass_->GetRenderTextureCount();
 
-	if (renderPass->GetIsColorCleared())
+	for (int32_t i = 0; i < renderPass_->GetRenderTextureCount(); i++)
 	{
-		for (int32_t i = 0; i < renderPass_->GetRenderTextureCount(); i++)
-		{
-			clear_values[i].color = clearColor;
-			clearValueCount++;
-		}
+		clear_values[i].color = clearColor;
 	}
 
-	if (renderPass_->GetHasDepthTexture() && renderPass->GetIsDepthCleared())
+	if (renderPass_->GetHasDepthTexture())
 	{
 		clear_values[renderPass_->GetRenderTextureCount()].depthStencil = clearDepth;
 		clearValueCount++;
 	}
 
-	clear_values[renderPass_->GetRenderTextureCount()].depthStencil = clearDepth;
+	// all attachments are transitioned with one barrier. contents which are not loaded are discarded.
+	auto renderPassPipelineState = renderPass_->renderPassPipelineState;
+	auto samplingCount = renderPassPipelineState->Key.samplingCount;
+
+	for (int32_t i = 0; i < renderPass_->GetRenderTextureCount(); i++)
+	{
+		auto t = static_cast<TextureVulkan*>(renderPass_->GetRenderTexture(i));
+
+		// layouts of a screen are changed by the render pass
+		if (t->GetType() == TextureType::Screen)
+			continue;
+
+		ImageStateVulkan state(renderPassPipelineState->finalLayouts_.at(i),
+							   vk::PipelineStageFlagBits::eColorAttachmentOutput,
+							   vk::AccessFlagBits::eColorAttachmentRead | vk::AccessFlagBits::eColorAttachmentWrite);
+		auto isDiscarded = renderPassPipelineState->Key.colorLoadOps.at(i) != AttachmentLoadOp::Load || samplingCount > 1;
+		barrierBatch_.Transition(t, state, isDiscarded);
+	}
 
 	if (renderPass_->GetHasDepthTexture())
 	{
 		auto t = static_cast<TextureVulkan*>(renderPass_->GetDepthTexture());
-		t->ResourceBarrior(cmdBuffer, vk::ImageLayout::eDepthStencilAttachmentOptimal);
+		auto isDiscarded = renderPassPipelineState->Key.depthLoadOp != AttachmentLoadOp::Load;
+		barrierBatch_.Transition(t, ImageStateVulkan::FromLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal), isDiscarded);
 	}
 
+	barrierBatch_.Flush(cmdBuffer, &graphics_->GetDeviceExtensions());
+
 	// begin renderpass
 	vk::RenderPassBeginInfo renderPassBeginInfo;
 	renderPassBeginInfo.framebuffer = renderPass_->frameBuffer_;
@@ -458,27 +1203,48 @@ void CommandListVulkan::BeginRenderPass(RenderPass* renderPass)
 	vk::Rect2D scissor = vk::Rect2D(vk::Offset2D(), vk::Extent2D(renderPass_->GetImageSize().X, renderPass_->GetImageSize().Y));
 	cmdBuffer.setScissor(0, scissor);
 
-	for (size_t i = 0; i < renderPass_->GetRenderTextureCount(); i++)
+	// layouts are changed by the render pass
+	for (int32_t i = 0; i < renderPass_->GetRenderTextureCount(); i++)
 	{
 		auto t = static_cast<TextureVulkan*>(renderPass_->GetRenderTexture(i));
-		t->ChangeImageLayout(renderPass_->renderPassPipelineState->finalLayouts_.at(i));
+		t->SetState(ImageStateVulkan(renderPassPipelineState->finalLayouts_.at(i),
+									 vk::PipelineStageFlagBits::eColorAttachmentOutput,
+									 vk::AccessFlagBits::eColorAttachmentWrite));
 	}
 
 	if (renderPass_->GetHasDepthTexture())
 	{
 		auto t = static_cast<TextureVulkan*>(renderPass_->GetDepthTexture());
-		t->ChangeImageLayout(renderPass_->renderPassPipelineState->finalLayouts_.at(renderPass_->GetRenderTextureCount()));
+		t->SetState(ImageStateVulkan(renderPassPipelineState->finalLayouts_.at(renderPass_->GetRenderTextureCount()),
+									 vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests,
+									 vk::AccessFlagBits::eDepthStencilAttachmentWrite));
 	}
 
+	// a render pass which is created every frame may be released before gpu finishes using it
+	RegisterReferencedObject(renderPass);
+
 	CommandList::BeginRenderPass(renderPass);
 }
 
+void CommandListVulkan::NextSubpass()
+{
+	auto& cmdBuffer = commandBuffers[currentSwapBufferIndex_];
+	cmdBuffer.nextSubpass(vk::SubpassContents::eInline);
+}
+
 void CommandListVulkan::EndRenderPass()
 {
 	auto& cmdBuffer = commandBuffers[currentSwapBufferIndex_];
 
 	// end renderpass
-	cmdBuffer.endRenderPass();
+	if (dynamicRenderingPass_ != nullptr)
+	{
+		EndDynamicRendering();
+	}
+	else
+	{
+		cmdBuffer.endRenderPass();
+	}
 
 	CommandList::EndRenderPass();
 }
@@ -498,6 +1264,8 @@ void CommandListVulkan::WaitUntilCompleted()
 		vk::Result fenceRes =
 			graphics_->GetDevice().waitForFences(fences_[currentSwapBufferIndex_], VK_TRUE, std::numeric_limits<int>::max());
 		assert(fenceRes == vk::Result::eSuccess);
+
+		readbackRing_.CompleteAll();
 	}
 }
 
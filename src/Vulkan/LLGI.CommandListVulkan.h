@@ -2,6 +2,9 @@
 
 #include "../LLGI.CommandList.h"
 #include "LLGI.BaseVulkan.h"
+#include "LLGI.ImageBarrierBatchVulkan.h"
+#include "LLGI.ReadbackRingVulkan.h"
+#include <map>
 
 namespace LLGI
 {
@@ -18,25 +21,121 @@ private:
 	vk::DescriptorPool descriptorPool_ = nullptr;
 	int32_t size_ = 0;
 	int32_t stage_ = 0;
-	int32_t offset = 0;
-	std::vector<std::vector<vk::DescriptorSet>> cache;
+
+	//! sets which are allocated with layouts. they are reused in each frame
+	struct CachedSets
+	{
+		std::vector<std::vector<vk::DescriptorSet>> Sets;
+		int32_t Offset = 0;
+	};
+
+	std::map<std::pair<VkDescriptorSetLayout, VkDescriptorSetLayout>, CachedSets> caches_;
+
+	//! the number of sets which are allocated from the pool since it is reset
+	int32_t allocatedSetCount_ = 0;
 
 public:
 	DescriptorPoolVulkan(std::shared_ptr<GraphicsVulkan> graphics, int32_t size, int stage);
 	virtual ~DescriptorPoolVulkan();
 	const std::vector<vk::DescriptorSet>& Get(PipelineStateVulkan* pip);
+
+	/**
+		@brief	reuse sets from the beginning
+		@note
+		The pool is reset if sets of a layout were not used in the previous frame
+		or cached sets exceed sets which a frame can use, so that the pool is not exhausted.
+	*/
 	void Reset();
 };
 
+struct DescriptorWritesVulkan
+{
+	static const int MaxCount = (NumTexture + 1) * static_cast<int>(ShaderStageType::Max);
+
+	std::array<vk::WriteDescriptorSet, MaxCount> writes;
+	std::array<vk::DescriptorBufferInfo, MaxCount> bufferInfos;
+	std::array<vk::DescriptorImageInfo, MaxCount> imageInfos;
+	int32_t writeCount = 0;
+	int32_t bufferInfoCount = 0;
+	int32_t imageInfoCount = 0;
+};
+
 class CommandListVulkan : public CommandList
 {
 private:
+	struct VertexDescriptorKey
+	{
+		vk::DescriptorSetLayout layout;
+		vk::Buffer buffer;
+		vk::DeviceSize range = 0;
+		std::array<vk::ImageView, NumTexture> views;
+
+		bool operator==(const VertexDescriptorKey& value) const
+		{
+			return layout == value.layout && buffer == value.buffer && range == value.range && views == value.views;
+		}
+	};
+
 	std::shared_ptr<GraphicsVulkan> graphics_;
 	std::vector<vk::CommandBuffer> commandBuffers;
 	std::vector<std::shared_ptr<DescriptorPoolVulkan>> descriptorPools;
 	int32_t currentSwapBufferIndex_;
 	std::vector<vk::Fence> fences_;
 
+	//! a set of the vertex shader which is reused in the push descriptor mode
+	vk::DescriptorSet vertexDescriptorSet_;
+	VertexDescriptorKey vertexDescriptorKey_;
+
+	//! transitions of textures which are recorded together
+	ImageBarrierBatchVulkan barrierBatch_;
+
+	//! a render pass which is rendered with VK_KHR_dynamic_rendering now
+	RenderPassVulkan* dynamicRenderingPass_ = nullptr;
+
+	//! the size of readbackRing_ which is created when a texture is read first
+	static const int32_t ReadbackRingSize = 16 * 1024 * 1024;
+
+	//! a buffer which receives textures read by ReadbackTexture. regions are freed when command buffers are reused
+	ReadbackRingVulkan readbackRing_;
+
+	bool GatherDescriptorWrites(ShaderStageType stage,
+								int32_t bindingMask,
+								int32_t inputAttachmentMask,
+								vk::DescriptorSet dstSet,
+								vk::DescriptorType constantBufferType,
+								bool isOffsetDynamic,
+								DescriptorWritesVulkan& writes);
+
+	/**
+		@brief	update a set with bindings of a stage
+		@note
+		A descriptor update template of the pipeline is used if it is supported, so that the set is written in one call.
+	*/
+	bool UpdateDescriptorSet(PipelineStateVulkan* pip, ShaderStageType stage, vk::DescriptorSet dstSet, bool isOffsetDynamic);
+
+	void BindDescriptorSetsWithPool(PipelineStateVulkan* pip);
+
+	/**
+		@brief	bind descriptors with VK_KHR_push_descriptor
+		@note
+		The set of the pixel shader is pushed. The set of the vertex shader is reused with a dynamic offset while bindings are not changed.
+	*/
+	void BindDescriptorSetsWithPush(PipelineStateVulkan* pip);
+
+	/**
+		@brief	bind a vertex buffer, an index buffer, descriptors and a pipeline for drawing
+	*/
+	PipelineStateVulkan* BindDrawingStates(bool isIndexed);
+
+	/**
+		@brief	begin rendering into attachments of a render pass with VK_KHR_dynamic_rendering
+		@note
+		Layouts of attachments are changed with barriers instead of a render pass.
+	*/
+	void BeginDynamicRendering(RenderPassVulkan* renderPass);
+
+	void EndDynamicRendering();
+
 public:
 	CommandListVulkan();
 	virtual ~CommandListVulkan();
@@ -51,9 +150,32 @@ public:
 
 	void SetScissor(int32_t x, int32_t y, int32_t width, int32_t height) override;
 	void Draw(int32_t pritimiveCount) override;
+	void DrawIndexed(int32_t indexCount, int32_t firstIndex, int32_t baseVertex) override;
+	void DrawNonIndexed(int32_t vertexCount, int32_t firstVertex) override;
+	void DrawIndirect(IndirectBuffer* argumentBuffer, int32_t offset, int32_t drawCount, int32_t stride) override;
+	void DrawIndexedIndirect(IndirectBuffer* argumentBuffer, int32_t offset, int32_t drawCount, int32_t stride) override;
+	void DrawIndirectCount(IndirectBuffer* argumentBuffer,
+						   int32_t offset,
+						   IndirectBuffer* countBuffer,
+						   int32_t countOffset,
+						   int32_t maxDrawCount,
+						   int32_t stride) override;
+	void DrawIndexedIndirectCount(IndirectBuffer* argumentBuffer,
+								  int32_t offset,
+								  IndirectBuffer* countBuffer,
+								  int32_t countOffset,
+								  int32_t maxDrawCount,
+								  int32_t stride) override;
+	void DrawIndexedMulti(const DrawIndexedRange* ranges, int32_t count) override;
+	void SetPushConstants(ShaderStageType shaderStage, int32_t offset, int32_t size, const void* data) override;
 	void CopyTexture(Texture* src, Texture* dst) override;
+	void TransitionTextures(const TextureBarrier* barriers, int32_t count) override;
+	bool ReadbackTexture(Texture* texture,
+						 const TextureRegion& region,
+						 const std::function<void(const void* data, int32_t size)>& callback) override;
 
 	void BeginRenderPass(RenderPass* renderPass) override;
+	void NextSubpass() override;
 	void EndRenderPass() override;
 	vk::CommandBuffer GetCommandBuffer() const;
 	vk::Fence GetFence() const;
@@ -0,0 +1,179 @@
+#include "LLGI.CompilerCacheVulkan.h"
+#include <atomic>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdio.h>
+#include <string.h>
+
+namespace LLGI
+{
+
+static const char CacheFileMagic[4] = {'L', 'S', 'C', 'C'};
+
+CompilerCacheVulkan::CompilerCacheVulkan(size_t maxMemorySize) : maxMemorySize_(maxMemorySize) {}
+
+std::string CompilerCacheVulkan::GetFilePath(const std::string& directory, uint64_t key)
+{
+	char name[32];
+	snprintf(name, sizeof(name), "%016llx.spv", static_cast<unsigned long long>(key));
+	return directory + "/" + name;
+}
+
+void CompilerCacheVulkan::StoreInMemory(uint64_t key, const std::vector<uint8_t>& binary)
+{
+	if (binary.size() > maxMemorySize_)
+		return;
+
+	auto it = entryMap_.find(key);
+	if (it != entryMap_.end())
+	{
+		memorySize_ -= it->second->second.size();
+		entries_.erase(it->second);
+		entryMap_.erase(it);
+	}
+
+	entries_.emplace_front(key, binary);
+	entryMap_[key] = entries_.begin();
+	memorySize_ += binary.size();
+
+	// remove least recently used binaries
+	while (memorySize_ > maxMemorySize_)
+	{
+		auto& last = entries_.back();
+		memorySize_ -= last.second.size();
+		entryMap_.erase(last.first);
+		entries_.pop_back();
+	}
+}
+
+bool CompilerCacheVulkan::LoadFromFile(const std::string& directory, uint64_t key, std::vector<uint8_t>& binary)
+{
+	std::ifstream file(GetFilePath(directory, key), std::ios::binary);
+	if (!file)
+		return false;
+
+	char magic[sizeof(CacheFileMagic)];
+	uint64_t storedKey = 0;
+	uint64_t size = 0;
+
+	file.read(magic, sizeof(magic));
+	file.read(reinterpret_cast<char*>(&storedKey), sizeof(storedKey));
+	file.read(reinterpret_cast<char*>(&size), sizeof(size));
+
+	if (!file || memcmp(magic, CacheFileMagic, sizeof(magic)) != 0 || storedKey != key)
+		return false;
+
+	// a size in a broken file must not be trusted before allocating a binary
+	auto begin = file.tellg();
+	file.seekg(0, std::ios::end);
+	auto end = file.tellg();
+	file.seekg(begin);
+
+	if (!file || begin < 0 || end < begin || size != static_cast<uint64_t>(end - begin))
+		return false;
+
+	binary.resize(static_cast<size_t>(size));
+	file.read(reinterpret_cast<char*>(binary.data()), binary.size());
+
+	// a file which is broken or being written is ignored
+	if (!file || file.peek() != std::char_traits<char>::eof())
+	{
+		binary.clear();
+		return false;
+	}
+
+	return true;
+}
+
+void CompilerCacheVulkan::StoreInFile(const std::string& directory, uint64_t key, const std::vector<uint8_t>& binary)
+{
+	static const uint32_t processToken = std::random_device()();
+	static std::atomic<uint32_t> fileCount(0);
+
+	auto path = GetFilePath(directory, key);
+
+	// a temporary file must be unique among processes and threads
+	std::ostringstream tempPath;
+	tempPath << path << "." << std::hex << processToken << "." << fileCount++ << ".tmp";
+
+	{
+		std::ofstream file(tempPath.str(), std::ios::binary);
+		if (!file)
+		{
+			Log(LogType::Warning, "Failed to write a shader cache.");
+			return;
+		}
+
+		uint64_t size = binary.size();
+		file.write(CacheFileMagic, sizeof(CacheFileMagic));
+		file.write(reinterpret_cast<const char*>(&key), sizeof(key));
+		file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+		file.write(reinterpret_cast<const char*>(binary.data()), binary.size());
+
+		if (!file)
+		{
+			file.close();
+			remove(tempPath.str().c_str());
+			return;
+		}
+	}
+
+	// rename fails if a file exists on some platforms. but another process has written the same binary in that case.
+	if (rename(tempPath.str().c_str(), path.c_str()) != 0)
+	{
+		remove(tempPath.str().c_str());
+	}
+}
+
+void CompilerCacheVulkan::SetDirectory(const char* directory)
+{
+	std::lock_guard<std::mutex> lock(mtx_);
+	directory_ = directory != nullptr ? directory : "";
+}
+
+bool CompilerCacheVulkan::Get(uint64_t key, std::vector<uint8_t>& binary)
+{
+	std::string directory;
+
+	{
+		std::lock_guard<std::mutex> lock(mtx_);
+
+		auto it = entryMap_.find(key);
+		if (it != entryMap_.end())
+		{
+			// mark as recently used
+			entries_.splice(entries_.begin(), entries_, it->second);
+			binary = it->second->second;
+			return true;
+		}
+
+		directory = directory_;
+	}
+
+	// files are accessed without a lock because other threads may compile shaders
+	if (directory.empty() || !LoadFromFile(directory, key, binary))
+		return false;
+
+	std::lock_guard<std::mutex> lock(mtx_);
+	StoreInMemory(key, binary);
+	return true;
+}
+
+void CompilerCacheVulkan::Store(uint64_t key, const std::vector<uint8_t>& binary)
+{
+	std::string directory;
+
+	{
+		std::lock_guard<std::mutex> lock(mtx_);
+		StoreInMemory(key, binary);
+		directory = directory_;
+	}
+
+	if (!directory.empty())
+	{
+		StoreInFile(directory, key, binary);
+	}
+}
+
+} // namespace LLGI
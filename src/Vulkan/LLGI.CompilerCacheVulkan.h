@@ -0,0 +1,52 @@
+
+#pragma once
+
+#include "../LLGI.Base.h"
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace LLGI
+{
+
+/**
+	@brief	a cache of compiled shaders which is keyed by a hash of a source and compile options
+	@note
+	Binaries are kept in memory with LRU and stored in a directory if it is specified.
+	A file is written into a temporary file and renamed, so several processes can share a directory.
+	It is thread safe.
+*/
+class CompilerCacheVulkan
+{
+private:
+	typedef std::list<std::pair<uint64_t, std::vector<uint8_t>>> EntryList;
+
+	std::mutex mtx_;
+	EntryList entries_;
+	std::unordered_map<uint64_t, EntryList::iterator> entryMap_;
+	size_t memorySize_ = 0;
+	size_t maxMemorySize_ = 0;
+	std::string directory_;
+
+	void StoreInMemory(uint64_t key, const std::vector<uint8_t>& binary);
+
+	static std::string GetFilePath(const std::string& directory, uint64_t key);
+
+	static bool LoadFromFile(const std::string& directory, uint64_t key, std::vector<uint8_t>& binary);
+
+	static void StoreInFile(const std::string& directory, uint64_t key, const std::vector<uint8_t>& binary);
+
+public:
+	CompilerCacheVulkan(size_t maxMemorySize = 16 * 1024 * 1024);
+
+	/**
+		@brief	specify a directory to store binaries. A directory must exist. It is disabled if an empty string is specified.
+	*/
+	void SetDirectory(const char* directory);
+
+	bool Get(uint64_t key, std::vector<uint8_t>& binary);
+
+	void Store(uint64_t key, const std::vector<uint8_t>& binary);
+};
+
+} // namespace LLGI
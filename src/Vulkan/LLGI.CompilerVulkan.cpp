@@ -1,5 +1,11 @@
 
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iterator>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 #if defined(ENABLE_VULKAN_COMPILER)
 #include <glslang/Public/ShaderLang.h>
@@ -8,6 +14,7 @@
 #endif
 
 #include "LLGI.CompilerVulkan.h"
+#include "../Utils/LLGI.Hash.h"
 
 namespace LLGI
 {
@@ -120,20 +127,160 @@ const TBuiltInResource DefaultTBuiltInResource = {
         /* .generalConstantMatrixVectorIndexing = */ 1,
     }};
 
+// a version of cached binaries. it must be increased when options of compiling are changed.
+const uint32_t CompilerCacheVersion = 1;
+
+const int ClientInputSemanticsVersion = 100; // #define VULKAN 100
+const glslang::EShTargetClientVersion VulkanClientVersion = glslang::EShTargetVulkan_1_0;
+const glslang::EShTargetLanguageVersion TargetVersion = glslang::EShTargetSpv_1_0;
+
+// glslang::InitializeProcess and FinalizeProcess are process-wide, so they are called by the first and the last compiler.
+static std::mutex glslangMutex;
+static int32_t glslangReferenceCount = 0;
+
+static void InitializeGlslang()
+{
+    std::lock_guard<std::mutex> lock(glslangMutex);
+    if (glslangReferenceCount == 0)
+    {
+        glslang::InitializeProcess();
+    }
+    glslangReferenceCount++;
+}
+
+static void FinalizeGlslang()
+{
+    std::lock_guard<std::mutex> lock(glslangMutex);
+    glslangReferenceCount--;
+    if (glslangReferenceCount == 0)
+    {
+        glslang::FinalizeProcess();
+    }
+}
+
+const char* const ShaderName = "shadercode";
+
+class IncluderVulkan : public glslang::TShader::Includer
+{
+private:
+    const std::vector<std::string>& directories_;
+
+    static IncludeResult* Open(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            return nullptr;
+        }
+
+        auto content = new std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        return new IncludeResult(path, content->c_str(), content->size(), content);
+    }
+
+    IncludeResult* Find(const char* headerName)
+    {
+        for (const auto& directory : directories_)
+        {
+            auto result = Open(directory + "/" + headerName);
+            if (result != nullptr)
+            {
+                return result;
+            }
+        }
+        return nullptr;
+    }
+
+public:
+    IncluderVulkan(const std::vector<std::string>& directories) : directories_(directories) {}
+
+    IncludeResult* includeSystem(const char* headerName, const char* includerName, size_t inclusionDepth) override
+    {
+        return Find(headerName);
+    }
+
+    IncludeResult* includeLocal(const char* headerName, const char* includerName, size_t inclusionDepth) override
+    {
+        // a header included by another header is searched from a directory of the header first
+        if (includerName != nullptr && strcmp(includerName, ShaderName) != 0)
+        {
+            std::string includer = includerName;
+            auto separator = includer.find_last_of("/\\");
+            if (separator != std::string::npos)
+            {
+                auto result = Open(includer.substr(0, separator + 1) + headerName);
+                if (result != nullptr)
+                {
+                    return result;
+                }
+            }
+        }
+
+        return Find(headerName);
+    }
+
+    void releaseInclude(IncludeResult* result) override
+    {
+        if (result == nullptr)
+        {
+            return;
+        }
+
+        delete static_cast<std::string*>(result->userData);
+        delete result;
+    }
+};
+
+static std::string GetPreamble(const std::vector<CompilerDefine>& defines, bool isIncludeEnabled)
+{
+    std::string preamble;
+    if (isIncludeEnabled)
+    {
+        preamble += "#extension GL_GOOGLE_include_directive : enable\n";
+    }
+
+    for (const auto& define : defines)
+    {
+        preamble += "#define " + define.Name + " " + define.Value + "\n";
+    }
+    return preamble;
+}
+
+static uint64_t GetCacheKey(const char* code,
+                            ShaderStageType shaderStage,
+                            const std::string& preamble,
+                            CompilerOptimizationLevel optimizationLevel)
+{
+    auto key = CalculateFNV1a64(code, strlen(code));
+    key = CalculateFNV1a64(&shaderStage, sizeof(shaderStage), key);
+    key = CalculateFNV1a64(preamble.c_str(), preamble.size(), key);
+    key = CalculateFNV1a64(&optimizationLevel, sizeof(optimizationLevel), key);
+    key = CalculateFNV1a64(&CompilerCacheVersion, sizeof(CompilerCacheVersion), key);
+    key = CalculateFNV1a64(&ClientInputSemanticsVersion, sizeof(ClientInputSemanticsVersion), key);
+    key = CalculateFNV1a64(&VulkanClientVersion, sizeof(VulkanClientVersion), key);
+    key = CalculateFNV1a64(&TargetVersion, sizeof(TargetVersion), key);
+
+    // a version of glslang
+    auto toolId = glslang::GetKhronosToolId();
+    key = CalculateFNV1a64(&toolId, sizeof(toolId), key);
+    auto glslVersion = glslang::GetGlslVersionString();
+    key = CalculateFNV1a64(glslVersion, strlen(glslVersion), key);
+    return key;
+}
+
 #endif
 
 
 CompilerVulkan::CompilerVulkan()
 {
 #if defined(ENABLE_VULKAN_COMPILER)
-    glslang::InitializeProcess();
+    InitializeGlslang();
 #endif
 }
 
 CompilerVulkan::~CompilerVulkan()
 {
 #if defined(ENABLE_VULKAN_COMPILER)
-    glslang::FinalizeProcess();
+    FinalizeGlslang();
 #endif
 }
 
@@ -141,10 +288,81 @@ void CompilerVulkan::Initialize()
 {
 }
 
+void CompilerVulkan::SetCacheDirectory(const char* directory)
+{
+    cache_.SetDirectory(directory);
+}
+
+void CompilerVulkan::AddIncludeDirectory(const char* directory)
+{
+    includeDirectories_.push_back(directory);
+}
+
+void CompilerVulkan::SetOptimizationLevel(CompilerOptimizationLevel level)
+{
+    optimizationLevel_ = level;
+}
+
 void CompilerVulkan::Compile(CompilerResult& result, const char* code, ShaderStageType shaderStage)
+{
+    Compile(result, code, shaderStage, std::vector<CompilerDefine>());
+}
+
+void CompilerVulkan::CompileBatch(CompilerJob* jobs, int32_t count)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+
+    auto threadCount = std::min(static_cast<int32_t>(std::max(std::thread::hardware_concurrency(), 1u)), count);
+
+    std::atomic<int32_t> nextJob(0);
+    auto compileJobs = [this, jobs, count, &nextJob]() -> void {
+        while (true)
+        {
+            auto i = nextJob.fetch_add(1);
+            if (i >= count)
+            {
+                break;
+            }
+
+            Compile(jobs[i].Result, jobs[i].Code, jobs[i].Stage, jobs[i].Defines);
+        }
+    };
+
+    // the calling thread compiles too
+    std::vector<std::thread> threads;
+    for (int32_t i = 0; i < threadCount - 1; i++)
+    {
+        threads.emplace_back(compileJobs);
+    }
+
+    compileJobs();
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+void CompilerVulkan::Compile(CompilerResult& result, const char* code, ShaderStageType shaderStage, const std::vector<CompilerDefine>& defines)
 {
 #if defined(ENABLE_VULKAN_COMPILER)
 
+    auto preamble = GetPreamble(defines, includeDirectories_.size() > 0);
+    auto cacheKey = GetCacheKey(code, shaderStage, preamble, optimizationLevel_);
+
+    // included files are not a part of the key
+    auto isCacheEnabled = strstr(code, "#include") == nullptr;
+
+    result.Binary.resize(1);
+    if (isCacheEnabled && cache_.Get(cacheKey, result.Binary[0]))
+    {
+        return;
+    }
+    result.Binary.clear();
+
     const int defaultVersion = 110;
 
     EShLanguage stage;
@@ -164,15 +382,12 @@ void CompilerVulkan::Compile(CompilerResult& result, const char* code, ShaderSta
 
     auto shader = std::make_shared<glslang::TShader>(stage);
 
-    int ClientInputSemanticsVersion = 100; // #define VULKAN 100
-    glslang::EShTargetClientVersion VulkanClientVersion = glslang::EShTargetVulkan_1_0;
-    glslang::EShTargetLanguageVersion TargetVersion = glslang::EShTargetSpv_1_0;
-
     const char* shaderCode[1] = { code };
     const int shaderLenght[1] = { static_cast<int>(strlen(code)) };
-    const char* shaderName[1] = { "shadercode" };
+    const char* shaderName[1] = { ShaderName };
     shader->setStringsWithLengthsAndNames(shaderCode, shaderLenght, shaderName, 1);
     shader->setEntryPoint("main");
+    shader->setPreamble(preamble.c_str());
     shader->setEnvInput(glslang::EShSourceGlsl, stage, glslang::EShClientVulkan, ClientInputSemanticsVersion);
     shader->setEnvClient(glslang::EShClientVulkan, VulkanClientVersion);
     shader->setEnvTarget(glslang::EShTargetSpv, TargetVersion);
@@ -184,7 +399,8 @@ void CompilerVulkan::Compile(CompilerResult& result, const char* code, ShaderSta
     EShMessages messages = (EShMessages)(EShMsgSpvRules | EShMsgVulkanRules);
 
     // compile
-    if (!shader->parse(&Resources, 100, false, messages))
+    IncluderVulkan includer(includeDirectories_);
+    if (!shader->parse(&Resources, 100, false, messages, includer))
     {
         result.Message += "GLSL Parsing Failed:";
         result.Message += shader->getInfoLog();
@@ -209,11 +425,19 @@ void CompilerVulkan::Compile(CompilerResult& result, const char* code, ShaderSta
     std::vector<unsigned int> spirvCode;
     spv::SpvBuildLogger logger;
     glslang::SpvOptions spvOptions;
+    spvOptions.disableOptimizer = optimizationLevel_ == CompilerOptimizationLevel::None;
+    spvOptions.optimizeSize = optimizationLevel_ == CompilerOptimizationLevel::Size;
+    spvOptions.stripDebugInfo = optimizationLevel_ != CompilerOptimizationLevel::None;
     glslang::GlslangToSpv(*program->getIntermediate(stage), spirvCode, &logger, &spvOptions);
 
     result.Binary.resize(1);
     result.Binary[0].resize(spirvCode.size() * sizeof(unsigned int));
     memcpy(result.Binary[0].data(), spirvCode.data(), result.Binary[0].size());
+
+    if (isCacheEnabled)
+    {
+        cache_.Store(cacheKey, result.Binary[0]);
+    }
 #endif
 
 }
@@ -3,6 +3,7 @@
 
 #include "../LLGI.Compiler.h"
 #include "LLGI.BaseVulkan.h"
+#include "LLGI.CompilerCacheVulkan.h"
 
 namespace LLGI
 {
@@ -10,6 +11,10 @@ namespace LLGI
 class CompilerVulkan : public Compiler
 {
 private:
+	CompilerCacheVulkan cache_;
+	std::vector<std::string> includeDirectories_;
+	CompilerOptimizationLevel optimizationLevel_ = CompilerOptimizationLevel::None;
+
 public:
 	CompilerVulkan();
 	virtual ~CompilerVulkan();
@@ -17,6 +22,26 @@ public:
 	void Initialize() override;
 	void Compile(CompilerResult& result, const char* code, ShaderStageType shaderStage) override;
 
+	void Compile(CompilerResult& result, const char* code, ShaderStageType shaderStage, const std::vector<CompilerDefine>& defines) override;
+
+	/**
+		@brief	compile jobs on worker threads
+		@note
+		glslang is initialized once per process, so it is safe to compile with several instances at the same time.
+	*/
+	void CompileBatch(CompilerJob* jobs, int32_t count) override;
+
+	void SetCacheDirectory(const char* directory) override;
+
+	void AddIncludeDirectory(const char* directory) override;
+
+	/**
+		@brief	specify how compiled binaries are optimized
+		@note
+		Optimization passes of SPIRV-Tools are run only if glslang is built with ENABLE_OPT.
+	*/
+	void SetOptimizationLevel(CompilerOptimizationLevel level) override;
+
 	DeviceType GetDeviceType() const override { return DeviceType::Default; }
 };
 
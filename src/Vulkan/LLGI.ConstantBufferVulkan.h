@@ -31,6 +31,8 @@ public:
 	int32_t GetSize() override;
 
 	vk::Buffer GetBuffer() { return buffer_->buffer(); }
+
+	int32_t GetOffset() const { return offset_; }
 };
 
 } // namespace LLGI
@@ -0,0 +1,359 @@
+#include "LLGI.DeviceExtensionsVulkan.h"
+#include <algorithm>
+#include <string.h>
+
+namespace LLGI
+{
+
+bool DeviceExtensionsVulkan::HasExtension(const std::vector<vk::ExtensionProperties>& properties, const char* name) const
+{
+	for (const auto& p : properties)
+	{
+		if (strcmp(p.extensionName, name) == 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+std::vector<const char*> DeviceExtensionsVulkan::GetInstanceExtensionNames()
+{
+	std::vector<const char*> ret;
+
+	auto properties = vk::enumerateInstanceExtensionProperties();
+	for (const auto& p : properties)
+	{
+		if (strcmp(p.extensionName, VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME) == 0)
+		{
+			ret.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+		}
+	}
+
+	return ret;
+}
+
+void DeviceExtensionsVulkan::Select(vk::Instance instance, vk::PhysicalDevice physicalDevice, bool isBindlessRequested)
+{
+	extensionNames_.clear();
+
+	auto properties = physicalDevice.enumerateDeviceExtensionProperties();
+
+	auto getFeatures2 = (PFN_vkGetPhysicalDeviceFeatures2KHR)instance.getProcAddr("vkGetPhysicalDeviceFeatures2KHR");
+	auto getProperties2 = (PFN_vkGetPhysicalDeviceProperties2KHR)instance.getProcAddr("vkGetPhysicalDeviceProperties2KHR");
+
+#if defined(VK_KHR_draw_indirect_count)
+	if (HasExtension(properties, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME))
+	{
+		extensionNames_.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+		IsDrawIndirectCountSupported = true;
+	}
+#endif
+
+#if defined(VK_KHR_push_descriptor)
+	if (HasExtension(properties, VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME))
+	{
+		extensionNames_.push_back(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+		IsPushDescriptorSupported = true;
+	}
+#endif
+
+#if defined(VK_KHR_descriptor_update_template)
+	if (HasExtension(properties, VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME))
+	{
+		extensionNames_.push_back(VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME);
+		IsDescriptorUpdateTemplateSupported = true;
+	}
+#endif
+
+#if defined(VK_EXT_descriptor_indexing)
+	if (isBindlessRequested && getFeatures2 != nullptr && getProperties2 != nullptr &&
+		HasExtension(properties, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME) &&
+		HasExtension(properties, VK_KHR_MAINTENANCE3_EXTENSION_NAME))
+	{
+		VkPhysicalDeviceDescriptorIndexingFeaturesEXT supportedFeatures = {};
+		supportedFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+
+		VkPhysicalDeviceFeatures2KHR features = {};
+		features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+		features.pNext = &supportedFeatures;
+		getFeatures2(static_cast<VkPhysicalDevice>(physicalDevice), &features);
+
+		VkPhysicalDeviceDescriptorIndexingPropertiesEXT indexingProperties = {};
+		indexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+
+		VkPhysicalDeviceProperties2KHR properties2 = {};
+		properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR;
+		properties2.pNext = &indexingProperties;
+		getProperties2(static_cast<VkPhysicalDevice>(physicalDevice), &properties2);
+
+		if (supportedFeatures.runtimeDescriptorArray == VK_TRUE && supportedFeatures.descriptorBindingPartiallyBound == VK_TRUE &&
+			supportedFeatures.descriptorBindingSampledImageUpdateAfterBind == VK_TRUE &&
+			supportedFeatures.shaderSampledImageArrayNonUniformIndexing == VK_TRUE)
+		{
+			// enable only required features
+			descriptorIndexingFeatures_ = {};
+			descriptorIndexingFeatures_.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+			descriptorIndexingFeatures_.runtimeDescriptorArray = VK_TRUE;
+			descriptorIndexingFeatures_.descriptorBindingPartiallyBound = VK_TRUE;
+			descriptorIndexingFeatures_.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+			descriptorIndexingFeatures_.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+
+			extensionNames_.push_back(VK_KHR_MAINTENANCE3_EXTENSION_NAME);
+			extensionNames_.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+			IsBindlessSupported = true;
+
+			const uint32_t maxTextureCount = 16384;
+			MaxBindlessTextureCount = static_cast<int32_t>(
+				std::min(std::min(indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages,
+								  indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages),
+						 maxTextureCount));
+		}
+	}
+#endif
+
+#if defined(VK_EXT_extended_dynamic_state)
+	if (getFeatures2 != nullptr && HasExtension(properties, VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME))
+	{
+		extendedDynamicStateFeatures_ = {};
+		extendedDynamicStateFeatures_.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT;
+
+		VkPhysicalDeviceFeatures2KHR features = {};
+		features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+		features.pNext = &extendedDynamicStateFeatures_;
+		getFeatures2(static_cast<VkPhysicalDevice>(physicalDevice), &features);
+
+		if (extendedDynamicStateFeatures_.extendedDynamicState == VK_TRUE)
+		{
+			extensionNames_.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME);
+			IsExtendedDynamicStateSupported = true;
+		}
+	}
+#endif
+
+#if defined(VK_EXT_graphics_pipeline_library)
+	if (getFeatures2 != nullptr && HasExtension(properties, VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME) &&
+		HasExtension(properties, VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME))
+	{
+		graphicsPipelineLibraryFeatures_ = {};
+		graphicsPipelineLibraryFeatures_.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT;
+
+		VkPhysicalDeviceFeatures2KHR features = {};
+		features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+		features.pNext = &graphicsPipelineLibraryFeatures_;
+		getFeatures2(static_cast<VkPhysicalDevice>(physicalDevice), &features);
+
+		if (graphicsPipelineLibraryFeatures_.graphicsPipelineLibrary == VK_TRUE)
+		{
+			extensionNames_.push_back(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+			extensionNames_.push_back(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+			IsGraphicsPipelineLibrarySupported = true;
+		}
+	}
+#endif
+
+#if defined(VK_KHR_synchronization2)
+	if (getFeatures2 != nullptr && HasExtension(properties, VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME))
+	{
+		synchronization2Features_ = {};
+		synchronization2Features_.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR;
+
+		VkPhysicalDeviceFeatures2KHR features = {};
+		features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+		features.pNext = &synchronization2Features_;
+		getFeatures2(static_cast<VkPhysicalDevice>(physicalDevice), &features);
+
+		if (synchronization2Features_.synchronization2 == VK_TRUE)
+		{
+			extensionNames_.push_back(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+			IsSynchronization2Supported = true;
+		}
+	}
+#endif
+
+#if defined(VK_KHR_dynamic_rendering)
+	// dependencies are core in Vulkan 1.2, but they are required as extensions in older versions
+	if (getFeatures2 != nullptr && HasExtension(properties, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME) &&
+		HasExtension(properties, VK_KHR_DEPTH_STENCIL_RESOLVE_EXTENSION_NAME) &&
+		HasExtension(properties, VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME) && HasExtension(properties, VK_KHR_MULTIVIEW_EXTENSION_NAME) &&
+		HasExtension(properties, VK_KHR_MAINTENANCE2_EXTENSION_NAME))
+	{
+		dynamicRenderingFeatures_ = {};
+		dynamicRenderingFeatures_.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+
+		VkPhysicalDeviceFeatures2KHR features = {};
+		features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+		features.pNext = &dynamicRenderingFeatures_;
+		getFeatures2(static_cast<VkPhysicalDevice>(physicalDevice), &features);
+
+		if (dynamicRenderingFeatures_.dynamicRendering == VK_TRUE)
+		{
+			extensionNames_.push_back(VK_KHR_MULTIVIEW_EXTENSION_NAME);
+			extensionNames_.push_back(VK_KHR_MAINTENANCE2_EXTENSION_NAME);
+			extensionNames_.push_back(VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME);
+			extensionNames_.push_back(VK_KHR_DEPTH_STENCIL_RESOLVE_EXTENSION_NAME);
+			extensionNames_.push_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+			IsDynamicRenderingSupported = true;
+		}
+	}
+#endif
+
+#if defined(VK_EXT_multi_draw)
+	if (getFeatures2 != nullptr && getProperties2 != nullptr && HasExtension(properties, VK_EXT_MULTI_DRAW_EXTENSION_NAME))
+	{
+		multiDrawFeatures_ = {};
+		multiDrawFeatures_.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTI_DRAW_FEATURES_EXT;
+
+		VkPhysicalDeviceFeatures2KHR features = {};
+		features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+		features.pNext = &multiDrawFeatures_;
+		getFeatures2(static_cast<VkPhysicalDevice>(physicalDevice), &features);
+
+		VkPhysicalDeviceMultiDrawPropertiesEXT multiDrawProperties = {};
+		multiDrawProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTI_DRAW_PROPERTIES_EXT;
+
+		VkPhysicalDeviceProperties2KHR properties2 = {};
+		properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR;
+		properties2.pNext = &multiDrawProperties;
+		getProperties2(static_cast<VkPhysicalDevice>(physicalDevice), &properties2);
+
+		if (multiDrawFeatures_.multiDraw == VK_TRUE && multiDrawProperties.maxMultiDrawCount > 0)
+		{
+			extensionNames_.push_back(VK_EXT_MULTI_DRAW_EXTENSION_NAME);
+			IsMultiDrawSupported = true;
+			MaxMultiDrawCount = multiDrawProperties.maxMultiDrawCount;
+		}
+	}
+#endif
+}
+
+void* DeviceExtensionsVulkan::GetFeatureChain()
+{
+	void* chain = nullptr;
+
+#if defined(VK_EXT_multi_draw)
+	if (IsMultiDrawSupported)
+	{
+		multiDrawFeatures_.pNext = chain;
+		chain = &multiDrawFeatures_;
+	}
+#endif
+
+#if defined(VK_EXT_descriptor_indexing)
+	if (IsBindlessSupported)
+	{
+		descriptorIndexingFeatures_.pNext = chain;
+		chain = &descriptorIndexingFeatures_;
+	}
+#endif
+
+#if defined(VK_EXT_extended_dynamic_state)
+	if (IsExtendedDynamicStateSupported)
+	{
+		extendedDynamicStateFeatures_.pNext = chain;
+		chain = &extendedDynamicStateFeatures_;
+	}
+#endif
+
+#if defined(VK_EXT_graphics_pipeline_library)
+	if (IsGraphicsPipelineLibrarySupported)
+	{
+		graphicsPipelineLibraryFeatures_.pNext = chain;
+		chain = &graphicsPipelineLibraryFeatures_;
+	}
+#endif
+
+#if defined(VK_KHR_synchronization2)
+	if (IsSynchronization2Supported)
+	{
+		synchronization2Features_.pNext = chain;
+		chain = &synchronization2Features_;
+	}
+#endif
+
+#if defined(VK_KHR_dynamic_rendering)
+	if (IsDynamicRenderingSupported)
+	{
+		dynamicRenderingFeatures_.pNext = chain;
+		chain = &dynamicRenderingFeatures_;
+	}
+#endif
+
+	return chain;
+}
+
+void DeviceExtensionsVulkan::Load(vk::Device device)
+{
+#if defined(VK_KHR_draw_indirect_count)
+	if (IsDrawIndirectCountSupported)
+	{
+		CmdDrawIndirectCount = (PFN_vkCmdDrawIndirectCountKHR)device.getProcAddr("vkCmdDrawIndirectCountKHR");
+		CmdDrawIndexedIndirectCount = (PFN_vkCmdDrawIndexedIndirectCountKHR)device.getProcAddr("vkCmdDrawIndexedIndirectCountKHR");
+		IsDrawIndirectCountSupported = CmdDrawIndirectCount != nullptr && CmdDrawIndexedIndirectCount != nullptr;
+	}
+#endif
+
+#if defined(VK_EXT_multi_draw)
+	if (IsMultiDrawSupported)
+	{
+		CmdDrawMultiIndexed = (PFN_vkCmdDrawMultiIndexedEXT)device.getProcAddr("vkCmdDrawMultiIndexedEXT");
+		IsMultiDrawSupported = CmdDrawMultiIndexed != nullptr;
+	}
+#endif
+
+#if defined(VK_KHR_descriptor_update_template)
+	if (IsDescriptorUpdateTemplateSupported)
+	{
+		CreateDescriptorUpdateTemplate =
+			(PFN_vkCreateDescriptorUpdateTemplateKHR)device.getProcAddr("vkCreateDescriptorUpdateTemplateKHR");
+		DestroyDescriptorUpdateTemplate =
+			(PFN_vkDestroyDescriptorUpdateTemplateKHR)device.getProcAddr("vkDestroyDescriptorUpdateTemplateKHR");
+		UpdateDescriptorSetWithTemplate =
+			(PFN_vkUpdateDescriptorSetWithTemplateKHR)device.getProcAddr("vkUpdateDescriptorSetWithTemplateKHR");
+		IsDescriptorUpdateTemplateSupported = CreateDescriptorUpdateTemplate != nullptr && DestroyDescriptorUpdateTemplate != nullptr &&
+											  UpdateDescriptorSetWithTemplate != nullptr;
+	}
+#endif
+
+#if defined(VK_KHR_push_descriptor)
+	if (IsPushDescriptorSupported)
+	{
+		CmdPushDescriptorSet = (PFN_vkCmdPushDescriptorSetKHR)device.getProcAddr("vkCmdPushDescriptorSetKHR");
+		IsPushDescriptorSupported = CmdPushDescriptorSet != nullptr;
+	}
+#endif
+
+#if defined(VK_KHR_synchronization2)
+	if (IsSynchronization2Supported)
+	{
+		CmdPipelineBarrier2 = (PFN_vkCmdPipelineBarrier2KHR)device.getProcAddr("vkCmdPipelineBarrier2KHR");
+		IsSynchronization2Supported = CmdPipelineBarrier2 != nullptr;
+	}
+#endif
+
+#if defined(VK_KHR_dynamic_rendering)
+	if (IsDynamicRenderingSupported)
+	{
+		CmdBeginRendering = (PFN_vkCmdBeginRenderingKHR)device.getProcAddr("vkCmdBeginRenderingKHR");
+		CmdEndRendering = (PFN_vkCmdEndRenderingKHR)device.getProcAddr("vkCmdEndRenderingKHR");
+		IsDynamicRenderingSupported = CmdBeginRendering != nullptr && CmdEndRendering != nullptr;
+	}
+#endif
+
+#if defined(VK_EXT_extended_dynamic_state)
+	if (IsExtendedDynamicStateSupported)
+	{
+		CmdSetCullMode = (PFN_vkCmdSetCullModeEXT)device.getProcAddr("vkCmdSetCullModeEXT");
+		CmdSetPrimitiveTopology = (PFN_vkCmdSetPrimitiveTopologyEXT)device.getProcAddr("vkCmdSetPrimitiveTopologyEXT");
+		CmdSetDepthTestEnable = (PFN_vkCmdSetDepthTestEnableEXT)device.getProcAddr("vkCmdSetDepthTestEnableEXT");
+		CmdSetDepthWriteEnable = (PFN_vkCmdSetDepthWriteEnableEXT)device.getProcAddr("vkCmdSetDepthWriteEnableEXT");
+		CmdSetDepthCompareOp = (PFN_vkCmdSetDepthCompareOpEXT)device.getProcAddr("vkCmdSetDepthCompareOpEXT");
+		CmdSetStencilTestEnable = (PFN_vkCmdSetStencilTestEnableEXT)device.getProcAddr("vkCmdSetStencilTestEnableEXT");
+		IsExtendedDynamicStateSupported = CmdSetCullMode != nullptr && CmdSetPrimitiveTopology != nullptr &&
+										  CmdSetDepthTestEnable != nullptr && CmdSetDepthWriteEnable != nullptr &&
+										  CmdSetDepthCompareOp != nullptr && CmdSetStencilTestEnable != nullptr;
+	}
+#endif
+}
+
+} // namespace LLGI
@@ -0,0 +1,131 @@
+
+#pragma once
+
+#include "LLGI.BaseVulkan.h"
+
+namespace LLGI
+{
+
+/**
+	@brief	optional device extensions which are enabled if a physical device supports them
+	@note
+	Select must be called before creating a device and Load must be called after creating it.
+	Functions of extensions are nullptr if they are not supported.
+*/
+class DeviceExtensionsVulkan
+{
+private:
+	std::vector<const char*> extensionNames_;
+
+#if defined(VK_EXT_multi_draw)
+	VkPhysicalDeviceMultiDrawFeaturesEXT multiDrawFeatures_ = {};
+#endif
+
+#if defined(VK_EXT_descriptor_indexing)
+	VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptorIndexingFeatures_ = {};
+#endif
+
+#if defined(VK_EXT_extended_dynamic_state)
+	VkPhysicalDeviceExtendedDynamicStateFeaturesEXT extendedDynamicStateFeatures_ = {};
+#endif
+
+#if defined(VK_EXT_graphics_pipeline_library)
+	VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT graphicsPipelineLibraryFeatures_ = {};
+#endif
+
+#if defined(VK_KHR_synchronization2)
+	VkPhysicalDeviceSynchronization2FeaturesKHR synchronization2Features_ = {};
+#endif
+
+#if defined(VK_KHR_dynamic_rendering)
+	VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures_ = {};
+#endif
+
+	bool HasExtension(const std::vector<vk::ExtensionProperties>& properties, const char* name) const;
+
+public:
+	bool IsDrawIndirectCountSupported = false;
+	bool IsMultiDrawSupported = false;
+	uint32_t MaxMultiDrawCount = 0;
+	bool IsPushDescriptorSupported = false;
+	bool IsDescriptorUpdateTemplateSupported = false;
+
+	//! culling, a topology and depth stencil states are set per draw with VK_EXT_extended_dynamic_state
+	bool IsExtendedDynamicStateSupported = false;
+
+	//! pipelines are linked from precompiled parts with VK_EXT_graphics_pipeline_library
+	bool IsGraphicsPipelineLibrarySupported = false;
+
+	//! barriers have stages and accesses for each image with VK_KHR_synchronization2
+	bool IsSynchronization2Supported = false;
+
+	//! render passes without subpasses are begun without render pass and framebuffer objects with VK_KHR_dynamic_rendering
+	bool IsDynamicRenderingSupported = false;
+
+	//! a bindless texture mode with VK_EXT_descriptor_indexing. It is enabled only if it is requested.
+	bool IsBindlessSupported = false;
+	int32_t MaxBindlessTextureCount = 0;
+
+#if defined(VK_KHR_draw_indirect_count)
+	PFN_vkCmdDrawIndirectCountKHR CmdDrawIndirectCount = nullptr;
+	PFN_vkCmdDrawIndexedIndirectCountKHR CmdDrawIndexedIndirectCount = nullptr;
+#endif
+
+#if defined(VK_EXT_multi_draw)
+	PFN_vkCmdDrawMultiIndexedEXT CmdDrawMultiIndexed = nullptr;
+#endif
+
+#if defined(VK_KHR_push_descriptor)
+	PFN_vkCmdPushDescriptorSetKHR CmdPushDescriptorSet = nullptr;
+#endif
+
+#if defined(VK_KHR_descriptor_update_template)
+	PFN_vkCreateDescriptorUpdateTemplateKHR CreateDescriptorUpdateTemplate = nullptr;
+	PFN_vkDestroyDescriptorUpdateTemplateKHR DestroyDescriptorUpdateTemplate = nullptr;
+	PFN_vkUpdateDescriptorSetWithTemplateKHR UpdateDescriptorSetWithTemplate = nullptr;
+#endif
+
+#if defined(VK_EXT_extended_dynamic_state)
+	PFN_vkCmdSetCullModeEXT CmdSetCullMode = nullptr;
+	PFN_vkCmdSetPrimitiveTopologyEXT CmdSetPrimitiveTopology = nullptr;
+	PFN_vkCmdSetDepthTestEnableEXT CmdSetDepthTestEnable = nullptr;
+	PFN_vkCmdSetDepthWriteEnableEXT CmdSetDepthWriteEnable = nullptr;
+	PFN_vkCmdSetDepthCompareOpEXT CmdSetDepthCompareOp = nullptr;
+	PFN_vkCmdSetStencilTestEnableEXT CmdSetStencilTestEnable = nullptr;
+#endif
+
+#if defined(VK_KHR_synchronization2)
+	PFN_vkCmdPipelineBarrier2KHR CmdPipelineBarrier2 = nullptr;
+#endif
+
+#if defined(VK_KHR_dynamic_rendering)
+	PFN_vkCmdBeginRenderingKHR CmdBeginRendering = nullptr;
+	PFN_vkCmdEndRenderingKHR CmdEndRendering = nullptr;
+#endif
+
+	/**
+		@brief	get instance extensions which are required to query device extensions
+	*/
+	static std::vector<const char*> GetInstanceExtensionNames();
+
+	/**
+		@brief	select supported extensions of a physical device
+	*/
+	void Select(vk::Instance instance, vk::PhysicalDevice physicalDevice, bool isBindlessRequested = false);
+
+	const std::vector<const char*>& GetExtensionNames() const { return extensionNames_; }
+
+	/**
+		@brief	get a chain of feature structures which is specified to pNext of VkDeviceCreateInfo
+		@note
+		The chain refers members of this instance.
+	*/
+	void* GetFeatureChain();
+
+	/**
+		@brief	load functions of selected extensions
+	*/
+	void Load(vk::Device device);
+};
+
+} // namespace LLGI
@@ -0,0 +1,87 @@
+#include "LLGI.FramebufferCacheVulkan.h"
+
+namespace LLGI
+{
+
+FramebufferCacheVulkan::FramebufferCacheVulkan(vk::Device device, ReferenceObject* owner) : device_(device), owner_(owner)
+{
+	SafeAddRef(owner_);
+}
+
+FramebufferCacheVulkan::~FramebufferCacheVulkan()
+{
+	for (auto& framebuffer : framebuffers_)
+	{
+		device_.destroyFramebuffer(framebuffer.second);
+	}
+	framebuffers_.clear();
+
+	SafeRelease(owner_);
+}
+
+vk::Framebuffer FramebufferCacheVulkan::Get(vk::RenderPass renderPass,
+											const Views& views,
+											const Vec2I& size,
+											const FixedSizeVector<SubpassParameter, SubpassMax>& subpasses)
+{
+	Key key;
+	key.ImageViews = views;
+	key.Size = size;
+	key.Subpasses = subpasses;
+
+	std::lock_guard<std::mutex> lock(mtx_);
+
+	auto it = framebuffers_.find(key);
+	if (it != framebuffers_.end())
+	{
+		return it->second;
+	}
+
+	vk::FramebufferCreateInfo framebufferCreateInfo;
+	framebufferCreateInfo.renderPass = renderPass;
+	framebufferCreateInfo.attachmentCount = static_cast<uint32_t>(views.size());
+	framebufferCreateInfo.pAttachments = reinterpret_cast<const vk::ImageView*>(views.data());
+	framebufferCreateInfo.width = size.X;
+	framebufferCreateInfo.height = size.Y;
+	framebufferCreateInfo.layers = 1;
+
+	auto framebuffer = device_.createFramebuffer(framebufferCreateInfo);
+	framebuffers_[key] = framebuffer;
+	return framebuffer;
+}
+
+void FramebufferCacheVulkan::Remove(VkImageView view)
+{
+	std::lock_guard<std::mutex> lock(mtx_);
+
+	for (auto it = framebuffers_.begin(); it != framebuffers_.end();)
+	{
+		bool isUsed = false;
+		for (size_t i = 0; i < it->first.ImageViews.size(); i++)
+		{
+			if (it->first.ImageViews.at(i) == view)
+			{
+				isUsed = true;
+				break;
+			}
+		}
+
+		if (isUsed)
+		{
+			device_.destroyFramebuffer(it->second);
+			it = framebuffers_.erase(it);
+		}
+		else
+		{
+			it++;
+		}
+	}
+}
+
+int32_t FramebufferCacheVulkan::GetCount()
+{
+	std::lock_guard<std::mutex> lock(mtx_);
+	return static_cast<int32_t>(framebuffers_.size());
+}
+
+} // namespace LLGI
@@ -0,0 +1,78 @@
+
+#pragma once
+
+#include "../LLGI.Graphics.h"
+#include "../Utils/LLGI.FixedSizeVector.h"
+#include "LLGI.BaseVulkan.h"
+#include <mutex>
+#include <unordered_map>
+
+namespace LLGI
+{
+
+/**
+	@brief	framebuffers which are shared by render passes which have the same attachments
+	@note
+	A framebuffer is compatible with render passes which have the same formats of attachments and the same subpasses.
+	Formats are decided by views, so framebuffers are keyed by views, a size and subpasses.
+	Framebuffers which use a view are destroyed when a texture which has the view is destroyed.
+	It is thread safe.
+*/
+class FramebufferCacheVulkan : public ReferenceObject
+{
+public:
+	//! multisampled colors, a depth and resolved colors
+	typedef FixedSizeVector<VkImageView, RenderTargetMax * 2 + 1> Views;
+
+private:
+	struct Key
+	{
+		Views ImageViews;
+		Vec2I Size;
+		FixedSizeVector<SubpassParameter, SubpassMax> Subpasses;
+
+		bool operator==(const Key& value) const
+		{
+			return ImageViews == value.ImageViews && Size.X == value.Size.X && Size.Y == value.Size.Y && Subpasses == value.Subpasses;
+		}
+
+		struct Hash
+		{
+			typedef std::size_t result_type;
+
+			std::size_t operator()(const Key& key) const
+			{
+				// subpasses are rarely different among framebuffers which have the same views
+				return key.ImageViews.get_hash() + std::hash<int32_t>()(key.Size.X) + std::hash<int32_t>()(key.Size.Y) +
+					   key.Subpasses.size();
+			}
+		};
+	};
+
+	vk::Device device_;
+	ReferenceObject* owner_ = nullptr;
+
+	std::mutex mtx_;
+	std::unordered_map<Key, vk::Framebuffer, Key::Hash> framebuffers_;
+
+public:
+	FramebufferCacheVulkan(vk::Device device, ReferenceObject* owner);
+	virtual ~FramebufferCacheVulkan();
+
+	/**
+		@brief	get a framebuffer or create it with a render pass
+	*/
+	vk::Framebuffer Get(vk::RenderPass renderPass,
+						const Views& views,
+						const Vec2I& size,
+						const FixedSizeVector<SubpassParameter, SubpassMax>& subpasses);
+
+	/**
+		@brief	destroy framebuffers which use a view
+	*/
+	void Remove(VkImageView view);
+
+	int32_t GetCount();
+};
+
+} // namespace LLGI
@@ -2,12 +2,18 @@
 #include "LLGI.BaseVulkan.h"
 #include "LLGI.CommandListVulkan.h"
 #include "LLGI.ConstantBufferVulkan.h"
+#include "LLGI.FramebufferCacheVulkan.h"
 #include "LLGI.IndexBufferVulkan.h"
+#include "LLGI.ImageBarrierBatchVulkan.h"
+#include "LLGI.IndirectBufferVulkan.h"
 #include "LLGI.PipelineStateVulkan.h"
+#include "../Utils/LLGI.Hash.h"
+#include "LLGI.ShaderPackVulkan.h"
 #include "LLGI.ShaderVulkan.h"
 #include "LLGI.SingleFrameMemoryPoolVulkan.h"
 #include "LLGI.TextureVulkan.h"
 #include "LLGI.VertexBufferVulkan.h"
+#include <algorithm>
 
 namespace LLGI
 {
@@ -19,7 +25,8 @@ GraphicsVulkan::GraphicsVulkan(const vk::Device& device,
 							   int32_t swapBufferCount,
 							   std::function<void(vk::CommandBuffer, vk::Fence)> addCommand,
 							   RenderPassPipelineStateCacheVulkan* renderPassPipelineStateCache,
-							   ReferenceObject* owner)
+							   ReferenceObject* owner,
+							   const DeviceExtensionsVulkan& deviceExtensions)
 	: vkDevice(device)
 	, vkQueue(quque)
 	, vkCmdPool(commandPool)
@@ -27,6 +34,7 @@ GraphicsVulkan::GraphicsVulkan(const vk::Device& device,
 	, addCommand_(addCommand)
 	, renderPassPipelineStateCache_(renderPassPipelineStateCache)
 	, owner_(owner)
+	, deviceExtensions_(deviceExtensions)
 {
 	SafeAddRef(owner_);
 
@@ -51,16 +59,57 @@ GraphicsVulkan::GraphicsVulkan(const vk::Device& device,
 
 	defaultSampler_ = vkDevice.createSampler(samplerInfo);
 
+	pipelineCache_ = vkDevice.createPipelineCache(vk::PipelineCacheCreateInfo());
+
+	if (deviceExtensions_.IsGraphicsPipelineLibrarySupported)
+	{
+		// leave most cores to threads which record commands and compile pipelines
+		auto workerCount = std::min(std::max(std::thread::hardware_concurrency() / 4, 1u), 4u);
+		pipelineLinkQueue_.reset(new TaskQueueVulkan(static_cast<int32_t>(workerCount)));
+	}
+
+	if (deviceExtensions_.IsBindlessSupported)
+	{
+		bindlessTextureTable_ = std::make_shared<BindlessTextureTableVulkan>();
+		if (!bindlessTextureTable_->Initialize(vkDevice, deviceExtensions_.MaxBindlessTextureCount))
+		{
+			Log(LogType::Warning, "Failed to create a bindless texture table.");
+			bindlessTextureTable_.reset();
+		}
+	}
+
 	SafeAddRef(renderPassPipelineStateCache_);
 	if (renderPassPipelineStateCache_ == nullptr)
 	{
-		renderPassPipelineStateCache_ = new RenderPassPipelineStateCacheVulkan(device, nullptr);
+		renderPassPipelineStateCache_ =
+			new RenderPassPipelineStateCacheVulkan(device, nullptr, deviceExtensions_.IsDynamicRenderingSupported);
 	}
+
+	framebufferCache_ = new FramebufferCacheVulkan(device, owner_);
 }
 
 GraphicsVulkan::~GraphicsVulkan()
 {
+	// workers use a pipeline cache
+	pipelineLinkQueue_.reset();
+
+	SafeRelease(pipelineManifest_);
 	SafeRelease(renderPassPipelineStateCache_);
+	SafeRelease(framebufferCache_);
+
+	// helpers which own objects of the device must be destroyed before the owner destroys the device
+	bindlessTextureTable_.reset();
+
+	for (auto& layout : descriptorSetLayouts_)
+	{
+		vkDevice.destroyDescriptorSetLayout(layout.second);
+	}
+	descriptorSetLayouts_.clear();
+
+	if (pipelineCache_)
+	{
+		vkDevice.destroyPipelineCache(pipelineCache_);
+	}
 
 	if (defaultSampler_)
 	{
@@ -106,10 +155,78 @@ IndexBuffer* GraphicsVulkan::CreateIndexBuffer(int32_t stride, int32_t count)
 	return obj;
 }
 
+IndirectBuffer* GraphicsVulkan::CreateIndirectBuffer(int32_t size)
+{
+	auto obj = new IndirectBufferVulkan();
+	if (!obj->Initialize(this, size))
+	{
+		SafeRelease(obj);
+		return nullptr;
+	}
+
+	return obj;
+}
+
 Shader* GraphicsVulkan::CreateShader(DataStructure* data, int32_t count)
 {
+	if (count != 1)
+		return nullptr;
+	if (data[0].Size == 0)
+		return nullptr;
+
+	// a code must be aligned to 4 bytes
+	if (reinterpret_cast<uintptr_t>(data[0].Data) % sizeof(uint32_t) == 0)
+	{
+		return CreateShader(
+			data[0].Data, data[0].Size, CalculateFNV1a64(data[0].Data, data[0].Size), CalculateMurmur64(data[0].Data, data[0].Size));
+	}
+
+	std::vector<uint32_t> buffer((data[0].Size + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+	memcpy(buffer.data(), data[0].Data, data[0].Size);
+	return CreateShader(
+		buffer.data(), data[0].Size, CalculateFNV1a64(buffer.data(), data[0].Size), CalculateMurmur64(buffer.data(), data[0].Size));
+}
+
+ShaderVulkan* GraphicsVulkan::CreateShader(const void* code, size_t size, uint64_t hash, uint64_t contentHash)
+{
+	std::lock_guard<std::mutex> lock(shaderMtx_);
+
+	// a shader whose reference count reached zero is being destroyed and is not reused.
+	// two independent hashes and a size confirm the same binary without keeping a copy of it
+	auto it = shaders_.find(hash);
+	if (it != shaders_.end() && it->second->GetContentHash() == contentHash && it->second->GetSize() == size &&
+		it->second->TryAddRef())
+	{
+		return it->second;
+	}
+
 	auto obj = new ShaderVulkan();
-	if (!obj->Initialize(this, data, count))
+	if (!obj->Initialize(this, code, size, hash, contentHash))
+	{
+		SafeRelease(obj);
+		return nullptr;
+	}
+
+	shaders_[hash] = obj;
+	return obj;
+}
+
+void GraphicsVulkan::RemoveShader(ShaderVulkan* shader)
+{
+	std::lock_guard<std::mutex> lock(shaderMtx_);
+
+	// the entry may already be replaced by a new shader
+	auto it = shaders_.find(shader->GetHash());
+	if (it != shaders_.end() && it->second == shader)
+	{
+		shaders_.erase(it);
+	}
+}
+
+ShaderPackVulkan* GraphicsVulkan::CreateShaderPack(const char* path)
+{
+	auto obj = new ShaderPackVulkan();
+	if (!obj->Initialize(this, path))
 	{
 		SafeRelease(obj);
 		return nullptr;
@@ -174,7 +291,7 @@ RenderPass* GraphicsVulkan::CreateRenderPass(const Texture** textures, int32_t t
 	auto dt = static_cast<TextureVulkan*>(depthTexture);
 
 	auto renderPass = new RenderPassVulkan(renderPassPipelineStateCache_, GetDevice(), this);
-	if (!renderPass->Initialize((const TextureVulkan**)textures, textureCount, dt))
+	if (!renderPass->Initialize((const TextureVulkan**)textures, textureCount, dt, framebufferCache_))
 	{
 		SafeRelease(renderPass);
 	}
@@ -237,7 +354,12 @@ Texture* GraphicsVulkan::CreateDepthTexture(const DepthTextureInitializationPara
 {
 	auto obj = new TextureVulkan();
 
-	if (!obj->InitializeAsDepthStencil( this->vkDevice, this->vkPysicalDevice, parameter.Size, this))
+	if (!obj->InitializeAsDepthStencil(this->vkDevice,
+									   this->vkPysicalDevice,
+									   parameter.Size,
+									   this,
+									   parameter.IsTransient,
+									   parameter.IsMultiSampling ? parameter.SamplingCount : 1))
 	{
 		SafeRelease(obj);
 		return nullptr;
@@ -246,6 +368,109 @@ Texture* GraphicsVulkan::CreateDepthTexture(const DepthTextureInitializationPara
 	return obj;
 }
 
+bool GraphicsVulkan::CreateTransientTextures(const TransientTextureParameter* parameters, int32_t count, Texture** textures)
+{
+	std::vector<TextureVulkan*> created(count, nullptr);
+	std::vector<vk::MemoryRequirements> requirements(count);
+	uint32_t memoryTypeBits = UINT32_MAX;
+
+	auto releaseCreated = [&created]() -> void {
+		for (auto& texture : created)
+		{
+			SafeRelease(texture);
+		}
+	};
+
+	for (int32_t i = 0; i < count; i++)
+	{
+		created[i] = new TextureVulkan();
+		if (!created[i]->InitializeAsTransient(this, parameters[i].Size, parameters[i].Format, parameters[i].IsDepth))
+		{
+			releaseCreated();
+			return false;
+		}
+
+		requirements[i] = created[i]->GetMemoryRequirements();
+		memoryTypeBits &= requirements[i].memoryTypeBits;
+	}
+
+	// textures can't share memory
+	if (memoryTypeBits == 0)
+	{
+		releaseCreated();
+		return Graphics::CreateTransientTextures(parameters, count, textures);
+	}
+
+	// place large textures at first
+	std::vector<int32_t> order(count);
+	for (int32_t i = 0; i < count; i++)
+	{
+		order[i] = i;
+	}
+
+	std::sort(order.begin(), order.end(), [&requirements](int32_t a, int32_t b) { return requirements[a].size > requirements[b].size; });
+
+	std::vector<vk::DeviceSize> offsets(count, 0);
+	std::vector<int32_t> placed;
+	vk::DeviceSize memorySize = 0;
+
+	for (auto index : order)
+	{
+		const auto& requirement = requirements[index];
+		vk::DeviceSize offset = 0;
+
+		// move the offset after textures which are used at the same time until there is no overlap
+		bool isMoved = true;
+		while (isMoved)
+		{
+			isMoved = false;
+			for (auto other : placed)
+			{
+				if (parameters[other].LastPass < parameters[index].FirstPass || parameters[index].LastPass < parameters[other].FirstPass)
+					continue;
+
+				if (offsets[other] + requirements[other].size <= offset || offset + requirement.size <= offsets[other])
+					continue;
+
+				auto end = offsets[other] + requirements[other].size;
+				offset = (end + requirement.alignment - 1) / requirement.alignment * requirement.alignment;
+				isMoved = true;
+			}
+		}
+
+		offsets[index] = offset;
+		placed.push_back(index);
+		if (memorySize < offset + requirement.size)
+		{
+			memorySize = offset + requirement.size;
+		}
+	}
+
+	vk::MemoryAllocateInfo memAlloc;
+	memAlloc.allocationSize = memorySize;
+	memAlloc.memoryTypeIndex = GetMemoryTypeIndex(memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
+	auto memory = new DeviceMemoryVulkan(vkDevice, vkDevice.allocateMemory(memAlloc));
+
+	for (int32_t i = 0; i < count; i++)
+	{
+		if (!created[i]->BindMemory(memory, offsets[i]))
+		{
+			SafeRelease(memory);
+			releaseCreated();
+			return false;
+		}
+	}
+
+	SafeRelease(memory);
+
+	for (int32_t i = 0; i < count; i++)
+	{
+		textures[i] = created[i];
+	}
+
+	return true;
+}
+
 std::vector<uint8_t> GraphicsVulkan::CaptureRenderTarget(Texture* renderTarget)
 {
 	if (!renderTarget)
@@ -273,28 +498,11 @@ std::vector<uint8_t> GraphicsVulkan::CaptureRenderTarget(Texture* renderTarget)
 	{
 		VkCommandBuffer commandBuffer = BeginSingleTimeCommands();
 
-		// Swapchain image (VK_IMAGE_LAYOUT_PRESENT_SRC_KHR) -> copy source (VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL)
-		{
-			VkImageMemoryBarrier imageMemoryBarrier = {};
-			imageMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-			imageMemoryBarrier.pNext = nullptr;
-			imageMemoryBarrier.srcAccessMask = VK_ACCESS_MEMORY_READ_BIT;
-			imageMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-			imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-			imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-			imageMemoryBarrier.image = image;
-			imageMemoryBarrier.subresourceRange = VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
-			vkCmdPipelineBarrier(commandBuffer,
-								 VK_PIPELINE_STAGE_TRANSFER_BIT,
-								 VK_PIPELINE_STAGE_TRANSFER_BIT,
-								 0,
-								 0,
-								 nullptr,
-								 0,
-								 nullptr,
-								 1,
-								 &imageMemoryBarrier);
-		}
+		// a layout is decided from a tracked state because the target is not only a swapchain image
+		auto previousLayout = texture->GetImageLayout();
+		ImageBarrierBatchVulkan barrierBatch;
+		barrierBatch.Transition(texture, ImageStateVulkan::FromLayout(vk::ImageLayout::eTransferSrcOptimal));
+		barrierBatch.Flush(vk::CommandBuffer(commandBuffer), &deviceExtensions_);
 
 		// Copy to destBuffer
 		{
@@ -312,26 +520,10 @@ std::vector<uint8_t> GraphicsVulkan::CaptureRenderTarget(Texture* renderTarget)
 		}
 
 		// Undo layout
+		if (previousLayout != vk::ImageLayout::eUndefined)
 		{
-			VkImageMemoryBarrier imageMemoryBarrier = {};
-			imageMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-			imageMemoryBarrier.pNext = nullptr;
-			imageMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-			imageMemoryBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
-			imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-			imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-			imageMemoryBarrier.image = image;
-			imageMemoryBarrier.subresourceRange = VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
-			vkCmdPipelineBarrier(commandBuffer,
-								 VK_PIPELINE_STAGE_TRANSFER_BIT,
-								 VK_PIPELINE_STAGE_TRANSFER_BIT,
-								 0,
-								 0,
-								 nullptr,
-								 0,
-								 nullptr,
-								 1,
-								 &imageMemoryBarrier);
+			barrierBatch.Transition(texture, ImageStateVulkan::FromLayout(previousLayout));
+			barrierBatch.Flush(vk::CommandBuffer(commandBuffer), &deviceExtensions_);
 		}
 
 		// Submit and Wait
@@ -375,7 +567,71 @@ RenderPassPipelineState* GraphicsVulkan::CreateRenderPassPipelineState(const Ren
 		renderTargets.at(i) = (vk::Format)VulkanHelper::TextureFormatToVkFormat(key.RenderTargetFormats.at(i));
 	}
 
-	return renderPassPipelineStateCache_->Create(key.IsPresent, key.HasDepth, renderTargets, key.IsColorCleared, key.IsDepthCleared);
+	return renderPassPipelineStateCache_->Create(
+		key.IsPresent, key.HasDepth, renderTargets, key.IsColorCleared, key.IsDepthCleared, key.SamplingCount);
+}
+
+void GraphicsVulkan::SetPipelineManifest(PipelineManifestVulkan* manifest) { SafeAssign(pipelineManifest_, manifest); }
+
+vk::DescriptorSetLayout GraphicsVulkan::GetDescriptorSetLayout(int32_t bindingMask, bool isPushDescriptor, int32_t inputAttachmentMask)
+{
+	auto key = bindingMask | (isPushDescriptor ? PipelineStateVulkan::BindingMaskCount : 0) |
+			   (inputAttachmentMask * PipelineStateVulkan::BindingMaskCount * 2);
+
+	std::lock_guard<std::mutex> lock(descriptorSetLayoutMtx_);
+
+	auto it = descriptorSetLayouts_.find(key);
+	if (it != descriptorSetLayouts_.end())
+	{
+		return it->second;
+	}
+
+	std::array<vk::DescriptorSetLayoutBinding, PipelineStateVulkan::TextureBindingCount + 1> bindings;
+	uint32_t bindingCount = 0;
+
+	for (int32_t i = 0; i < PipelineStateVulkan::TextureBindingCount + 1; i++)
+	{
+		if ((bindingMask & (1 << i)) == 0)
+			continue;
+
+		auto& binding = bindings[bindingCount];
+		binding.binding = i;
+		binding.descriptorCount = 1;
+		binding.stageFlags = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
+		binding.pImmutableSamplers = nullptr;
+
+		if (i == 0)
+		{
+			// dynamic buffers are not allowed in push descriptors
+			binding.descriptorType = isPushDescriptor ? vk::DescriptorType::eUniformBuffer : vk::DescriptorType::eUniformBufferDynamic;
+		}
+		else if ((inputAttachmentMask & (1 << i)) != 0)
+		{
+			binding.descriptorType = vk::DescriptorType::eInputAttachment;
+			binding.stageFlags = vk::ShaderStageFlagBits::eFragment;
+		}
+		else
+		{
+			binding.descriptorType = vk::DescriptorType::eCombinedImageSampler;
+		}
+
+		bindingCount++;
+	}
+
+	vk::DescriptorSetLayoutCreateInfo info;
+	info.bindingCount = bindingCount;
+	info.pBindings = bindings.data();
+
+#if defined(VK_KHR_push_descriptor)
+	if (isPushDescriptor)
+	{
+		info.flags = vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR;
+	}
+#endif
+
+	auto layout = vkDevice.createDescriptorSetLayout(info);
+	descriptorSetLayouts_[key] = layout;
+	return layout;
 }
 
 int32_t GraphicsVulkan::GetSwapBufferCount() const { return swapBufferCount_; }
@@ -2,9 +2,14 @@
 
 #include "../LLGI.Graphics.h"
 #include "LLGI.BaseVulkan.h"
+#include "LLGI.BindlessTextureTableVulkan.h"
+#include "LLGI.DeviceExtensionsVulkan.h"
+#include "LLGI.PipelineManifestVulkan.h"
 #include "LLGI.RenderPassPipelineStateCacheVulkan.h"
 #include "LLGI.RenderPassVulkan.h"
+#include "LLGI.TaskQueueVulkan.h"
 #include <functional>
+#include <mutex>
 #include <unordered_map>
 
 namespace LLGI
@@ -13,6 +18,9 @@ namespace LLGI
 class RenderPassVulkan;
 class RenderPassPipelineStateVulkan;
 class TextureVulkan;
+class FramebufferCacheVulkan;
+class ShaderPackVulkan;
+class ShaderVulkan;
 
 class GraphicsVulkan : public Graphics
 {
@@ -28,7 +36,22 @@ private:
 
 	std::function<void(vk::CommandBuffer, vk::Fence)> addCommand_;
 	RenderPassPipelineStateCacheVulkan* renderPassPipelineStateCache_ = nullptr;
+	FramebufferCacheVulkan* framebufferCache_ = nullptr;
 	ReferenceObject* owner_ = nullptr;
+	DeviceExtensionsVulkan deviceExtensions_;
+	std::shared_ptr<BindlessTextureTableVulkan> bindlessTextureTable_;
+	vk::PipelineCache pipelineCache_;
+	PipelineManifestVulkan* pipelineManifest_ = nullptr;
+
+	//! workers which link optimized pipelines in background. it is created only with VK_EXT_graphics_pipeline_library
+	std::unique_ptr<TaskQueueVulkan> pipelineLinkQueue_;
+
+	std::mutex descriptorSetLayoutMtx_;
+	std::unordered_map<int32_t, vk::DescriptorSetLayout> descriptorSetLayouts_;
+
+	//! shaders which are alive, keyed by hashes of binaries. they are not referenced
+	std::mutex shaderMtx_;
+	std::unordered_map<uint64_t, ShaderVulkan*> shaders_;
 
 public:
 	GraphicsVulkan(const vk::Device& device,
@@ -38,7 +61,8 @@ public:
 				   int32_t swapBufferCount,
 				   std::function<void(vk::CommandBuffer,vk::Fence)> addCommand,
 				   RenderPassPipelineStateCacheVulkan* renderPassPipelineStateCache = nullptr,
-				   ReferenceObject* owner = nullptr);
+				   ReferenceObject* owner = nullptr,
+				   const DeviceExtensionsVulkan& deviceExtensions = DeviceExtensionsVulkan());
 
 	virtual ~GraphicsVulkan();
 
@@ -50,17 +74,55 @@ public:
 
 	VertexBuffer* CreateVertexBuffer(int32_t size) override;
 	IndexBuffer* CreateIndexBuffer(int32_t stride, int32_t count) override;
+	IndirectBuffer* CreateIndirectBuffer(int32_t size) override;
+	/**
+		@brief	create a shader
+		@note
+		A shader which has the same binary as a living shader is shared, so pipelines keyed by shaders are also shared.
+	*/
 	Shader* CreateShader(DataStructure* data, int32_t count) override;
+
+	/**
+		@brief	create a shader from a binary which is aligned to 4 bytes, or get the living shader which has the same binary
+		@param	hash	CalculateFNV1a64 of the binary
+		@param	contentHash	CalculateMurmur64 of the binary
+		@note
+		A binary is not referred after this function returns.
+	*/
+	ShaderVulkan* CreateShader(const void* code, size_t size, uint64_t hash, uint64_t contentHash);
+
+	//! called when a shader is destroyed
+	void RemoveShader(ShaderVulkan* shader);
+
+
+	/**
+		@brief	open a pack of shaders which is written by WriteShaderPack
+		@note
+		Shaders are created when they are requested, so unused shaders don't consume memory.
+	*/
+	ShaderPackVulkan* CreateShaderPack(const char* path);
 	PipelineState* CreatePiplineState() override;
 	SingleFrameMemoryPool* CreateSingleFrameMemoryPool(int32_t constantBufferPoolSize, int32_t drawingCount) override;
 	CommandList* CreateCommandList(SingleFrameMemoryPool* memoryPool) override;
 	ConstantBuffer* CreateConstantBuffer(int32_t size) override;
+	/**
+		@brief	create a render pass
+		@note
+		A framebuffer is shared among render passes which have the same textures, so it is cheap to create a render pass every frame.
+	*/
 	RenderPass* CreateRenderPass(const Texture** textures, int32_t textureCount, Texture* depthTexture) override;
 
 	Texture* CreateTexture(const TextureInitializationParameter& parameter) override;
 	Texture* CreateRenderTexture(const RenderTextureInitializationParameter& parameter) override;
 	Texture* CreateDepthTexture(const DepthTextureInitializationParameter& parameter) override;
 
+	/**
+		@brief	create textures which are placed in one memory
+		@note
+		A texture is placed at the lowest offset which is not used by textures in the same passes.
+	*/
+	bool CreateTransientTextures(const TransientTextureParameter* parameters, int32_t count, Texture** textures) override;
+
 	Texture* CreateTexture(uint64_t id) override;
 
 	std::vector<uint8_t> CaptureRenderTarget(Texture* renderTarget) override;
@@ -73,6 +135,41 @@ public:
 	vk::Device GetDevice() const { return vkDevice; }
 	vk::CommandPool GetCommandPool() const { return vkCmdPool; }
 	vk::Queue GetQueue() const { return vkQueue; }
+	const DeviceExtensionsVulkan& GetDeviceExtensions() const { return deviceExtensions_; }
+
+	/**
+		@brief	get a global texture table. It is nullptr if a bindless texture mode is not enabled.
+	*/
+	const std::shared_ptr<BindlessTextureTableVulkan>& GetBindlessTextureTable() const { return bindlessTextureTable_; }
+
+	RenderPassPipelineStateCacheVulkan* GetRenderPassPipelineStateCache() const { return renderPassPipelineStateCache_; }
+
+	//! a cache which all pipelines are compiled with
+	vk::PipelineCache GetPipelineCache() const { return pipelineCache_; }
+
+	/**
+		@brief	record pipelines which are compiled into a manifest
+		@note
+		Recording is stopped if nullptr is specified.
+	*/
+	void SetPipelineManifest(PipelineManifestVulkan* manifest);
+
+	PipelineManifestVulkan* GetPipelineManifest() const { return pipelineManifest_; }
+
+	/**
+		@brief	get a queue which links optimized pipelines in background
+		@note
+		The number of workers is bounded, so pipelines which are compiled at once wait in the queue.
+	*/
+	TaskQueueVulkan* GetPipelineLinkQueue() const { return pipelineLinkQueue_.get(); }
+
+	/**
+		@brief	get a layout of a set which contains bindings of a mask (bit 0 : a constant buffer, bit n : a texture n - 1)
+		@param	inputAttachmentMask	textures in bindingMask which are input attachments
+		@note
+		Layouts are shared among pipelines and are destroyed with the graphics. It is thread safe.
+	*/
+	vk::DescriptorSetLayout GetDescriptorSetLayout(int32_t bindingMask, bool isPushDescriptor, int32_t inputAttachmentMask = 0);
 
 	int32_t GetSwapBufferCount() const;
 	uint32_t GetMemoryTypeIndex(uint32_t bits, const vk::MemoryPropertyFlags& properties);
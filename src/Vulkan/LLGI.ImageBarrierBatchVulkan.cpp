@@ -0,0 +1,164 @@
+#include "LLGI.ImageBarrierBatchVulkan.h"
+#include "LLGI.DeviceExtensionsVulkan.h"
+#include "LLGI.TextureVulkan.h"
+
+namespace LLGI
+{
+
+static vk::AccessFlags GetWriteAccesses(vk::AccessFlags accesses)
+{
+	return accesses & (vk::AccessFlagBits::eShaderWrite | vk::AccessFlagBits::eColorAttachmentWrite |
+					   vk::AccessFlagBits::eDepthStencilAttachmentWrite | vk::AccessFlagBits::eTransferWrite |
+					   vk::AccessFlagBits::eHostWrite | vk::AccessFlagBits::eMemoryWrite);
+}
+
+void ImageBarrierBatchVulkan::Transition(TextureVulkan* texture, const ImageStateVulkan& state, bool isDiscarded, bool isAliased)
+{
+	if (texture == nullptr || !texture->GetImage())
+		return;
+
+	auto range = texture->GetSubresourceRange();
+	auto dstStages = state.Stages ? state.Stages : vk::PipelineStageFlags(vk::PipelineStageFlagBits::eBottomOfPipe);
+
+	for (uint32_t mipLevel = 0; mipLevel < texture->GetMipLevelCount(); mipLevel++)
+	{
+		for (uint32_t arrayLayer = 0; arrayLayer < texture->GetArrayLayerCount(); arrayLayer++)
+		{
+			auto& current = texture->GetSubresourceState(mipLevel, arrayLayer);
+
+			// reads after reads in the same layout don't need barriers
+			if (!isDiscarded && !isAliased && current.Layout == state.Layout && !GetWriteAccesses(current.Accesses) &&
+				!GetWriteAccesses(state.Accesses))
+			{
+				current.Stages |= state.Stages;
+				current.Accesses |= state.Accesses;
+				continue;
+			}
+
+			auto srcStages = current.Stages ? current.Stages : vk::PipelineStageFlags(vk::PipelineStageFlagBits::eTopOfPipe);
+			if (isAliased)
+			{
+				srcStages |= vk::PipelineStageFlagBits::eAllCommands;
+			}
+
+			auto srcAccesses = isAliased ? vk::AccessFlags(vk::AccessFlagBits::eMemoryWrite) : GetWriteAccesses(current.Accesses);
+			auto oldLayout = isDiscarded ? vk::ImageLayout::eUndefined : current.Layout;
+
+			// merge adjacent layers which have the same state
+			if (barriers_.size() > 0)
+			{
+				auto& last = barriers_.back();
+				auto& lastRange = last.ImageBarrier.subresourceRange;
+				if (last.ImageBarrier.image == texture->GetImage() && lastRange.baseMipLevel == mipLevel &&
+					lastRange.baseArrayLayer + lastRange.layerCount == arrayLayer && last.ImageBarrier.oldLayout == oldLayout &&
+					last.ImageBarrier.newLayout == state.Layout && last.ImageBarrier.srcAccessMask == srcAccesses &&
+					last.SrcStages == srcStages)
+				{
+					lastRange.layerCount++;
+					current = state;
+					continue;
+				}
+			}
+
+			Barrier barrier;
+			barrier.SrcStages = srcStages;
+			barrier.DstStages = dstStages;
+			barrier.ImageBarrier.srcAccessMask = srcAccesses;
+			barrier.ImageBarrier.dstAccessMask = state.Accesses;
+			barrier.ImageBarrier.oldLayout = oldLayout;
+			barrier.ImageBarrier.newLayout = state.Layout;
+			barrier.ImageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.ImageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.ImageBarrier.image = texture->GetImage();
+			barrier.ImageBarrier.subresourceRange.aspectMask = range.aspectMask;
+			barrier.ImageBarrier.subresourceRange.baseMipLevel = mipLevel;
+			barrier.ImageBarrier.subresourceRange.levelCount = 1;
+			barrier.ImageBarrier.subresourceRange.baseArrayLayer = arrayLayer;
+			barrier.ImageBarrier.subresourceRange.layerCount = 1;
+			barriers_.push_back(barrier);
+
+			current = state;
+		}
+	}
+}
+
+void ImageBarrierBatchVulkan::TransitionTransient(vk::Image image, vk::ImageAspectFlags aspectMask, const ImageStateVulkan& state)
+{
+	if (!image)
+		return;
+
+	Barrier barrier;
+	barrier.SrcStages = state.Stages ? state.Stages : vk::PipelineStageFlags(vk::PipelineStageFlagBits::eTopOfPipe);
+	barrier.DstStages = state.Stages ? state.Stages : vk::PipelineStageFlags(vk::PipelineStageFlagBits::eBottomOfPipe);
+	barrier.ImageBarrier.srcAccessMask = GetWriteAccesses(state.Accesses);
+	barrier.ImageBarrier.dstAccessMask = state.Accesses;
+	barrier.ImageBarrier.oldLayout = vk::ImageLayout::eUndefined;
+	barrier.ImageBarrier.newLayout = state.Layout;
+	barrier.ImageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.ImageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.ImageBarrier.image = image;
+	barrier.ImageBarrier.subresourceRange.aspectMask = aspectMask;
+	barrier.ImageBarrier.subresourceRange.levelCount = 1;
+	barrier.ImageBarrier.subresourceRange.layerCount = 1;
+	barriers_.push_back(barrier);
+}
+
+void ImageBarrierBatchVulkan::Flush(vk::CommandBuffer commandBuffer, const DeviceExtensionsVulkan* extensions)
+{
+	if (barriers_.size() == 0)
+		return;
+
+#if defined(VK_KHR_synchronization2)
+	// stages are specified for each image
+	if (extensions != nullptr && extensions->IsSynchronization2Supported)
+	{
+		std::vector<VkImageMemoryBarrier2KHR> imageBarriers(barriers_.size());
+
+		for (size_t i = 0; i < barriers_.size(); i++)
+		{
+			const auto& src = barriers_[i];
+			auto& dst = imageBarriers[i];
+			dst = {};
+			dst.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR;
+			dst.srcStageMask = static_cast<VkPipelineStageFlags2KHR>(static_cast<VkPipelineStageFlags>(src.SrcStages));
+			dst.srcAccessMask = static_cast<VkAccessFlags2KHR>(static_cast<VkAccessFlags>(src.ImageBarrier.srcAccessMask));
+			dst.dstStageMask = static_cast<VkPipelineStageFlags2KHR>(static_cast<VkPipelineStageFlags>(src.DstStages));
+			dst.dstAccessMask = static_cast<VkAccessFlags2KHR>(static_cast<VkAccessFlags>(src.ImageBarrier.dstAccessMask));
+			dst.oldLayout = static_cast<VkImageLayout>(src.ImageBarrier.oldLayout);
+			dst.newLayout = static_cast<VkImageLayout>(src.ImageBarrier.newLayout);
+			dst.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			dst.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			dst.image = static_cast<VkImage>(src.ImageBarrier.image);
+			dst.subresourceRange = static_cast<VkImageSubresourceRange>(src.ImageBarrier.subresourceRange);
+		}
+
+		VkDependencyInfoKHR dependencyInfo = {};
+		dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR;
+		dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(imageBarriers.size());
+		dependencyInfo.pImageMemoryBarriers = imageBarriers.data();
+		extensions->CmdPipelineBarrier2(static_cast<VkCommandBuffer>(commandBuffer), &dependencyInfo);
+
+		barriers_.clear();
+		return;
+	}
+#endif
+
+	// stages of all images are merged
+	vk::PipelineStageFlags srcStages;
+	vk::PipelineStageFlags dstStages;
+	std::vector<vk::ImageMemoryBarrier> imageBarriers;
+	imageBarriers.reserve(barriers_.size());
+
+	for (const auto& barrier : barriers_)
+	{
+		srcStages |= barrier.SrcStages;
+		dstStages |= barrier.DstStages;
+		imageBarriers.push_back(barrier.ImageBarrier);
+	}
+
+	commandBuffer.pipelineBarrier(srcStages, dstStages, vk::DependencyFlags(), nullptr, nullptr, imageBarriers);
+
+	barriers_.clear();
+}
+
+} // namespace LLGI
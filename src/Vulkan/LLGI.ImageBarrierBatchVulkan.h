@@ -0,0 +1,60 @@
+
+#pragma once
+
+#include "LLGI.BaseVulkan.h"
+#include <vector>
+
+namespace LLGI
+{
+
+class DeviceExtensionsVulkan;
+class TextureVulkan;
+struct ImageStateVulkan;
+
+/**
+	@brief	a batch which collects layout transitions of images and records them with one barrier
+	@note
+	States of textures are updated when transitions are added, so transitions must be flushed before textures are used.
+	Stages and accesses of a barrier are decided from states of subresources which are tracked by textures.
+	A transition is skipped if a layout is not changed and there is no hazard.
+*/
+class ImageBarrierBatchVulkan
+{
+private:
+	struct Barrier
+	{
+		vk::ImageMemoryBarrier ImageBarrier;
+		vk::PipelineStageFlags SrcStages;
+		vk::PipelineStageFlags DstStages;
+	};
+
+	std::vector<Barrier> barriers_;
+
+public:
+	/**
+		@brief	add transitions of all subresources of a texture into a state
+		@param	texture	a texture
+		@param	state	a state which the texture is used with after the barrier
+		@param	isDiscarded	whether contents are discarded. It is faster than a transition which keeps contents.
+		@param	isAliased	whether the texture shares memory with other resources which may be accessed before
+	*/
+	void Transition(TextureVulkan* texture, const ImageStateVulkan& state, bool isDiscarded = false, bool isAliased = false);
+
+	/**
+		@brief	add a transition of an image which is not tracked. contents are discarded.
+		@note
+		It is used for transient images which are used only in the same state, so the previous use is also in the state.
+	*/
+	void TransitionTransient(vk::Image image, vk::ImageAspectFlags aspectMask, const ImageStateVulkan& state);
+
+	/**
+		@brief	record all transitions with one barrier and clear them
+		@param	commandBuffer	a command buffer
+		@param	extensions	extensions of a device. barriers are recorded with vkCmdPipelineBarrier2KHR if it is supported.
+	*/
+	void Flush(vk::CommandBuffer commandBuffer, const DeviceExtensionsVulkan* extensions = nullptr);
+
+	bool GetIsEmpty() const { return barriers_.size() == 0; }
+};
+
+} // namespace LLGI
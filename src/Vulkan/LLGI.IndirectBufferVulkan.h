@@ -0,0 +1,34 @@
+
+#pragma once
+
+#include "../LLGI.IndirectBuffer.h"
+#include "LLGI.BaseVulkan.h"
+#include "LLGI.GraphicsVulkan.h"
+
+namespace LLGI
+{
+
+class IndirectBufferVulkan : public IndirectBuffer
+{
+private:
+	std::shared_ptr<GraphicsVulkan> graphics_;
+	std::unique_ptr<Buffer> cpuBuf;
+	std::unique_ptr<Buffer> gpuBuf;
+	void* data = nullptr;
+	int32_t memSize = 0;
+
+public:
+	bool Initialize(GraphicsVulkan* graphics, int32_t size);
+
+	IndirectBufferVulkan();
+	virtual ~IndirectBufferVulkan();
+
+	void* Lock() override;
+	void* Lock(int32_t offset, int32_t size) override;
+	void Unlock() override;
+	int32_t GetSize() override;
+
+	vk::Buffer GetBuffer() { return gpuBuf->buffer(); }
+};
+
+} // namespace LLGI
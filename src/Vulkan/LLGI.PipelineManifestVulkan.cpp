@@ -0,0 +1,413 @@
+#include "LLGI.PipelineManifestVulkan.h"
+#include "../Utils/LLGI.Hash.h"
+#include "LLGI.GraphicsVulkan.h"
+#include "LLGI.PipelineStateVulkan.h"
+#include "LLGI.ShaderVulkan.h"
+#include <algorithm>
+#include <fstream>
+#include <string.h>
+#include <thread>
+#include <unordered_map>
+
+namespace LLGI
+{
+
+static const char ManifestMagic[4] = {'L', 'P', 'M', 'F'};
+static const uint32_t ManifestVersion = 5;
+
+template <typename T> static void WriteValue(std::vector<uint8_t>& buffer, T value)
+{
+	auto p = reinterpret_cast<const uint8_t*>(&value);
+	buffer.insert(buffer.end(), p, p + sizeof(T));
+}
+
+template <typename T> static bool ReadValue(const std::vector<uint8_t>& buffer, size_t& offset, T& value)
+{
+	if (offset + sizeof(T) > buffer.size())
+		return false;
+
+	memcpy(&value, buffer.data() + offset, sizeof(T));
+	offset += sizeof(T);
+	return true;
+}
+
+template <typename T> static bool ReadEnum(const std::vector<uint8_t>& buffer, size_t& offset, T& value)
+{
+	uint8_t v = 0;
+	if (!ReadValue(buffer, offset, v))
+		return false;
+
+	value = static_cast<T>(v);
+	return true;
+}
+
+static bool ReadBool(const std::vector<uint8_t>& buffer, size_t& offset, bool& value)
+{
+	uint8_t v = 0;
+	if (!ReadValue(buffer, offset, v))
+		return false;
+
+	value = v != 0;
+	return true;
+}
+
+/**
+	@brief	read a pipeline which is written by PipelineManifestVulkan::Record
+*/
+static bool ReadEntry(const std::vector<uint8_t>& entry,
+					  PipelineStateVulkan* pipelineState,
+					  std::array<uint64_t, static_cast<int>(ShaderStageType::Max)>& shaderHashes,
+					  RenderPassPipelineStateVulkanKey& renderPassKey)
+{
+	size_t offset = 0;
+
+	for (auto& hash : shaderHashes)
+	{
+		if (!ReadValue(entry, offset, hash))
+			return false;
+	}
+
+	uint8_t vertexLayoutCount = 0;
+	if (!ReadValue(entry, offset, vertexLayoutCount) || vertexLayoutCount > VertexLayoutMax)
+		return false;
+
+	pipelineState->VertexLayoutCount = vertexLayoutCount;
+	for (int32_t i = 0; i < vertexLayoutCount; i++)
+	{
+		if (!ReadEnum(entry, offset, pipelineState->VertexLayouts[i]))
+			return false;
+	}
+
+	bool isSucceeded = ReadEnum(entry, offset, pipelineState->Culling) && ReadEnum(entry, offset, pipelineState->Topology) &&
+					   ReadBool(entry, offset, pipelineState->IsDepthTestEnabled) &&
+					   ReadBool(entry, offset, pipelineState->IsDepthWriteEnabled) &&
+					   ReadBool(entry, offset, pipelineState->IsStencilTestEnabled) && ReadEnum(entry, offset, pipelineState->DepthFunc) &&
+					   ReadBool(entry, offset, pipelineState->IsBlendEnabled) && ReadEnum(entry, offset, pipelineState->BlendSrcFunc) &&
+					   ReadEnum(entry, offset, pipelineState->BlendDstFunc) && ReadEnum(entry, offset, pipelineState->BlendSrcFuncAlpha) &&
+					   ReadEnum(entry, offset, pipelineState->BlendDstFuncAlpha) &&
+					   ReadEnum(entry, offset, pipelineState->BlendEquationRGB) &&
+					   ReadEnum(entry, offset, pipelineState->BlendEquationAlpha) && ReadBool(entry, offset, pipelineState->IsMSAA) &&
+					   ReadValue(entry, offset, pipelineState->Subpass);
+
+	if (!isSucceeded)
+		return false;
+
+	for (auto& size : pipelineState->PushConstantSizes)
+	{
+		if (!ReadValue(entry, offset, size))
+			return false;
+	}
+
+	uint32_t specializationConstantCount = 0;
+	if (!ReadValue(entry, offset, specializationConstantCount) ||
+		offset + specializationConstantCount * sizeof(uint32_t) * 2 > entry.size())
+		return false;
+
+	pipelineState->SpecializationConstants.resize(specializationConstantCount);
+	for (auto& constant : pipelineState->SpecializationConstants)
+	{
+		if (!ReadValue(entry, offset, constant.ID) || !ReadValue(entry, offset, constant.Value))
+			return false;
+	}
+
+	uint8_t formatCount = 0;
+	isSucceeded = ReadBool(entry, offset, renderPassKey.isPresentMode) && ReadBool(entry, offset, renderPassKey.hasDepth) &&
+				  ReadEnum(entry, offset, renderPassKey.depthLoadOp) && ReadEnum(entry, offset, renderPassKey.depthStoreOp) &&
+				  ReadValue(entry, offset, renderPassKey.samplingCount) && ReadValue(entry, offset, formatCount);
+
+	if (!isSucceeded || formatCount > RenderTargetMax)
+		return false;
+
+	renderPassKey.formats.resize(formatCount);
+	renderPassKey.colorLoadOps.resize(formatCount);
+	renderPassKey.colorStoreOps.resize(formatCount);
+	for (size_t i = 0; i < renderPassKey.formats.size(); i++)
+	{
+		uint32_t format = 0;
+		if (!ReadValue(entry, offset, format) || !ReadEnum(entry, offset, renderPassKey.colorLoadOps.at(i)) ||
+			!ReadEnum(entry, offset, renderPassKey.colorStoreOps.at(i)))
+			return false;
+
+		renderPassKey.formats.at(i) = static_cast<vk::Format>(format);
+	}
+
+	uint8_t subpassCount = 0;
+	if (!ReadValue(entry, offset, subpassCount) || subpassCount > SubpassMax)
+		return false;
+
+	renderPassKey.subpasses.resize(subpassCount);
+	for (size_t i = 0; i < renderPassKey.subpasses.size(); i++)
+	{
+		auto& subpass = renderPassKey.subpasses.at(i);
+		if (!ReadValue(entry, offset, subpass.ColorAttachmentMask) || !ReadValue(entry, offset, subpass.InputAttachmentMask) ||
+			!ReadBool(entry, offset, subpass.IsDepthUsed) || !ReadBool(entry, offset, subpass.IsDepthInput))
+			return false;
+	}
+
+	return offset == entry.size();
+}
+
+PipelineManifestVulkan::~PipelineManifestVulkan() { WaitWarmUp(); }
+
+void PipelineManifestVulkan::AddEntry(std::vector<uint8_t>& entry)
+{
+	auto hash = CalculateFNV1a64(entry.data(), entry.size());
+
+	std::lock_guard<std::mutex> lock(mtx_);
+	if (entryHashes_.count(hash) > 0)
+		return;
+
+	entryHashes_.insert(hash);
+	entries_.push_back(std::move(entry));
+}
+
+void PipelineManifestVulkan::Record(PipelineStateVulkan* pipelineState, const DynamicPipelineState& state)
+{
+	auto renderPassPipelineState = pipelineState->GetRenderPassPipelineState();
+	if (renderPassPipelineState == nullptr)
+		return;
+
+	std::vector<uint8_t> entry;
+
+	for (int i = 0; i < static_cast<int>(ShaderStageType::Max); i++)
+	{
+		auto shader = pipelineState->GetShader(static_cast<ShaderStageType>(i));
+		WriteValue<uint64_t>(entry, shader != nullptr ? shader->GetHash() : 0);
+	}
+
+	WriteValue<uint8_t>(entry, static_cast<uint8_t>(pipelineState->VertexLayoutCount));
+	for (int32_t i = 0; i < pipelineState->VertexLayoutCount; i++)
+	{
+		WriteValue<uint8_t>(entry, static_cast<uint8_t>(pipelineState->VertexLayouts[i]));
+	}
+
+	WriteValue<uint8_t>(entry, static_cast<uint8_t>(state.Culling));
+	WriteValue<uint8_t>(entry, static_cast<uint8_t>(state.Topology));
+	WriteValue<uint8_t>(entry, state.IsDepthTestEnabled ? 1 : 0);
+	WriteValue<uint8_t>(entry, state.IsDepthWriteEnabled ? 1 : 0);
+	WriteValue<uint8_t>(entry, state.IsStencilTestEnabled ? 1 : 0);
+	WriteValue<uint8_t>(entry, static_cast<uint8_t>(state.DepthFunc));
+
+	WriteValue<uint8_t>(entry, pipelineState->IsBlendEnabled ? 1 : 0);
+	WriteValue<uint8_t>(entry, static_cast<uint8_t>(pipelineState->BlendSrcFunc));
+	WriteValue<uint8_t>(entry, static_cast<uint8_t>(pipelineState->BlendDstFunc));
+	WriteValue<uint8_t>(entry, static_cast<uint8_t>(pipelineState->BlendSrcFuncAlpha));
+	WriteValue<uint8_t>(entry, static_cast<uint8_t>(pipelineState->BlendDstFuncAlpha));
+	WriteValue<uint8_t>(entry, static_cast<uint8_t>(pipelineState->BlendEquationRGB));
+	WriteValue<uint8_t>(entry, static_cast<uint8_t>(pipelineState->BlendEquationAlpha));
+	WriteValue<uint8_t>(entry, pipelineState->IsMSAA ? 1 : 0);
+	WriteValue<int32_t>(entry, pipelineState->Subpass);
+
+	for (auto size : pipelineState->PushConstantSizes)
+	{
+		WriteValue<int32_t>(entry, size);
+	}
+
+	WriteValue<uint32_t>(entry, static_cast<uint32_t>(pipelineState->SpecializationConstants.size()));
+	for (const auto& constant : pipelineState->SpecializationConstants)
+	{
+		WriteValue<uint32_t>(entry, constant.ID);
+		WriteValue<uint32_t>(entry, constant.Value);
+	}
+
+	const auto& renderPassKey = renderPassPipelineState->Key;
+	WriteValue<uint8_t>(entry, renderPassKey.isPresentMode ? 1 : 0);
+	WriteValue<uint8_t>(entry, renderPassKey.hasDepth ? 1 : 0);
+	WriteValue<uint8_t>(entry, static_cast<uint8_t>(renderPassKey.depthLoadOp));
+	WriteValue<uint8_t>(entry, static_cast<uint8_t>(renderPassKey.depthStoreOp));
+	WriteValue<int32_t>(entry, renderPassKey.samplingCount);
+	WriteValue<uint8_t>(entry, static_cast<uint8_t>(renderPassKey.formats.size()));
+	for (size_t i = 0; i < renderPassKey.formats.size(); i++)
+	{
+		WriteValue<uint32_t>(entry, static_cast<uint32_t>(renderPassKey.formats.at(i)));
+		WriteValue<uint8_t>(entry, static_cast<uint8_t>(renderPassKey.colorLoadOps.at(i)));
+		WriteValue<uint8_t>(entry, static_cast<uint8_t>(renderPassKey.colorStoreOps.at(i)));
+	}
+
+	WriteValue<uint8_t>(entry, static_cast<uint8_t>(renderPassKey.subpasses.size()));
+	for (size_t i = 0; i < renderPassKey.subpasses.size(); i++)
+	{
+		const auto& subpass = renderPassKey.subpasses.at(i);
+		WriteValue<int32_t>(entry, subpass.ColorAttachmentMask);
+		WriteValue<int32_t>(entry, subpass.InputAttachmentMask);
+		WriteValue<uint8_t>(entry, subpass.IsDepthUsed ? 1 : 0);
+		WriteValue<uint8_t>(entry, subpass.IsDepthInput ? 1 : 0);
+	}
+
+	AddEntry(entry);
+}
+
+int32_t PipelineManifestVulkan::GetEntryCount()
+{
+	std::lock_guard<std::mutex> lock(mtx_);
+	return static_cast<int32_t>(entries_.size());
+}
+
+bool PipelineManifestVulkan::Save(const char* path)
+{
+	std::vector<uint8_t> buffer;
+	buffer.insert(buffer.end(), ManifestMagic, ManifestMagic + sizeof(ManifestMagic));
+	WriteValue<uint32_t>(buffer, ManifestVersion);
+
+	{
+		std::lock_guard<std::mutex> lock(mtx_);
+		WriteValue<uint32_t>(buffer, static_cast<uint32_t>(entries_.size()));
+
+		for (const auto& entry : entries_)
+		{
+			WriteValue<uint32_t>(buffer, static_cast<uint32_t>(entry.size()));
+			buffer.insert(buffer.end(), entry.begin(), entry.end());
+		}
+	}
+
+	std::ofstream file(path, std::ios::binary);
+	if (!file)
+	{
+		Log(LogType::Error, "Failed to open a pipeline manifest to write.");
+		return false;
+	}
+
+	file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+	return static_cast<bool>(file);
+}
+
+bool PipelineManifestVulkan::Load(const char* path)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+	{
+		return false;
+	}
+
+	std::vector<uint8_t> buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	size_t offset = 0;
+	uint32_t version = 0;
+	uint32_t count = 0;
+
+	if (buffer.size() < sizeof(ManifestMagic) || memcmp(buffer.data(), ManifestMagic, sizeof(ManifestMagic)) != 0)
+	{
+		Log(LogType::Error, "A pipeline manifest is invalid.");
+		return false;
+	}
+	offset += sizeof(ManifestMagic);
+
+	if (!ReadValue(buffer, offset, version) || version != ManifestVersion || !ReadValue(buffer, offset, count))
+	{
+		Log(LogType::Warning, "A version of a pipeline manifest is not supported.");
+		return false;
+	}
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		uint32_t size = 0;
+		if (!ReadValue(buffer, offset, size) || offset + size > buffer.size())
+		{
+			Log(LogType::Error, "A pipeline manifest is broken.");
+			return false;
+		}
+
+		std::vector<uint8_t> entry(buffer.begin() + offset, buffer.begin() + offset + size);
+		offset += size;
+		AddEntry(entry);
+	}
+
+	return true;
+}
+
+int32_t PipelineManifestVulkan::WarmUp(GraphicsVulkan* graphics, Shader** shaders, int32_t shaderCount)
+{
+	WaitWarmUp();
+
+	std::unordered_map<uint64_t, Shader*> shaderMap;
+	for (int32_t i = 0; i < shaderCount; i++)
+	{
+		if (shaders[i] != nullptr)
+		{
+			shaderMap[static_cast<ShaderVulkan*>(shaders[i])->GetHash()] = shaders[i];
+		}
+	}
+
+	std::vector<std::vector<uint8_t>> entries;
+	{
+		std::lock_guard<std::mutex> lock(mtx_);
+		entries = entries_;
+	}
+
+	for (const auto& entry : entries)
+	{
+		auto pipelineState = static_cast<PipelineStateVulkan*>(graphics->CreatePiplineState());
+		if (pipelineState == nullptr)
+			continue;
+
+		std::array<uint64_t, static_cast<int>(ShaderStageType::Max)> shaderHashes;
+		RenderPassPipelineStateVulkanKey renderPassKey;
+		bool isValid = ReadEntry(entry, pipelineState, shaderHashes, renderPassKey);
+
+		for (int i = 0; i < static_cast<int>(ShaderStageType::Max) && isValid; i++)
+		{
+			auto it = shaderMap.find(shaderHashes[i]);
+			isValid = it != shaderMap.end();
+
+			if (isValid)
+			{
+				pipelineState->SetShader(static_cast<ShaderStageType>(i), it->second);
+			}
+		}
+
+		if (!isValid)
+		{
+			SafeRelease(pipelineState);
+			continue;
+		}
+
+		// a cache of render pass pipeline states is not thread safe, so they are created in this thread
+		auto renderPassPipelineState = graphics->GetRenderPassPipelineStateCache()->Create(renderPassKey);
+		pipelineState->SetRenderPassPipelineState(renderPassPipelineState);
+		SafeRelease(renderPassPipelineState);
+
+		warmingPipelines_.push_back(pipelineState);
+	}
+
+	auto pipelines = warmingPipelines_;
+	warmUp_ = std::async(std::launch::async, [pipelines]() {
+		std::atomic<size_t> next(0);
+		auto compile = [&pipelines, &next]() {
+			for (size_t i = next++; i < pipelines.size(); i = next++)
+			{
+				pipelines[i]->Compile();
+			}
+		};
+
+		auto threadCount = std::max(std::min(std::thread::hardware_concurrency(), static_cast<uint32_t>(pipelines.size())), 1u);
+
+		std::vector<std::thread> workers;
+		for (uint32_t i = 0; i < threadCount; i++)
+		{
+			workers.emplace_back(compile);
+		}
+
+		for (auto& worker : workers)
+		{
+			worker.join();
+		}
+	});
+
+	return static_cast<int32_t>(pipelines.size());
+}
+
+void PipelineManifestVulkan::WaitWarmUp()
+{
+	if (warmUp_.valid())
+	{
+		warmUp_.get();
+	}
+
+	for (auto& pipelineState : warmingPipelines_)
+	{
+		SafeRelease(pipelineState);
+	}
+	warmingPipelines_.clear();
+}
+
+} // namespace LLGI
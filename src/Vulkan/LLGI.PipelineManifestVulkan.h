@@ -0,0 +1,70 @@
+
+#pragma once
+
+#include "LLGI.BaseVulkan.h"
+#include <future>
+#include <mutex>
+#include <unordered_set>
+
+namespace LLGI
+{
+
+class GraphicsVulkan;
+class PipelineStateVulkan;
+
+/**
+	@brief	a list of pipelines which are compiled at runtime
+	@note
+	Pipelines are recorded when they are compiled while this is specified with GraphicsVulkan::SetPipelineManifest.
+	A saved manifest is loaded in a next process and the pipelines are compiled in background before they are used.
+	Compiled pipelines are stored in the pipeline cache of GraphicsVulkan, so compiling them again at first use is fast.
+	Shaders are identified by hashes of their binaries, so shaders which are used by the pipelines must be specified to WarmUp.
+*/
+class PipelineManifestVulkan : public ReferenceObject
+{
+private:
+	std::mutex mtx_;
+	std::vector<std::vector<uint8_t>> entries_;
+	std::unordered_set<uint64_t> entryHashes_;
+
+	std::vector<PipelineStateVulkan*> warmingPipelines_;
+	std::future<void> warmUp_;
+
+	void AddEntry(std::vector<uint8_t>& entry);
+
+public:
+	PipelineManifestVulkan() = default;
+	virtual ~PipelineManifestVulkan();
+
+	/**
+		@brief	record a pipeline which is compiled with states
+		@note
+		It is thread safe. A pipeline which has been recorded is ignored.
+	*/
+	void Record(PipelineStateVulkan* pipelineState, const DynamicPipelineState& state);
+
+	int32_t GetEntryCount();
+
+	bool Save(const char* path);
+
+	/**
+		@brief	add pipelines in a file to recorded pipelines
+	*/
+	bool Load(const char* path);
+
+	/**
+		@brief	compile recorded pipelines with worker threads in background
+		@return	the number of pipelines which are compiled
+		@note
+		Pipelines whose shaders are not specified are skipped.
+		WaitWarmUp must be called before releasing graphics because pipeline states being compiled refer it.
+	*/
+	int32_t WarmUp(GraphicsVulkan* graphics, Shader** shaders, int32_t shaderCount);
+
+	/**
+		@brief	wait until WarmUp finishes
+	*/
+	void WaitWarmUp();
+};
+
+} // namespace LLGI
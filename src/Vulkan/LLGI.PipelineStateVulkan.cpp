@@ -1,5 +1,8 @@
 #include "LLGI.PipelineStateVulkan.h"
+#include "LLGI.PipelineManifestVulkan.h"
 #include "LLGI.ShaderVulkan.h"
+#include <algorithm>
+#include <cstddef>
 
 // for x11
 #undef Always
@@ -10,6 +13,17 @@ namespace LLGI
 PipelineStateVulkan::PipelineStateVulkan()
 {
 	shaders.fill(0);
+
+	bindingMasks_.fill(BindingMaskCount - 1);
+	inputAttachmentMasks_.fill(0);
+
+#if defined(VK_KHR_descriptor_update_template)
+	for (auto& templates : descriptorUpdateTemplates_)
+	{
+		templates.fill(VK_NULL_HANDLE);
+	}
+#endif
+
 	for (auto i = 0; i < descriptorSetLayouts.size(); i++)
 	{
 		descriptorSetLayouts[i] = nullptr;
@@ -18,14 +32,45 @@ PipelineStateVulkan::PipelineStateVulkan()
 
 PipelineStateVulkan ::~PipelineStateVulkan()
 {
+	// wait background compiles which refer a layout and libraries. compiles which have not started are canceled
+	if (graphics_->GetPipelineLinkQueue() != nullptr)
+	{
+		graphics_->GetPipelineLinkQueue()->Cancel(this);
+	}
+
+	for (auto& optimizing : optimizingPipelines_)
+	{
+		auto pipeline = optimizing.Pipeline.get();
+		if (pipeline)
+		{
+			graphics_->GetDevice().destroyPipeline(pipeline);
+		}
+	}
+	optimizingPipelines_.clear();
+
 	for (auto& shader : shaders)
 	{
 		SafeRelease(shader);
 	}
 
+#if defined(VK_KHR_descriptor_update_template)
+	for (auto& templates : descriptorUpdateTemplates_)
+	{
+		for (auto& t : templates)
+		{
+			if (t != VK_NULL_HANDLE)
+			{
+				graphics_->GetDeviceExtensions().DestroyDescriptorUpdateTemplate(
+					static_cast<VkDevice>(graphics_->GetDevice()), t, nullptr);
+				t = VK_NULL_HANDLE;
+			}
+		}
+	}
+#endif
+
+	// layouts are owned by the graphics
 	for (auto i = 0; i < descriptorSetLayouts.size(); i++)
 	{
-		graphics_->GetDevice().destroyDescriptorSetLayout(descriptorSetLayouts[i]);
 		descriptorSetLayouts[i] = nullptr;
 	}
 
@@ -41,6 +86,24 @@ PipelineStateVulkan ::~PipelineStateVulkan()
 		pipeline_ = nullptr;
 	}
 
+	for (auto& variant : pipelineVariants_)
+	{
+		graphics_->GetDevice().destroyPipeline(variant.second);
+	}
+	pipelineVariants_.clear();
+
+	for (auto& pipeline : replacedPipelines_)
+	{
+		graphics_->GetDevice().destroyPipeline(pipeline);
+	}
+	replacedPipelines_.clear();
+
+	for (auto& library : libraries_)
+	{
+		graphics_->GetDevice().destroyPipeline(library.second);
+	}
+	libraries_.clear();
+
 	SafeRelease(graphics_);
 }
 
@@ -60,7 +123,376 @@ void PipelineStateVulkan::SetShader(ShaderStageType stage, Shader* shader)
 	shaders[static_cast<int>(stage)] = shader;
 }
 
-void PipelineStateVulkan::Compile()
+ShaderVulkan* PipelineStateVulkan::GetShader(ShaderStageType stage) const
+{
+	return static_cast<ShaderVulkan*>(shaders[static_cast<int>(stage)]);
+}
+
+RenderPassPipelineStateVulkan* PipelineStateVulkan::GetRenderPassPipelineState() const
+{
+	return static_cast<RenderPassPipelineStateVulkan*>(renderPassPipelineState_.get());
+}
+
+vk::ShaderStageFlagBits PipelineStateVulkan::GetShaderStageFlag(ShaderStageType stage)
+{
+	if (stage == ShaderStageType::Vertex)
+		return vk::ShaderStageFlagBits::eVertex;
+	if (stage == ShaderStageType::Pixel)
+		return vk::ShaderStageFlagBits::eFragment;
+
+	assert(0);
+	return vk::ShaderStageFlagBits::eAll;
+}
+
+vk::CullModeFlags PipelineStateVulkan::GetCullMode(CullingMode culling)
+{
+	if (culling == CullingMode::Clockwise)
+		return vk::CullModeFlagBits::eBack;
+	if (culling == CullingMode::CounterClockwise)
+		return vk::CullModeFlagBits::eFront;
+	if (culling == CullingMode::DoubleSide)
+		return vk::CullModeFlagBits::eNone;
+
+	assert(0);
+	return vk::CullModeFlagBits::eNone;
+}
+
+vk::PrimitiveTopology PipelineStateVulkan::GetPrimitiveTopology(TopologyType topology)
+{
+	if (topology == TopologyType::Triangle)
+		return vk::PrimitiveTopology::eTriangleList;
+	if (topology == TopologyType::Line)
+		return vk::PrimitiveTopology::eLineList;
+	if (topology == TopologyType::TriangleStrip)
+		return vk::PrimitiveTopology::eTriangleStrip;
+	if (topology == TopologyType::LineStrip)
+		return vk::PrimitiveTopology::eLineStrip;
+	if (topology == TopologyType::Point)
+		return vk::PrimitiveTopology::ePointList;
+
+	assert(0);
+	return vk::PrimitiveTopology::eTriangleList;
+}
+
+vk::CompareOp PipelineStateVulkan::GetCompareOp(DepthFuncType func)
+{
+	switch (func)
+	{
+	case DepthFuncType::Never:
+		return vk::CompareOp::eNever;
+	case DepthFuncType::Less:
+		return vk::CompareOp::eLess;
+	case DepthFuncType::Equal:
+		return vk::CompareOp::eEqual;
+	case DepthFuncType::LessEqual:
+		return vk::CompareOp::eLessOrEqual;
+	case DepthFuncType::Greater:
+		return vk::CompareOp::eGreater;
+	case DepthFuncType::NotEqual:
+		return vk::CompareOp::eNotEqual;
+	case DepthFuncType::GreaterEqual:
+		return vk::CompareOp::eGreaterOrEqual;
+	case DepthFuncType::Always:
+		return vk::CompareOp::eAlways;
+	default:
+		assert(0);
+	}
+	return vk::CompareOp::eLess;
+}
+
+void PipelineStateVulkan::CreateDescriptorUpdateTemplates()
+{
+#if defined(VK_KHR_descriptor_update_template)
+	const auto& extensions = graphics_->GetDeviceExtensions();
+	if (!extensions.IsDescriptorUpdateTemplateSupported)
+		return;
+
+	// a pushed set is not updated with templates
+	auto setCount = isPushDescriptorEnabled_ ? 1 : static_cast<int32_t>(descriptorSetLayouts.size());
+
+	for (int32_t set = 0; set < setCount; set++)
+	{
+		for (int32_t mask = 1; mask < BindingMaskCount; mask++)
+		{
+			// a template can't write bindings which the layout doesn't contain
+			if ((mask & bindingMasks_[set]) != mask)
+				continue;
+
+			std::array<VkDescriptorUpdateTemplateEntryKHR, TextureBindingCount + 1> entries;
+			uint32_t entryCount = 0;
+
+			for (int32_t binding = 0; binding < TextureBindingCount + 1; binding++)
+			{
+				if ((mask & (1 << binding)) == 0)
+					continue;
+
+				auto& entry = entries[entryCount];
+				entry.dstBinding = binding;
+				entry.dstArrayElement = 0;
+				entry.descriptorCount = 1;
+				entry.stride = 0;
+
+				if (binding == 0)
+				{
+					entry.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+					entry.offset = offsetof(DescriptorBindings, ConstantBuffer);
+				}
+				else if ((inputAttachmentMasks_[set] & (1 << binding)) != 0)
+				{
+					entry.descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+					entry.offset = offsetof(DescriptorBindings, Textures) + sizeof(VkDescriptorImageInfo) * (binding - 1);
+				}
+				else
+				{
+					entry.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+					entry.offset = offsetof(DescriptorBindings, Textures) + sizeof(VkDescriptorImageInfo) * (binding - 1);
+				}
+
+				entryCount++;
+			}
+
+			VkDescriptorUpdateTemplateCreateInfoKHR info = {};
+			info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO_KHR;
+			info.descriptorUpdateEntryCount = entryCount;
+			info.pDescriptorUpdateEntries = entries.data();
+			info.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET_KHR;
+			info.descriptorSetLayout = static_cast<VkDescriptorSetLayout>(descriptorSetLayouts[set]);
+
+			auto& t = descriptorUpdateTemplates_[set][mask];
+			if (extensions.CreateDescriptorUpdateTemplate(static_cast<VkDevice>(graphics_->GetDevice()), &info, nullptr, &t) != VK_SUCCESS)
+			{
+				Log(LogType::Warning, "Failed to create a descriptor update template.");
+				t = VK_NULL_HANDLE;
+			}
+		}
+	}
+#endif
+}
+
+bool PipelineStateVulkan::UpdateDescriptorSet(vk::DescriptorSet descriptorSet,
+											  ShaderStageType stage,
+											  int32_t bindingMask,
+											  const DescriptorBindings& bindings)
+{
+#if defined(VK_KHR_descriptor_update_template)
+	const auto& templates = descriptorUpdateTemplates_[static_cast<int>(stage)];
+	if (bindingMask <= 0 || bindingMask >= BindingMaskCount || templates[bindingMask] == VK_NULL_HANDLE)
+		return false;
+
+	graphics_->GetDeviceExtensions().UpdateDescriptorSetWithTemplate(static_cast<VkDevice>(graphics_->GetDevice()),
+																	 static_cast<VkDescriptorSet>(descriptorSet),
+																	 templates[bindingMask],
+																	 &bindings);
+	return true;
+#else
+	return false;
+#endif
+}
+
+void PipelineStateVulkan::Reflect()
+{
+	bindingMasks_.fill(BindingMaskCount - 1);
+	inputAttachmentMasks_.fill(0);
+
+	for (auto shader : shaders)
+	{
+		if (shader == nullptr || !static_cast<ShaderVulkan*>(shader)->GetIsReflected())
+			return;
+	}
+
+	bindingMasks_.fill(0);
+	inputAttachmentMasks_.fill(0);
+
+	// bindings
+	for (int i = 0; i < static_cast<int>(ShaderStageType::Max); i++)
+	{
+		const auto& reflection = GetShader(static_cast<ShaderStageType>(i))->GetReflection();
+
+		for (const auto& binding : reflection.Bindings)
+		{
+			// a global texture table
+			if (binding.Set == static_cast<int32_t>(descriptorSetLayouts.size()) && graphics_->GetBindlessTextureTable() != nullptr)
+				continue;
+
+			// input attachments are read only in pixel shaders
+			bool isInputAttachment = binding.Type == ShaderBindingTypeVulkan::InputAttachment;
+			bool isSupported = binding.Set >= 0 && binding.Set < static_cast<int32_t>(descriptorSetLayouts.size()) &&
+							   binding.Binding >= 0 && binding.Binding <= TextureBindingCount &&
+							   (binding.Binding == 0 ? binding.Type == ShaderBindingTypeVulkan::UniformBuffer
+													 : (binding.Type == ShaderBindingTypeVulkan::CombinedImageSampler ||
+														(isInputAttachment && i == static_cast<int>(ShaderStageType::Pixel))));
+
+			if (!isSupported)
+			{
+				Log(LogType::Error, "A binding of a shader is not supported. It must be a constant buffer at 0 or textures after it.");
+				continue;
+			}
+
+			if (isInputAttachment)
+			{
+				inputAttachmentMasks_[binding.Set] |= 1 << binding.Binding;
+			}
+
+			if (binding.Set != i)
+			{
+				Log(LogType::Warning, "A shader uses a set of another stage. Set 0 is for vertex shaders and set 1 is for pixel ones.");
+			}
+
+			bindingMasks_[binding.Set] |= 1 << binding.Binding;
+		}
+	}
+
+	// vertex inputs
+	const auto& inputs = GetShader(ShaderStageType::Vertex)->GetReflection().VertexInputs;
+
+	if (VertexLayoutCount == 0)
+	{
+		for (const auto& input : inputs)
+		{
+			if (input.Location != VertexLayoutCount || VertexLayoutCount >= VertexLayoutMax ||
+				!ShaderReflectionVulkan::GetVertexLayoutFormat(input, VertexLayouts[VertexLayoutCount]))
+			{
+				Log(LogType::Error, "VertexLayouts can't be filled with inputs of a vertex shader. Please specify them.");
+				VertexLayoutCount = 0;
+				break;
+			}
+
+			VertexLayoutNames[VertexLayoutCount] = input.Name;
+			VertexLayoutCount++;
+		}
+	}
+	else
+	{
+		for (const auto& input : inputs)
+		{
+			if (input.Location >= VertexLayoutCount)
+			{
+				Log(LogType::Error, "A vertex shader has an input which is not specified in VertexLayouts.");
+				break;
+			}
+		}
+	}
+
+	// push constants
+	bool isPushConstantSpecified = false;
+	for (auto size : PushConstantSizes)
+	{
+		isPushConstantSpecified |= size > 0;
+	}
+
+	for (int i = 0; i < static_cast<int>(ShaderStageType::Max); i++)
+	{
+		auto stage = static_cast<ShaderStageType>(i);
+		const auto& reflection = GetShader(stage)->GetReflection();
+		if (reflection.PushConstantSize == 0)
+			continue;
+
+		auto offset = GetPushConstantOffset(stage);
+
+		if (!isPushConstantSpecified)
+		{
+			PushConstantSizes[i] = std::max(reflection.PushConstantSize - offset, 0);
+		}
+
+		if (reflection.PushConstantOffset < offset || reflection.PushConstantSize > offset + PushConstantSizes[i])
+		{
+			Log(LogType::Error, "Push constants of a shader are out of a range of PushConstantSizes.");
+		}
+	}
+}
+
+bool PipelineStateVulkan::Compile()
+{
+	Reflect();
+
+	// only one set can be pushed in a pipeline layout, so a set of the pixel shader, which is changed frequently, is pushed.
+	isPushDescriptorEnabled_ = graphics_->GetDeviceExtensions().IsPushDescriptorSupported;
+
+	descriptorSetLayouts[0] = graphics_->GetDescriptorSetLayout(bindingMasks_[0], false, inputAttachmentMasks_[0]);
+	descriptorSetLayouts[1] = graphics_->GetDescriptorSetLayout(bindingMasks_[1], isPushDescriptorEnabled_, inputAttachmentMasks_[1]);
+
+	CreateDescriptorUpdateTemplates();
+
+	// push constants
+	std::array<vk::PushConstantRange, static_cast<int>(ShaderStageType::Max)> pushConstantRanges;
+	int32_t pushConstantRangeCount = 0;
+
+	for (int i = 0; i < static_cast<int>(ShaderStageType::Max); i++)
+	{
+		if (PushConstantSizes[i] <= 0)
+			continue;
+
+		if (PushConstantSizes[i] % 4 != 0)
+		{
+			Log(LogType::Error, "PushConstantSizes must be multiples of 4.");
+			return false;
+		}
+
+		auto stage = static_cast<ShaderStageType>(i);
+		pushConstantRanges[pushConstantRangeCount].stageFlags = GetShaderStageFlag(stage);
+		pushConstantRanges[pushConstantRangeCount].offset = GetPushConstantOffset(stage);
+		pushConstantRanges[pushConstantRangeCount].size = PushConstantSizes[i];
+		pushConstantRangeCount++;
+	}
+
+	auto maxPushConstantsSize = graphics_->GetPysicalDevice().getProperties().limits.maxPushConstantsSize;
+	if (static_cast<uint32_t>(GetPushConstantOffset(ShaderStageType::Max)) > maxPushConstantsSize)
+	{
+		Log(LogType::Error, "PushConstantSizes exceeds maxPushConstantsSize.");
+		return false;
+	}
+
+	// a global texture table is bound as the set 2
+	std::array<vk::DescriptorSetLayout, 3> setLayouts = {descriptorSetLayouts[0], descriptorSetLayouts[1], vk::DescriptorSetLayout()};
+	uint32_t setLayoutCount = 2;
+
+	if (graphics_->GetBindlessTextureTable() != nullptr)
+	{
+		setLayouts[2] = graphics_->GetBindlessTextureTable()->GetDescriptorSetLayout();
+		setLayoutCount = 3;
+	}
+
+	vk::PipelineLayoutCreateInfo layoutInfo = {};
+	layoutInfo.setLayoutCount = setLayoutCount;
+	layoutInfo.pSetLayouts = setLayouts.data();
+	layoutInfo.pushConstantRangeCount = pushConstantRangeCount;
+	layoutInfo.pPushConstantRanges = pushConstantRanges.data();
+
+	pipelineLayout_ = graphics_->GetDevice().createPipelineLayout(layoutInfo);
+
+	// setup a pipeline
+	pipelineKey_ = GetVariantKey(GetDynamicState());
+	pipeline_ = CompilePipeline(pipelineKey_);
+	return static_cast<bool>(pipeline_);
+}
+
+DynamicPipelineState PipelineStateVulkan::GetVariantKey(const DynamicPipelineState& state) const
+{
+	if (!graphics_->GetDeviceExtensions().IsExtendedDynamicStateSupported)
+	{
+		return state;
+	}
+
+	// a topology can be changed dynamically only in the same class
+	auto key = GetDynamicState();
+
+	if (state.Topology == TopologyType::Triangle || state.Topology == TopologyType::TriangleStrip)
+	{
+		key.Topology = TopologyType::Triangle;
+	}
+	else if (state.Topology == TopologyType::Line || state.Topology == TopologyType::LineStrip)
+	{
+		key.Topology = TopologyType::Line;
+	}
+	else
+	{
+		key.Topology = TopologyType::Point;
+	}
+
+	return key;
+}
+
+vk::Pipeline PipelineStateVulkan::CreatePipeline(const DynamicPipelineState& state, uint32_t libraryParts)
 {
 	vk::GraphicsPipelineCreateInfo graphicsPipelineInfo;
 
@@ -69,20 +501,47 @@ void PipelineStateVulkan::Compile()
 	// setup shaders
 	std::string mainName = "main";
 
+	// specialization constants are shared among stages
+	std::vector<vk::SpecializationMapEntry> specializationEntries;
+	std::vector<uint32_t> specializationData;
+	for (const auto& constant : SpecializationConstants)
+	{
+		vk::SpecializationMapEntry entry;
+		entry.constantID = constant.ID;
+		entry.offset = static_cast<uint32_t>(specializationData.size() * sizeof(uint32_t));
+		entry.size = sizeof(uint32_t);
+		specializationEntries.push_back(entry);
+		specializationData.push_back(constant.Value);
+	}
+
+	vk::SpecializationInfo specializationInfo;
+	specializationInfo.mapEntryCount = static_cast<uint32_t>(specializationEntries.size());
+	specializationInfo.pMapEntries = specializationEntries.data();
+	specializationInfo.dataSize = specializationData.size() * sizeof(uint32_t);
+	specializationInfo.pData = specializationData.data();
+
 	for (size_t i = 0; i < this->shaders.size(); i++)
 	{
+#if defined(VK_EXT_graphics_pipeline_library)
+		// a library contains only stages of its parts
+		if (libraryParts != 0)
+		{
+			auto requiredPart = static_cast<ShaderStageType>(i) == ShaderStageType::Vertex
+									? VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT
+									: VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT;
+			if ((libraryParts & requiredPart) == 0)
+				continue;
+		}
+#endif
+
 		auto shader = static_cast<ShaderVulkan*>(shaders[i]);
 
 		vk::PipelineShaderStageCreateInfo info;
-
-		if (i == static_cast<int>(ShaderStageType::Vertex))
-			info.stage = vk::ShaderStageFlagBits::eVertex;
-
-		if (i == static_cast<int>(ShaderStageType::Pixel))
-			info.stage = vk::ShaderStageFlagBits::eFragment;
+		info.stage = GetShaderStageFlag(static_cast<ShaderStageType>(i));
 
 		info.module = shader->GetShaderModule();
 		info.pName = mainName.c_str();
+		info.pSpecializationInfo = specializationEntries.size() > 0 ? &specializationInfo : nullptr;
 		shaderStageInfos.push_back(info);
 	}
 
@@ -144,18 +603,7 @@ void PipelineStateVulkan::Compile()
 
 	// setup a topology
 	vk::PipelineInputAssemblyStateCreateInfo inputAssemblyStateInfo;
-	if (Topology == TopologyType::Triangle)
-	{
-		inputAssemblyStateInfo.topology = vk::PrimitiveTopology::eTriangleList;
-	}
-	else if (Topology == TopologyType::Line)
-	{
-		inputAssemblyStateInfo.topology = vk::PrimitiveTopology::eLineList;
-	}
-	else
-	{
-		assert(0);
-	}
+	inputAssemblyStateInfo.topology = GetPrimitiveTopology(state.Topology);
 	inputAssemblyStateInfo.primitiveRestartEnable = false;
 
 	graphicsPipelineInfo.pInputAssemblyState = &inputAssemblyStateInfo;
@@ -190,19 +638,7 @@ void PipelineStateVulkan::Compile()
 	rasterizationState.rasterizerDiscardEnable = false;
 	rasterizationState.polygonMode = vk::PolygonMode::eFill;
 
-	if (Culling == CullingMode::Clockwise)
-	{
-		rasterizationState.cullMode = vk::CullModeFlagBits::eBack;
-	}
-	else if (Culling == CullingMode::CounterClockwise)
-	{
-		rasterizationState.cullMode = vk::CullModeFlagBits::eFront;
-	}
-	else if (Culling == CullingMode::DoubleSide)
-	{
-		rasterizationState.cullMode = vk::CullModeFlagBits::eNone;
-	}
-
+	rasterizationState.cullMode = GetCullMode(state.Culling);
 	rasterizationState.frontFace = vk::FrontFace::eClockwise;
 
 	rasterizationState.depthBiasEnable = false;
@@ -216,7 +652,8 @@ void PipelineStateVulkan::Compile()
 	// setup a multisampling
 	vk::PipelineMultisampleStateCreateInfo multisampleStateInfo;
 	multisampleStateInfo.sampleShadingEnable = false;
-	multisampleStateInfo.rasterizationSamples = vk::SampleCountFlagBits::e1;
+	// a sampling count must be same as one of a render pass, so IsMSAA is not needed
+	multisampleStateInfo.rasterizationSamples = static_cast<vk::SampleCountFlagBits>(GetRenderPassPipelineState()->Key.samplingCount);
 	multisampleStateInfo.minSampleShading = 1.0f;
 	multisampleStateInfo.pSampleMask = nullptr;
 	multisampleStateInfo.alphaToCoverageEnable = false;
@@ -227,21 +664,10 @@ void PipelineStateVulkan::Compile()
 	// setup a depthstencil
 	vk::PipelineDepthStencilStateCreateInfo depthStencilInfo;
 
-	depthStencilInfo.depthTestEnable = IsDepthTestEnabled;
-	depthStencilInfo.depthWriteEnable = IsDepthWriteEnabled;
-	depthStencilInfo.stencilTestEnable = IsStencilTestEnabled;
-
-	std::array<vk::CompareOp, 10> depthCompareOps;
-	depthCompareOps[static_cast<int>(DepthFuncType::Never)] = vk::CompareOp::eNever;
-	depthCompareOps[static_cast<int>(DepthFuncType::Less)] = vk::CompareOp::eLess;
-	depthCompareOps[static_cast<int>(DepthFuncType::Equal)] = vk::CompareOp::eEqual;
-	depthCompareOps[static_cast<int>(DepthFuncType::LessEqual)] = vk::CompareOp::eLessOrEqual;
-	depthCompareOps[static_cast<int>(DepthFuncType::Greater)] = vk::CompareOp::eGreater;
-	depthCompareOps[static_cast<int>(DepthFuncType::NotEqual)] = vk::CompareOp::eNotEqual;
-	depthCompareOps[static_cast<int>(DepthFuncType::GreaterEqual)] = vk::CompareOp::eGreaterOrEqual;
-	depthCompareOps[static_cast<int>(DepthFuncType::Always)] = vk::CompareOp::eAlways;
-
-	depthStencilInfo.depthCompareOp = depthCompareOps[static_cast<int>(DepthFunc)];
+	depthStencilInfo.depthTestEnable = state.IsDepthTestEnabled;
+	depthStencilInfo.depthWriteEnable = state.IsDepthWriteEnabled;
+	depthStencilInfo.stencilTestEnable = state.IsStencilTestEnabled;
+	depthStencilInfo.depthCompareOp = GetCompareOp(state.DepthFunc);
 
 	graphicsPipelineInfo.pDepthStencilState = &depthStencilInfo;
 
@@ -285,11 +711,16 @@ void PipelineStateVulkan::Compile()
 		blendInfo.blendEnable = false;
 	}
 
+	// all color attachments of a subpass are blended in the same way
+	std::array<vk::PipelineColorBlendAttachmentState, RenderTargetMax> blendInfos;
+	auto colorAttachmentCount = GetRenderPassPipelineState()->GetColorAttachmentCount(Subpass);
+	blendInfos.fill(blendInfo);
+
 	vk::PipelineColorBlendStateCreateInfo colorBlendInfo;
 	colorBlendInfo.logicOpEnable = VK_FALSE;
 	colorBlendInfo.logicOp = vk::LogicOp::eCopy;
-	colorBlendInfo.attachmentCount = 1;
-	colorBlendInfo.pAttachments = &blendInfo;
+	colorBlendInfo.attachmentCount = static_cast<uint32_t>(colorAttachmentCount);
+	colorBlendInfo.pAttachments = blendInfos.data();
 	colorBlendInfo.blendConstants[0] = 0.0f;
 	colorBlendInfo.blendConstants[1] = 0.0f;
 	colorBlendInfo.blendConstants[2] = 0.0f;
@@ -298,56 +729,245 @@ void PipelineStateVulkan::Compile()
 	graphicsPipelineInfo.pColorBlendState = &colorBlendInfo;
 
 	// dynamic state
-	vk::DynamicState dynamicStates[] = {vk::DynamicState::eViewport, vk::DynamicState::eScissor};
+	std::array<vk::DynamicState, 8> dynamicStates;
+	uint32_t dynamicStateCount = 0;
+	dynamicStates[dynamicStateCount++] = vk::DynamicState::eViewport;
+	dynamicStates[dynamicStateCount++] = vk::DynamicState::eScissor;
+
+#if defined(VK_EXT_extended_dynamic_state)
+	if (graphics_->GetDeviceExtensions().IsExtendedDynamicStateSupported)
+	{
+		dynamicStates[dynamicStateCount++] = static_cast<vk::DynamicState>(VK_DYNAMIC_STATE_CULL_MODE_EXT);
+		dynamicStates[dynamicStateCount++] = static_cast<vk::DynamicState>(VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY_EXT);
+		dynamicStates[dynamicStateCount++] = static_cast<vk::DynamicState>(VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT);
+		dynamicStates[dynamicStateCount++] = static_cast<vk::DynamicState>(VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT);
+		dynamicStates[dynamicStateCount++] = static_cast<vk::DynamicState>(VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT);
+		dynamicStates[dynamicStateCount++] = static_cast<vk::DynamicState>(VK_DYNAMIC_STATE_STENCIL_TEST_ENABLE_EXT);
+	}
+#endif
 
 	vk::PipelineDynamicStateCreateInfo dynamicStateInfo;
-	dynamicStateInfo.pDynamicStates = dynamicStates;
-	dynamicStateInfo.dynamicStateCount = 2;
+	dynamicStateInfo.pDynamicStates = dynamicStates.data();
+	dynamicStateInfo.dynamicStateCount = dynamicStateCount;
 
 	graphicsPipelineInfo.pDynamicState = &dynamicStateInfo;
 
 	// setup a render pass
 	assert(renderPassPipelineState_ != nullptr);
-	graphicsPipelineInfo.renderPass = static_cast<RenderPassPipelineStateVulkan*>(renderPassPipelineState_.get())->GetRenderPass();
-
-	// uniform layout info
-	std::array<vk::DescriptorSetLayoutBinding, 3> uboLayoutBindings;
-	uboLayoutBindings[0].binding = 0;
-	uboLayoutBindings[0].descriptorType = vk::DescriptorType::eUniformBufferDynamic;
-	uboLayoutBindings[0].descriptorCount = 1;
-	uboLayoutBindings[0].stageFlags = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
-	uboLayoutBindings[0].pImmutableSamplers = nullptr;
-
-	uboLayoutBindings[1].binding = 1;
-	uboLayoutBindings[1].descriptorType = vk::DescriptorType::eCombinedImageSampler;
-	uboLayoutBindings[1].descriptorCount = 1;
-	uboLayoutBindings[1].stageFlags = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
-	uboLayoutBindings[1].pImmutableSamplers = nullptr;
-
-	uboLayoutBindings[2].binding = 2;
-	uboLayoutBindings[2].descriptorType = vk::DescriptorType::eCombinedImageSampler;
-	uboLayoutBindings[2].descriptorCount = 1;
-	uboLayoutBindings[2].stageFlags = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
-	uboLayoutBindings[2].pImmutableSamplers = nullptr;
-
-	vk::DescriptorSetLayoutCreateInfo descriptorSetLayoutInfo;
-	descriptorSetLayoutInfo.bindingCount = uboLayoutBindings.size();
-	descriptorSetLayoutInfo.pBindings = uboLayoutBindings.data();
-
-	descriptorSetLayouts[0] = graphics_->GetDevice().createDescriptorSetLayout(descriptorSetLayoutInfo);
-	descriptorSetLayouts[1] = graphics_->GetDevice().createDescriptorSetLayout(descriptorSetLayoutInfo);
+	auto renderPassPipelineState = GetRenderPassPipelineState();
+	graphicsPipelineInfo.renderPass = renderPassPipelineState->GetRenderPass();
+	graphicsPipelineInfo.subpass = static_cast<uint32_t>(Subpass);
+
+#if defined(VK_KHR_dynamic_rendering)
+	// only formats are specified, so the pipeline is compatible with all render passes which have the same formats
+	std::array<VkFormat, RenderTargetMax> colorFormats;
+	VkPipelineRenderingCreateInfoKHR renderingInfo = {};
+	if (renderPassPipelineState->GetIsDynamicRendering())
+	{
+		const auto& key = renderPassPipelineState->Key;
+		for (size_t i = 0; i < key.formats.size(); i++)
+		{
+			colorFormats[i] = static_cast<VkFormat>(key.formats.at(i));
+		}
 
-	vk::PipelineLayoutCreateInfo layoutInfo = {};
-	layoutInfo.setLayoutCount = 2;
-	layoutInfo.pSetLayouts = descriptorSetLayouts.data();
-	layoutInfo.pushConstantRangeCount = 0;
-	layoutInfo.pPushConstantRanges = nullptr;
+		renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+		renderingInfo.colorAttachmentCount = static_cast<uint32_t>(key.formats.size());
+		renderingInfo.pColorAttachmentFormats = colorFormats.data();
+
+		if (key.hasDepth)
+		{
+			renderingInfo.depthAttachmentFormat = VK_FORMAT_D32_SFLOAT_S8_UINT;
+			renderingInfo.stencilAttachmentFormat = VK_FORMAT_D32_SFLOAT_S8_UINT;
+		}
+
+		graphicsPipelineInfo.pNext = &renderingInfo;
+	}
+#endif
 
-	pipelineLayout_ = graphics_->GetDevice().createPipelineLayout(layoutInfo);
 	graphicsPipelineInfo.layout = pipelineLayout_;
 
+#if defined(VK_EXT_graphics_pipeline_library)
+	VkGraphicsPipelineLibraryCreateInfoEXT libraryInfo = {};
+	if (libraryParts != 0)
+	{
+		libraryInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT;
+		libraryInfo.flags = libraryParts;
+		libraryInfo.pNext = const_cast<void*>(graphicsPipelineInfo.pNext);
+		graphicsPipelineInfo.pNext = &libraryInfo;
+		graphicsPipelineInfo.flags =
+			vk::PipelineCreateFlags(VK_PIPELINE_CREATE_LIBRARY_BIT_KHR | VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT);
+	}
+#endif
+
 	// setup a pipeline
-	pipeline_ = graphics_->GetDevice().createGraphicsPipeline(nullptr, graphicsPipelineInfo);
+	return graphics_->GetDevice().createGraphicsPipeline(graphics_->GetPipelineCache(), graphicsPipelineInfo);
+}
+
+vk::Pipeline PipelineStateVulkan::CompilePipeline(const DynamicPipelineState& state)
+{
+	auto manifest = graphics_->GetPipelineManifest();
+	if (manifest != nullptr)
+	{
+		manifest->Record(this, state);
+	}
+
+#if defined(VK_EXT_graphics_pipeline_library)
+	if (graphics_->GetDeviceExtensions().IsGraphicsPipelineLibrarySupported)
+	{
+		std::array<vk::Pipeline, 4> libraries = {GetLibrary(VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT, state),
+												 GetLibrary(VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT, state),
+												 GetLibrary(VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT, state),
+												 GetLibrary(VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT, state)};
+
+		// linking without optimization is fast, so a pipeline can be used immediately
+		auto pipeline = LinkPipeline(graphics_->GetDevice(), graphics_->GetPipelineCache(), libraries, pipelineLayout_, false);
+
+		if (pipeline)
+		{
+			auto promise = std::make_shared<std::promise<vk::Pipeline>>();
+
+			OptimizingPipeline optimizing;
+			optimizing.Key = state;
+			optimizing.Pipeline = promise->get_future();
+			optimizingPipelines_.push_back(std::move(optimizing));
+
+			auto device = graphics_->GetDevice();
+			auto pipelineCache = graphics_->GetPipelineCache();
+			auto pipelineLayout = pipelineLayout_;
+			graphics_->GetPipelineLinkQueue()->Push(
+				this, [promise, device, pipelineCache, libraries, pipelineLayout](bool isCanceled) {
+					promise->set_value(isCanceled ? vk::Pipeline() : LinkPipeline(device, pipelineCache, libraries, pipelineLayout, true));
+				});
+			return pipeline;
+		}
+
+		Log(LogType::Warning, "Failed to link a pipeline from libraries.");
+	}
+#endif
+
+	return CreatePipeline(state);
+}
+
+vk::Pipeline PipelineStateVulkan::GetLibrary(uint32_t libraryPart, const DynamicPipelineState& state)
+{
+#if defined(VK_EXT_graphics_pipeline_library)
+	// a part is shared by pipelines which differ only in states of other parts
+	uint32_t key = libraryPart;
+
+	if (libraryPart == VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT)
+	{
+		key |= static_cast<uint32_t>(state.Topology) << 8;
+	}
+	else if (libraryPart == VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT)
+	{
+		key |= static_cast<uint32_t>(state.Culling) << 8;
+	}
+	else if (libraryPart == VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT)
+	{
+		key |= (state.IsDepthTestEnabled ? 1 : 0) << 8;
+		key |= (state.IsDepthWriteEnabled ? 1 : 0) << 9;
+		key |= (state.IsStencilTestEnabled ? 1 : 0) << 10;
+		key |= static_cast<uint32_t>(state.DepthFunc) << 11;
+	}
+
+	auto it = libraries_.find(key);
+	if (it != libraries_.end())
+	{
+		return it->second;
+	}
+
+	auto library = CreatePipeline(state, libraryPart);
+	libraries_[key] = library;
+	return library;
+#else
+	return vk::Pipeline();
+#endif
+}
+
+void PipelineStateVulkan::ReplaceOptimizedPipelines()
+{
+	for (auto it = optimizingPipelines_.begin(); it != optimizingPipelines_.end();)
+	{
+		if (it->Pipeline.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			it++;
+			continue;
+		}
+
+		auto pipeline = it->Pipeline.get();
+		if (pipeline)
+		{
+			auto& target = it->Key == pipelineKey_ ? pipeline_ : pipelineVariants_[it->Key];
+			replacedPipelines_.push_back(target);
+			target = pipeline;
+		}
+
+		it = optimizingPipelines_.erase(it);
+	}
+}
+
+vk::Pipeline PipelineStateVulkan::LinkPipeline(vk::Device device,
+											   vk::PipelineCache pipelineCache,
+											   const std::array<vk::Pipeline, 4>& libraries,
+											   vk::PipelineLayout pipelineLayout,
+											   bool isOptimized)
+{
+#if defined(VK_EXT_graphics_pipeline_library)
+	std::array<VkPipeline, 4> handles;
+	for (size_t i = 0; i < libraries.size(); i++)
+	{
+		if (!libraries[i])
+			return vk::Pipeline();
+
+		handles[i] = static_cast<VkPipeline>(libraries[i]);
+	}
+
+	VkPipelineLibraryCreateInfoKHR libraryInfo = {};
+	libraryInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR;
+	libraryInfo.libraryCount = static_cast<uint32_t>(handles.size());
+	libraryInfo.pLibraries = handles.data();
+
+	VkGraphicsPipelineCreateInfo info = {};
+	info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+	info.pNext = &libraryInfo;
+	info.flags = isOptimized ? VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT : 0;
+	info.layout = static_cast<VkPipelineLayout>(pipelineLayout);
+
+	VkPipeline pipeline = VK_NULL_HANDLE;
+	if (vkCreateGraphicsPipelines(
+			static_cast<VkDevice>(device), static_cast<VkPipelineCache>(pipelineCache), 1, &info, nullptr, &pipeline) != VK_SUCCESS)
+	{
+		return vk::Pipeline();
+	}
+
+	return vk::Pipeline(pipeline);
+#else
+	return vk::Pipeline();
+#endif
+}
+
+vk::Pipeline PipelineStateVulkan::GetPipeline(const DynamicPipelineState& state)
+{
+	if (!optimizingPipelines_.empty())
+	{
+		ReplaceOptimizedPipelines();
+	}
+
+	auto key = GetVariantKey(state);
+	if (key == pipelineKey_)
+	{
+		return pipeline_;
+	}
+
+	auto it = pipelineVariants_.find(key);
+	if (it != pipelineVariants_.end())
+	{
+		return it->second;
+	}
+
+	auto pipeline = CompilePipeline(key);
+	pipelineVariants_[key] = pipeline;
+	return pipeline;
 }
 
 } // namespace LLGI
\ No newline at end of file
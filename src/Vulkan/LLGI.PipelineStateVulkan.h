@@ -4,12 +4,32 @@
 #include "../LLGI.PipelineState.h"
 #include "LLGI.BaseVulkan.h"
 #include "LLGI.GraphicsVulkan.h"
+#include <future>
+#include <unordered_map>
 
 namespace LLGI
 {
 
+class ShaderVulkan;
+
 class PipelineStateVulkan : public PipelineState
 {
+public:
+	//! the number of textures which are bound in each stage
+	static const int32_t TextureBindingCount = 2;
+
+	//! the number of combinations of bindings (a constant buffer and textures)
+	static const int32_t BindingMaskCount = 1 << (TextureBindingCount + 1);
+
+	/**
+		@brief	bindings of a stage which are written with a descriptor update template
+	*/
+	struct DescriptorBindings
+	{
+		VkDescriptorBufferInfo ConstantBuffer;
+		VkDescriptorImageInfo Textures[TextureBindingCount];
+	};
+
 private:
 	GraphicsVulkan* graphics_ = nullptr;
 	std::array<Shader*, static_cast<int>(ShaderStageType::Max)> shaders;
@@ -17,6 +37,82 @@ private:
 	vk::Pipeline pipeline_ = nullptr;
 	vk::PipelineLayout pipelineLayout_ = nullptr;
 	std::array<vk::DescriptorSetLayout, 2> descriptorSetLayouts;
+	bool isPushDescriptorEnabled_ = false;
+
+	//! bindings which each set contains. a mask consists of bit 0 : a constant buffer, bit n : a texture n - 1
+	std::array<int32_t, 2> bindingMasks_;
+
+	//! textures in bindingMasks_ which are input attachments
+	std::array<int32_t, 2> inputAttachmentMasks_;
+
+#if defined(VK_KHR_descriptor_update_template)
+	//! templates for each set. an index is a mask of bindings
+	std::array<std::array<VkDescriptorUpdateTemplateKHR, BindingMaskCount>, 2> descriptorUpdateTemplates_;
+#endif
+
+	//! states which pipeline_ is compiled for
+	DynamicPipelineState pipelineKey_;
+
+	//! pipelines which are compiled for states which are not supported as dynamic states
+	std::unordered_map<DynamicPipelineState, vk::Pipeline, DynamicPipelineState::Hash> pipelineVariants_;
+
+	void CreateDescriptorUpdateTemplates();
+
+	/**
+		@brief	get bindings from shaders and validate them
+		@note
+		VertexLayouts and PushConstantSizes are filled if they are not specified.
+		All bindings are declared if shaders can't be reflected.
+	*/
+	void Reflect();
+
+	/**
+		@brief	get states which a pipeline must be compiled for
+		@note
+		With VK_EXT_extended_dynamic_state, only the class of a topology is required. Otherwise all states are required.
+	*/
+	DynamicPipelineState GetVariantKey(const DynamicPipelineState& state) const;
+
+	/**
+		@brief	a pipeline which is linked from libraries and is being compiled with optimization in background
+	*/
+	struct OptimizingPipeline
+	{
+		DynamicPipelineState Key;
+		std::future<vk::Pipeline> Pipeline;
+	};
+
+	//! parts of pipelines which are compiled with VK_EXT_graphics_pipeline_library. a key is a part and states which it depends on
+	std::unordered_map<uint32_t, vk::Pipeline> libraries_;
+
+	std::vector<OptimizingPipeline> optimizingPipelines_;
+
+	//! linked pipelines which are replaced with optimized pipelines. they are kept because command buffers may still refer them
+	std::vector<vk::Pipeline> replacedPipelines_;
+
+	/**
+		@brief	create a monolithic pipeline or a library which contains specified parts
+		@param	libraryParts	VkGraphicsPipelineLibraryFlagsEXT. A monolithic pipeline is created if it is 0.
+	*/
+	vk::Pipeline CreatePipeline(const DynamicPipelineState& state, uint32_t libraryParts = 0);
+
+	/**
+		@brief	create a pipeline with libraries if it is supported
+	*/
+	vk::Pipeline CompilePipeline(const DynamicPipelineState& state);
+
+	vk::Pipeline GetLibrary(uint32_t libraryPart, const DynamicPipelineState& state);
+
+	/**
+		@brief	replace linked pipelines with optimized pipelines which have been compiled
+	*/
+	void ReplaceOptimizedPipelines();
+
+	static vk::Pipeline LinkPipeline(vk::Device device,
+									 vk::PipelineCache pipelineCache,
+									 const std::array<vk::Pipeline, 4>& libraries,
+									 vk::PipelineLayout pipelineLayout,
+									 bool isOptimized);
 
 public:
 	PipelineStateVulkan();
@@ -25,13 +121,53 @@ public:
 	bool Initialize(GraphicsVulkan* graphics);
 
 	void SetShader(ShaderStageType stage, Shader* shader) override;
-	void Compile() override;
+	bool Compile() override;
 
 	vk::Pipeline GetPipeline() const { return pipeline_; }
 
+	/**
+		@brief	get a pipeline which can be drawn with states specified by CommandList::SetDynamicState
+		@note
+		A variant is compiled when it is requested at first if states can't be set dynamically.
+	*/
+	vk::Pipeline GetPipeline(const DynamicPipelineState& state);
+
 	vk::PipelineLayout GetPipelineLayout() const { return pipelineLayout_; }
 
+	ShaderVulkan* GetShader(ShaderStageType stage) const;
+
+	RenderPassPipelineStateVulkan* GetRenderPassPipelineState() const;
+
 	const std::array<vk::DescriptorSetLayout, 2>& GetDescriptorSetLayout() const { return descriptorSetLayouts; }
+
+	/**
+		@brief	get bindings which a set of the stage contains
+	*/
+	int32_t GetBindingMask(ShaderStageType stage) const { return bindingMasks_[static_cast<int>(stage)]; }
+
+	/**
+		@brief	get textures which are read as input attachments. bits are same as GetBindingMask
+	*/
+	int32_t GetInputAttachmentMask(ShaderStageType stage) const { return inputAttachmentMasks_[static_cast<int>(stage)]; }
+
+	/**
+		@brief	whether a descriptor set of the pixel shader is pushed with VK_KHR_push_descriptor
+	*/
+	bool GetIsPushDescriptorEnabled() const { return isPushDescriptorEnabled_; }
+
+	/**
+		@brief	update a set of the stage by a template
+		@return	false if templates are not supported
+	*/
+	bool UpdateDescriptorSet(vk::DescriptorSet descriptorSet,
+							 ShaderStageType stage,
+							 int32_t bindingMask,
+							 const DescriptorBindings& bindings);
+
+	static vk::ShaderStageFlagBits GetShaderStageFlag(ShaderStageType stage);
+	static vk::CullModeFlags GetCullMode(CullingMode culling);
+	static vk::PrimitiveTopology GetPrimitiveTopology(TopologyType topology);
+	static vk::CompareOp GetCompareOp(DepthFuncType func);
 };
 
 } // namespace LLGI
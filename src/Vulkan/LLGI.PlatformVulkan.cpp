@@ -3,6 +3,7 @@
 #endif
 
 #include "LLGI.PlatformVulkan.h"
+#include "LLGI.FramebufferCacheVulkan.h"
 #include "LLGI.GraphicsVulkan.h"
 #include "LLGI.TextureVulkan.h"
 #include <iostream>
@@ -182,7 +183,7 @@ void PlatformVulkan::CreateRenderPass()
 		std::array<TextureVulkan*, 1> textures;
 		textures[0] = swapBuffers[i].texture;
 
-		renderPass->Initialize(const_cast<const TextureVulkan**>(textures.data()), 1, depthStencilTexture_);
+		renderPass->Initialize(const_cast<const TextureVulkan**>(textures.data()), 1, depthStencilTexture_, framebufferCache_);
 
 		renderPasses.emplace_back(CreateSharedPtr(renderPass));
 	}
@@ -370,6 +371,7 @@ PlatformVulkan::~PlatformVulkan()
 	Reset();
 
 	SafeRelease(depthStencilTexture_);
+	SafeRelease(framebufferCache_);
 	/*
 	if (depthStencilBuffer.image)
 	{
@@ -403,7 +405,7 @@ PlatformVulkan::~PlatformVulkan()
 	}
 }
 
-bool PlatformVulkan::Initialize(Window* window, bool waitVSync)
+bool PlatformVulkan::Initialize(Window* window, bool waitVSync, bool isBindlessRequested)
 {
 	window_ = window;
 	waitVSync_ = waitVSync;
@@ -418,7 +420,7 @@ bool PlatformVulkan::Initialize(Window* window, bool waitVSync)
 	appInfo.apiVersion = VK_API_VERSION_1_0;
 
 	// specify extension
-	const std::vector<const char*> extensions = {
+	std::vector<const char*> extensions = {
 		VK_KHR_SURFACE_EXTENSION_NAME,
 #ifdef _WIN32
 		VK_KHR_WIN32_SURFACE_EXTENSION_NAME,
@@ -431,10 +433,16 @@ bool PlatformVulkan::Initialize(Window* window, bool waitVSync)
 #endif
 	};
 
+	for (auto name : DeviceExtensionsVulkan::GetInstanceExtensionNames())
+	{
+		extensions.push_back(name);
+	}
+
 	auto exitWithError = [this]() -> void {
 		Reset();
 
 		SafeRelease(depthStencilTexture_);
+		SafeRelease(framebufferCache_);
 
 		if (vkDevice_)
 		{
@@ -530,13 +538,22 @@ bool PlatformVulkan::Initialize(Window* window, bool waitVSync)
 		queueCreateInfo.pQueuePriorities = queuePriorities;
 		queueFamilyIndex_ = queueCreateInfo.queueFamilyIndex;
 
-		const std::vector<const char*> enabledExtensions = {
+		std::vector<const char*> enabledExtensions = {
 			VK_KHR_SWAPCHAIN_EXTENSION_NAME,
 #if !defined(NDEBUG)
 		// VK_EXT_DEBUG_MARKER_EXTENSION_NAME,
 #endif
 		};
+
+		// enable optional extensions
+		deviceExtensions_.Select(vkInstance_, vkPhysicalDevice, isBindlessRequested);
+		for (auto name : deviceExtensions_.GetExtensionNames())
+		{
+			enabledExtensions.push_back(name);
+		}
+
 		vk::DeviceCreateInfo deviceCreateInfo;
+		deviceCreateInfo.pNext = deviceExtensions_.GetFeatureChain();
 		deviceCreateInfo.queueCreateInfoCount = 1;
 		deviceCreateInfo.pQueueCreateInfos = &queueCreateInfo;
 		deviceCreateInfo.pEnabledFeatures = &deviceFeatures;
@@ -554,6 +571,8 @@ bool PlatformVulkan::Initialize(Window* window, bool waitVSync)
 #endif
 		vkDevice_ = vkPhysicalDevice.createDevice(deviceCreateInfo);
 
+		deviceExtensions_.Load(vkDevice_);
+
 #if !defined(NDEBUG)
 		// get callbacks
 		createDebugReportCallback = (PFN_vkCreateDebugReportCallbackEXT)vkInstance_.getProcAddr("vkCreateDebugReportCallbackEXT");
@@ -700,7 +719,9 @@ bool PlatformVulkan::Initialize(Window* window, bool waitVSync)
 		*/
 
 		windowSize_ = window->GetWindowSize();
-		renderPassPipelineStateCache_ = new RenderPassPipelineStateCacheVulkan(vkDevice_, nullptr);
+		renderPassPipelineStateCache_ =
+			new RenderPassPipelineStateCacheVulkan(vkDevice_, nullptr, deviceExtensions_.IsDynamicRenderingSupported);
+		framebufferCache_ = new FramebufferCacheVulkan(vkDevice_, nullptr);
 
 		// create renderpasses
 		CreateRenderPass();
@@ -829,8 +850,15 @@ Graphics* PlatformVulkan::CreateGraphics()
 		this->executedCommandCount++;
 	};
 
-	auto graphics = new GraphicsVulkan(
-		vkDevice_, vkQueue, vkCmdPool_, vkPhysicalDevice, swapBuffers.size(), addCommand, renderPassPipelineStateCache_, this);
+	auto graphics = new GraphicsVulkan(vkDevice_,
+									   vkQueue,
+									   vkCmdPool_,
+									   vkPhysicalDevice,
+									   swapBuffers.size(),
+									   addCommand,
+									   renderPassPipelineStateCache_,
+									   this,
+									   deviceExtensions_);
 
 	return graphics;
 }
@@ -4,6 +4,7 @@
 
 #include "../LLGI.Platform.h"
 #include "LLGI.BaseVulkan.h"
+#include "LLGI.DeviceExtensionsVulkan.h"
 
 #ifdef _WIN32
 #include "../Win/LLGI.WindowWin.h"
@@ -14,6 +15,8 @@
 namespace LLGI
 {
 
+class FramebufferCacheVulkan;
+
 class PlatformVulkan : public Platform
 {
 private:
@@ -55,6 +58,8 @@ private:
 	vk::CommandPool vkCmdPool_ = nullptr;
 	int32_t queueFamilyIndex_ = 0;
 
+	DeviceExtensionsVulkan deviceExtensions_;
+
 	Vec2I windowSize_;
 
 	//! to check to finish present
@@ -77,6 +82,9 @@ private:
 
 	RenderPassPipelineStateCacheVulkan* renderPassPipelineStateCache_ = nullptr;
 
+	//! framebuffers of screens, which are destroyed with swap buffers or a depth buffer
+	FramebufferCacheVulkan* framebufferCache_ = nullptr;
+
 	std::vector<std::shared_ptr<RenderPassVulkan>> renderPasses;
 
 	std::vector<SwapBuffer> swapBuffers;
@@ -124,7 +132,7 @@ public:
 	PlatformVulkan();
 	virtual ~PlatformVulkan();
 
-	bool Initialize(Window* window, bool waitVSync);
+	bool Initialize(Window* window, bool waitVSync, bool isBindlessRequested = false);
 
 	bool NewFrame() override;
 	void Present() override;
@@ -150,6 +158,8 @@ public:
 
 	int32_t GetQueueFamilyIndex() const { return queueFamilyIndex_; }
 
+	const DeviceExtensionsVulkan& GetDeviceExtensions() const { return deviceExtensions_; }
+
 	DeviceType GetDeviceType() const override { return DeviceType::Vulkan; }
 };
 
@@ -0,0 +1,122 @@
+#include "LLGI.ReadbackRingVulkan.h"
+#include "LLGI.GraphicsVulkan.h"
+
+namespace LLGI
+{
+
+//! it satisfies alignments of offsets of vkCmdCopyImageToBuffer for all formats
+static const VkDeviceSize ReadbackAlignment = 16;
+
+ReadbackRingVulkan::~ReadbackRingVulkan() { Dispose(); }
+
+bool ReadbackRingVulkan::Initialize(GraphicsVulkan* graphics, VkDeviceSize size)
+{
+	if (!buffer_.Initialize(
+			graphics, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
+	{
+		Log(LogType::Error, "Failed to create a readback ring.");
+		return false;
+	}
+
+	device_ = static_cast<VkDevice>(graphics->GetDevice());
+
+	void* mapped = nullptr;
+	if (vkMapMemory(device_, buffer_.GetNativeBufferMemory(), 0, size, 0, &mapped) != VK_SUCCESS)
+	{
+		Log(LogType::Error, "Failed to map a readback ring.");
+		buffer_.Dispose();
+		return false;
+	}
+
+	mapped_ = static_cast<uint8_t*>(mapped);
+	head_ = 0;
+	tail_ = 0;
+	return true;
+}
+
+void ReadbackRingVulkan::Dispose()
+{
+	requests_.clear();
+
+	if (mapped_ != nullptr)
+	{
+		vkUnmapMemory(device_, buffer_.GetNativeBufferMemory());
+		mapped_ = nullptr;
+		buffer_.Dispose();
+	}
+}
+
+bool ReadbackRingVulkan::Allocate(VkDeviceSize size,
+								  int32_t swapBufferIndex,
+								  const std::function<void(const void* data, int32_t size)>& callback,
+								  VkDeviceSize& offset)
+{
+	if (mapped_ == nullptr || size == 0 || size > GetSize())
+		return false;
+
+	if (requests_.size() == 0)
+	{
+		head_ = 0;
+		tail_ = 0;
+	}
+
+	auto start = static_cast<VkDeviceSize>(GetAlignedSize(static_cast<size_t>(head_), static_cast<size_t>(ReadbackAlignment)));
+
+	if (requests_.size() > 0 && head_ <= tail_)
+	{
+		// used regions wrap around, so free space is between the head and the tail
+		if (head_ == tail_ || start + size > tail_)
+			return false;
+	}
+	else if (start + size > GetSize())
+	{
+		// the rest of the buffer is skipped until the tail passes it
+		if (size > tail_)
+			return false;
+
+		start = 0;
+	}
+
+	Request request;
+	request.Offset = start;
+	request.Size = size;
+	request.SwapBufferIndex = swapBufferIndex;
+	request.Callback = callback;
+	requests_.push_back(request);
+
+	head_ = start + size;
+	offset = start;
+	return true;
+}
+
+void ReadbackRingVulkan::Complete(const Request& request)
+{
+	if (request.Callback != nullptr)
+	{
+		request.Callback(mapped_ + request.Offset, static_cast<int32_t>(request.Size));
+	}
+
+	tail_ = request.Offset + request.Size;
+}
+
+void ReadbackRingVulkan::Complete(int32_t swapBufferIndex)
+{
+	while (requests_.size() > 0 && requests_.front().SwapBufferIndex == swapBufferIndex)
+	{
+		auto request = std::move(requests_.front());
+		requests_.pop_front();
+		Complete(request);
+	}
+}
+
+void ReadbackRingVulkan::CompleteAll()
+{
+	while (requests_.size() > 0)
+	{
+		auto request = std::move(requests_.front());
+		requests_.pop_front();
+		Complete(request);
+	}
+}
+
+} // namespace LLGI
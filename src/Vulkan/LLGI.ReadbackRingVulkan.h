@@ -0,0 +1,78 @@
+
+#pragma once
+
+#include "LLGI.BaseVulkan.h"
+#include <deque>
+#include <functional>
+
+namespace LLGI
+{
+
+class GraphicsVulkan;
+
+/**
+	@brief	a persistently mapped buffer which receives copies of textures and returns them to cpu later
+	@note
+	Regions are allocated from the head and freed from the tail in the order of allocations,
+	so requests must be completed in the order in which they are recorded.
+*/
+class ReadbackRingVulkan
+{
+private:
+	struct Request
+	{
+		VkDeviceSize Offset = 0;
+		VkDeviceSize Size = 0;
+		int32_t SwapBufferIndex = 0;
+		std::function<void(const void* data, int32_t size)> Callback;
+	};
+
+	VulkanBuffer buffer_;
+	VkDevice device_ = VK_NULL_HANDLE;
+	uint8_t* mapped_ = nullptr;
+	VkDeviceSize head_ = 0;
+	VkDeviceSize tail_ = 0;
+	std::deque<Request> requests_;
+
+	void Complete(const Request& request);
+
+public:
+	ReadbackRingVulkan() = default;
+	~ReadbackRingVulkan();
+
+	ReadbackRingVulkan(const ReadbackRingVulkan&) = delete;
+	ReadbackRingVulkan& operator=(const ReadbackRingVulkan&) = delete;
+
+	bool Initialize(GraphicsVulkan* graphics, VkDeviceSize size);
+
+	//! requests which are not completed are discarded
+	void Dispose();
+
+	bool GetIsInitialized() const { return mapped_ != nullptr; }
+
+	vk::Buffer GetBuffer() const { return vk::Buffer(buffer_.GetNativeBuffer()); }
+
+	VkDeviceSize GetSize() const { return buffer_.GetSize(); }
+
+	/**
+		@brief	allocate a region which a command buffer of the swap buffer index copies into
+		@param	offset	the offset of the allocated region
+		@return	whether the ring has enough space
+	*/
+	bool Allocate(VkDeviceSize size,
+				  int32_t swapBufferIndex,
+				  const std::function<void(const void* data, int32_t size)>& callback,
+				  VkDeviceSize& offset);
+
+	/**
+		@brief	call callbacks of requests of the swap buffer index and free them
+		@note
+		It must be called after gpu finishes a command buffer of the swap buffer index.
+	*/
+	void Complete(int32_t swapBufferIndex);
+
+	//! call callbacks of all requests and free them. It must be called after gpu finishes all command buffers.
+	void CompleteAll();
+};
+
+} // namespace LLGI
@@ -3,8 +3,10 @@
 namespace LLGI
 {
 
-RenderPassPipelineStateCacheVulkan::RenderPassPipelineStateCacheVulkan(vk::Device device, ReferenceObject* owner)
-	: device_(device), owner_(owner)
+RenderPassPipelineStateCacheVulkan::RenderPassPipelineStateCacheVulkan(vk::Device device,
+																	   ReferenceObject* owner,
+																	   bool isDynamicRenderingEnabled)
+	: device_(device), owner_(owner), isDynamicRenderingEnabled_(isDynamicRenderingEnabled)
 {
 	SafeAddRef(owner_);
 }
@@ -15,18 +17,52 @@ RenderPassPipelineStateCacheVulkan::~RenderPassPipelineStateCacheVulkan()
 	SafeRelease(owner_);
 }
 
+static vk::AttachmentLoadOp GetAttachmentLoadOp(AttachmentLoadOp loadOp)
+{
+	if (loadOp == AttachmentLoadOp::Load)
+		return vk::AttachmentLoadOp::eLoad;
+	if (loadOp == AttachmentLoadOp::Clear)
+		return vk::AttachmentLoadOp::eClear;
+	return vk::AttachmentLoadOp::eDontCare;
+}
+
+static vk::AttachmentStoreOp GetAttachmentStoreOp(AttachmentStoreOp storeOp)
+{
+	if (storeOp == AttachmentStoreOp::Store)
+		return vk::AttachmentStoreOp::eStore;
+	return vk::AttachmentStoreOp::eDontCare;
+}
+
 RenderPassPipelineStateVulkan* RenderPassPipelineStateCacheVulkan::Create(bool isPresentMode,
 																		  bool hasDepth,
 																		  const FixedSizeVector<vk::Format, RenderTargetMax>& formats,
 																		  bool isColorCleared,
-																		  bool isDepthCleared)
+																		  bool isDepthCleared,
+																		  int32_t samplingCount)
 {
 	RenderPassPipelineStateVulkanKey key;
 	key.isPresentMode = isPresentMode;
 	key.hasDepth = hasDepth;
 	key.formats = formats;
-	key.isColorCleared = isColorCleared;
-	key.isDepthCleared = isDepthCleared;
+	key.colorLoadOps.resize(formats.size());
+	key.colorStoreOps.resize(formats.size());
+	for (size_t i = 0; i < formats.size(); i++)
+	{
+		key.colorLoadOps.at(i) = isColorCleared ? AttachmentLoadOp::Clear : AttachmentLoadOp::Load;
+		key.colorStoreOps.at(i) = AttachmentStoreOp::Store;
+	}
+	key.depthLoadOp = isDepthCleared ? AttachmentLoadOp::Clear : AttachmentLoadOp::Load;
+	key.depthStoreOp = AttachmentStoreOp::Store;
+	key.samplingCount = samplingCount;
+
+	return Create(key);
+}
+
+RenderPassPipelineStateVulkan* RenderPassPipelineStateCacheVulkan::Create(const RenderPassPipelineStateVulkanKey& key)
+{
+	const auto isPresentMode = key.isPresentMode;
+	const auto hasDepth = key.hasDepth;
+	const auto& formats = key.formats;
 
 	// already?
 	{
@@ -45,12 +81,15 @@ RenderPassPipelineStateVulkan* RenderPassPipelineStateCacheVulkan::Create(bool i
 		}
 	}
 
+	// attachments are multisampled colors, a depth and resolved colors
+	const bool isMultisampled = key.samplingCount > 1;
+	const auto samples = static_cast<vk::SampleCountFlagBits>(key.samplingCount);
+	const int resolveOffset = formats.size() + (hasDepth ? 1 : 0);
+
 	// settings
-	FixedSizeVector<vk::AttachmentDescription, RenderTargetMax + 1> attachmentDescs;
-	FixedSizeVector<vk::AttachmentReference, RenderTargetMax + 1> attachmentRefs;
+	FixedSizeVector<vk::AttachmentDescription, RenderTargetMax * 2 + 1> attachmentDescs;
 	FixedSizeVector<vk::ImageLayout, RenderTargetMax + 1> finalLayouts;
-	attachmentDescs.resize(formats.size() + (hasDepth ? 1 : 0));
-	attachmentRefs.resize(formats.size() + (hasDepth ? 1 : 0));
+	attachmentDescs.resize(resolveOffset + (isMultisampled ? formats.size() : 0));
 	finalLayouts.resize(formats.size() + (hasDepth ? 1 : 0));
 
 	// color buffer
@@ -59,84 +98,212 @@ RenderPassPipelineStateVulkan* RenderPassPipelineStateCacheVulkan::Create(bool i
 	for (int i = 0; i < colorCount; i++)
 	{
 		attachmentDescs.at(i).format = formats.at(i);
-		attachmentDescs.at(i).samples = vk::SampleCountFlagBits::e1;
-
-		if (isColorCleared)
-			attachmentDescs.at(i).loadOp = vk::AttachmentLoadOp::eClear;
-		else
-			attachmentDescs.at(i).loadOp = vk::AttachmentLoadOp::eDontCare;
-
-		attachmentDescs.at(i).storeOp = vk::AttachmentStoreOp::eStore;
+		attachmentDescs.at(i).samples = samples;
+		attachmentDescs.at(i).loadOp = GetAttachmentLoadOp(key.colorLoadOps.at(i));
+		attachmentDescs.at(i).storeOp = GetAttachmentStoreOp(key.colorStoreOps.at(i));
 		attachmentDescs.at(i).stencilLoadOp = vk::AttachmentLoadOp::eDontCare;
 		attachmentDescs.at(i).stencilStoreOp = vk::AttachmentStoreOp::eDontCare;
 	}
 
 	if (isPresentMode)
 	{
-		// When clearing, the initialLayout does not matter.
-		attachmentDescs.at(0).initialLayout = (isColorCleared) ? vk::ImageLayout::eUndefined : vk::ImageLayout::ePresentSrcKHR;
+		// When contents are not loaded, the initialLayout does not matter.
+		attachmentDescs.at(0).initialLayout =
+			(key.colorLoadOps.at(0) != AttachmentLoadOp::Load) ? vk::ImageLayout::eUndefined : vk::ImageLayout::ePresentSrcKHR;
 		attachmentDescs.at(0).finalLayout = vk::ImageLayout::ePresentSrcKHR;
 	}
 	else
 	{
 		for (int i = 0; i < colorCount; i++)
 		{
-			// When clearing, the initialLayout does not matter.
-			attachmentDescs.at(i).initialLayout = (isColorCleared) ? vk::ImageLayout::eUndefined : vk::ImageLayout::eShaderReadOnlyOptimal;
+			// When contents are not loaded, the initialLayout does not matter.
+			attachmentDescs.at(i).initialLayout =
+				(key.colorLoadOps.at(i) != AttachmentLoadOp::Load) ? vk::ImageLayout::eUndefined : vk::ImageLayout::eShaderReadOnlyOptimal;
 			attachmentDescs.at(i).finalLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
 		}
 	}
 
+	// a multisampled image is transient, so contents are resolved into a texture instead of being stored
+	if (isMultisampled)
+	{
+		for (int i = 0; i < colorCount; i++)
+		{
+			auto& color = attachmentDescs.at(i);
+			auto& resolve = attachmentDescs.at(resolveOffset + i);
+
+			resolve = color;
+			resolve.samples = vk::SampleCountFlagBits::e1;
+			resolve.loadOp = vk::AttachmentLoadOp::eDontCare;
+			resolve.initialLayout = vk::ImageLayout::eUndefined;
+
+			if (color.loadOp == vk::AttachmentLoadOp::eLoad)
+			{
+				color.loadOp = vk::AttachmentLoadOp::eDontCare;
+			}
+			color.storeOp = vk::AttachmentStoreOp::eDontCare;
+			color.initialLayout = vk::ImageLayout::eUndefined;
+			color.finalLayout = vk::ImageLayout::eColorAttachmentOptimal;
+		}
+	}
+
 	// depth buffer
 	if (hasDepth)
 	{
 		attachmentDescs.at(colorCount).format = vk::Format::eD32SfloatS8Uint;
-		attachmentDescs.at(colorCount).samples = vk::SampleCountFlagBits::e1;
+		attachmentDescs.at(colorCount).samples = samples;
 
-		if (isDepthCleared)
-			attachmentDescs.at(colorCount).loadOp = vk::AttachmentLoadOp::eClear;
-		else
-			attachmentDescs.at(colorCount).loadOp = vk::AttachmentLoadOp::eDontCare;
-
-		attachmentDescs.at(colorCount).storeOp = vk::AttachmentStoreOp::eStore;
-		attachmentDescs.at(colorCount).stencilLoadOp = vk::AttachmentLoadOp::eDontCare;
-		attachmentDescs.at(colorCount).stencilStoreOp = vk::AttachmentStoreOp::eStore;
+		// a stencil is handled with a depth because they are in the same texture
+		attachmentDescs.at(colorCount).loadOp = GetAttachmentLoadOp(key.depthLoadOp);
+		attachmentDescs.at(colorCount).storeOp = GetAttachmentStoreOp(key.depthStoreOp);
+		attachmentDescs.at(colorCount).stencilLoadOp = GetAttachmentLoadOp(key.depthLoadOp);
+		attachmentDescs.at(colorCount).stencilStoreOp = GetAttachmentStoreOp(key.depthStoreOp);
 
-		// When clearing, the initialLayout does not matter.
+		// When contents are not loaded, the initialLayout does not matter.
 		attachmentDescs.at(colorCount).initialLayout =
-			(isDepthCleared) ? vk::ImageLayout::eUndefined : vk::ImageLayout::eDepthStencilAttachmentOptimal;
-		attachmentDescs.at(colorCount).finalLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal;	
+			(key.depthLoadOp != AttachmentLoadOp::Load) ? vk::ImageLayout::eUndefined : vk::ImageLayout::eDepthStencilAttachmentOptimal;
+		attachmentDescs.at(colorCount).finalLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
 	}
 
-	for (size_t i = 0; i < attachmentDescs.size(); i++)
+	// layouts of textures
+	for (size_t i = 0; i < finalLayouts.size(); i++)
 	{
-		finalLayouts.at(i) = attachmentDescs.at(i).finalLayout;
+		bool isResolved = isMultisampled && static_cast<int>(i) < colorCount;
+		finalLayouts.at(i) = attachmentDescs.at(isResolved ? resolveOffset + i : i).finalLayout;
 	}
 
-	for (int i = 0; i < colorCount; i++)
+	// attachments are specified when rendering begins, so neither a render pass nor a framebuffer is created.
+	// subpasses can't be expressed without a render pass.
+	if (isDynamicRenderingEnabled_ && key.subpasses.size() == 0)
 	{
-		vk::AttachmentReference& colorReference = attachmentRefs.at(i);
-		colorReference.attachment = i;
-		colorReference.layout = vk::ImageLayout::eColorAttachmentOptimal;
+		std::shared_ptr<RenderPassPipelineStateVulkan> ret = CreateSharedPtr(new RenderPassPipelineStateVulkan(device_, owner_));
+		ret->finalLayouts_ = finalLayouts;
+		ret->Key = key;
+		renderPassPipelineStates_[key] = ret;
+
+		auto retptr = ret.get();
+		SafeAddRef(retptr);
+		return retptr;
 	}
 
-	if (hasDepth)
+	// one subpass writes all attachments if subpasses are not specified
+	FixedSizeVector<SubpassParameter, SubpassMax> subpassParams = key.subpasses;
+	if (subpassParams.size() == 0)
 	{
-		vk::AttachmentReference& depthReference = attachmentRefs.at(colorCount);
-		depthReference.attachment = colorCount;
-		depthReference.layout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
+		subpassParams.resize(1);
+		subpassParams.at(0).ColorAttachmentMask = (1 << colorCount) - 1;
+		subpassParams.at(0).InputAttachmentMask = 0;
+		subpassParams.at(0).IsDepthUsed = hasDepth;
+		subpassParams.at(0).IsDepthInput = false;
 	}
 
-	std::array<vk::SubpassDescription, 1> subpasses;
+	const int subpassCount = static_cast<int>(subpassParams.size());
+
+	// a bit of a depth is colorCount
+	auto getUsedMask = [&](const SubpassParameter& param) -> int32_t {
+		int32_t mask = param.ColorAttachmentMask | param.InputAttachmentMask;
+		if (hasDepth && (param.IsDepthUsed || param.IsDepthInput))
+		{
+			mask |= 1 << colorCount;
+		}
+		return mask;
+	};
+
+	struct SubpassReferences
 	{
-		vk::SubpassDescription& subpass = subpasses[0];
+		std::array<vk::AttachmentReference, RenderTargetMax> colors;
+		std::array<vk::AttachmentReference, RenderTargetMax> resolves;
+		std::array<vk::AttachmentReference, RenderTargetMax + 1> inputs;
+		vk::AttachmentReference depth;
+		std::array<uint32_t, RenderTargetMax + 1> preserves;
+	};
+
+	std::array<SubpassReferences, SubpassMax> subpassRefs;
+	std::array<vk::SubpassDescription, SubpassMax> subpasses;
+	int32_t previousUsedMask = 0;
+
+	for (int s = 0; s < subpassCount; s++)
+	{
+		const auto& param = subpassParams.at(s);
+		auto& refs = subpassRefs[s];
+		uint32_t colorRefCount = 0;
+		uint32_t inputRefCount = 0;
+		uint32_t preserveCount = 0;
+		bool isResolved = false;
+
+		// outputs and input attachments of a shader are numbered in order of masks
+		for (int i = 0; i < colorCount; i++)
+		{
+			if ((param.ColorAttachmentMask & (1 << i)) != 0)
+			{
+				refs.colors[colorRefCount].attachment = i;
+				refs.colors[colorRefCount].layout = vk::ImageLayout::eColorAttachmentOptimal;
+
+				// a color is resolved in the last subpass which writes it
+				bool isLastWritten = true;
+				for (int t = s + 1; t < subpassCount; t++)
+				{
+					isLastWritten &= (subpassParams.at(t).ColorAttachmentMask & (1 << i)) == 0;
+				}
+
+				if (isMultisampled && isLastWritten)
+				{
+					refs.resolves[colorRefCount].attachment = resolveOffset + i;
+					refs.resolves[colorRefCount].layout = vk::ImageLayout::eColorAttachmentOptimal;
+					isResolved = true;
+				}
+				else
+				{
+					refs.resolves[colorRefCount].attachment = VK_ATTACHMENT_UNUSED;
+					refs.resolves[colorRefCount].layout = vk::ImageLayout::eUndefined;
+				}
+
+				colorRefCount++;
+			}
+
+			if ((param.InputAttachmentMask & (1 << i)) != 0)
+			{
+				refs.inputs[inputRefCount].attachment = i;
+				refs.inputs[inputRefCount].layout = vk::ImageLayout::eShaderReadOnlyOptimal;
+				inputRefCount++;
+			}
+		}
+
+		if (hasDepth && param.IsDepthInput)
+		{
+			refs.inputs[inputRefCount].attachment = colorCount;
+			refs.inputs[inputRefCount].layout = vk::ImageLayout::eDepthStencilReadOnlyOptimal;
+			inputRefCount++;
+		}
+
+		// contents which are written by previous subpasses are kept while a subpass doesn't use them
+		const auto usedMask = getUsedMask(param);
+		for (int i = 0; i < colorCount + (hasDepth ? 1 : 0); i++)
+		{
+			if ((previousUsedMask & (1 << i)) != 0 && (usedMask & (1 << i)) == 0)
+			{
+				refs.preserves[preserveCount] = i;
+				preserveCount++;
+			}
+		}
+		previousUsedMask |= usedMask;
+
+		vk::SubpassDescription& subpass = subpasses[s];
 		subpass.pipelineBindPoint = vk::PipelineBindPoint::eGraphics;
-		subpass.colorAttachmentCount = colorCount;
-		subpass.pColorAttachments = &attachmentRefs.at(0);
+		subpass.colorAttachmentCount = colorRefCount;
+		subpass.pColorAttachments = refs.colors.data();
+		subpass.pResolveAttachments = isResolved ? refs.resolves.data() : nullptr;
+		subpass.inputAttachmentCount = inputRefCount;
+		subpass.pInputAttachments = refs.inputs.data();
+		subpass.preserveAttachmentCount = preserveCount;
+		subpass.pPreserveAttachments = refs.preserves.data();
 
-		if (hasDepth)
+		if (hasDepth && param.IsDepthUsed)
 		{
-			subpass.pDepthStencilAttachment = &attachmentRefs.at(colorCount);
+			// a depth which is read as an input attachment can be tested but can't be written
+			refs.depth.attachment = colorCount;
+			refs.depth.layout =
+				param.IsDepthInput ? vk::ImageLayout::eDepthStencilReadOnlyOptimal : vk::ImageLayout::eDepthStencilAttachmentOptimal;
+			subpass.pDepthStencilAttachment = &refs.depth;
 		}
 		else
 		{
@@ -144,40 +311,44 @@ RenderPassPipelineStateVulkan* RenderPassPipelineStateCacheVulkan::Create(bool i
 		}
 	}
 
-	std::array<vk::SubpassDependency, 1> subpassDepends;
+	// a subpass waits for attachments which are written by a previous subpass only in the same region
+	std::array<vk::SubpassDependency, SubpassMax> subpassDepends;
+	for (int s = 1; s < subpassCount; s++)
 	{
-		vk::SubpassDependency& dependency = subpassDepends[0];
+		vk::SubpassDependency& dependency = subpassDepends[s - 1];
+		dependency.srcSubpass = s - 1;
+		dependency.dstSubpass = s;
+		dependency.srcStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput | vk::PipelineStageFlagBits::eLateFragmentTests;
+		dependency.dstStageMask = vk::PipelineStageFlagBits::eFragmentShader | vk::PipelineStageFlagBits::eEarlyFragmentTests |
+								  vk::PipelineStageFlagBits::eLateFragmentTests | vk::PipelineStageFlagBits::eColorAttachmentOutput;
+		dependency.srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eDepthStencilAttachmentWrite;
+		dependency.dstAccessMask = vk::AccessFlagBits::eInputAttachmentRead | vk::AccessFlagBits::eColorAttachmentRead |
+								   vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eDepthStencilAttachmentRead |
+								   vk::AccessFlagBits::eDepthStencilAttachmentWrite;
+		dependency.dependencyFlags = vk::DependencyFlagBits::eByRegion;
+	}
 
-		/*
-		//monsho
-		dependency.srcSubpass = 0;
+	// attachments may be sampled after the render pass without barriers
+	{
+		vk::SubpassDependency& dependency = subpassDepends[subpassCount - 1];
+		dependency.srcSubpass = subpassCount - 1;
 		dependency.dstSubpass = VK_SUBPASS_EXTERNAL;
-		dependency.srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
-		dependency.dstAccessMask = vk::AccessFlagBits::eColorAttachmentRead;
-		dependency.srcStageMask = vk::PipelineStageFlagBits::eBottomOfPipe;
-		dependency.dstStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput;
-		*/
-
-		dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-		dependency.dstSubpass = 0;
-		dependency.srcAccessMask = static_cast<vk::AccessFlagBits>(0);
-		dependency.dstAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
-		dependency.srcStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput;
-		dependency.dstStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput;
+		dependency.srcStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput | vk::PipelineStageFlagBits::eLateFragmentTests;
+		dependency.dstStageMask = vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader;
+		dependency.srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eDepthStencilAttachmentWrite;
+		dependency.dstAccessMask = vk::AccessFlagBits::eShaderRead;
 	}
 
 	{
 		vk::RenderPassCreateInfo renderPassInfo;
 		renderPassInfo.attachmentCount = (uint32_t)attachmentDescs.size();
 		renderPassInfo.pAttachments = attachmentDescs.data();
-		renderPassInfo.subpassCount = (uint32_t)subpasses.size();
+		renderPassInfo.subpassCount = (uint32_t)subpassCount;
 		renderPassInfo.pSubpasses = subpasses.data();
 
-		// based on official
-		// renderPassInfo.dependencyCount = (uint32_t)subpassDepends.size();
-		// renderPassInfo.pDependencies = subpassDepends.data();
-		renderPassInfo.dependencyCount = 0;
-		renderPassInfo.pDependencies = nullptr;
+		// a dependency from outside of the render pass is implicit. barriers are recorded by command lists before it.
+		renderPassInfo.dependencyCount = (uint32_t)subpassCount;
+		renderPassInfo.pDependencies = subpassDepends.data();
 
 		auto renderPass = device_.createRenderPass(renderPassInfo);
 		if (!renderPass)
@@ -188,6 +359,7 @@ RenderPassPipelineStateVulkan* RenderPassPipelineStateCacheVulkan::Create(bool i
 		std::shared_ptr<RenderPassPipelineStateVulkan> ret = CreateSharedPtr(new RenderPassPipelineStateVulkan(device_, owner_));
 		ret->renderPass_ = renderPass;
 		ret->finalLayouts_ = finalLayouts;
+		ret->Key = key;
 		renderPassPipelineStates_[key] = ret;
 
 		auto retptr = ret.get();
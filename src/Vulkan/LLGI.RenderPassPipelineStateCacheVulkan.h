@@ -20,11 +20,26 @@ private:
 
 	vk::Device device_;
 	ReferenceObject* owner_ = nullptr;
+	bool isDynamicRenderingEnabled_ = false;
+
 public:
-	RenderPassPipelineStateCacheVulkan(vk::Device device, ReferenceObject* owner);
+	/**
+		@param	isDynamicRenderingEnabled	whether render passes without subpasses are begun with VK_KHR_dynamic_rendering
+	*/
+	RenderPassPipelineStateCacheVulkan(vk::Device device, ReferenceObject* owner, bool isDynamicRenderingEnabled = false);
 	virtual ~RenderPassPipelineStateCacheVulkan();
 
-	RenderPassPipelineStateVulkan* Create(bool isPresentMode, bool hasDepth, const FixedSizeVector<vk::Format, RenderTargetMax>& formats, bool isColorCleared, bool isDepthCleared);
+	RenderPassPipelineStateVulkan* Create(const RenderPassPipelineStateVulkanKey& key);
+
+	/**
+		@brief	create with actions which are same as RenderPass::SetIsColorCleared and RenderPass::SetIsDepthCleared
+	*/
+	RenderPassPipelineStateVulkan* Create(bool isPresentMode,
+										  bool hasDepth,
+										  const FixedSizeVector<vk::Format, RenderTargetMax>& formats,
+										  bool isColorCleared,
+										  bool isDepthCleared,
+										  int32_t samplingCount = 1);
 };
 
 } // namespace LLGI
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "LLGI.BaseVulkan.h"
 #include "LLGI.CommandListVulkan.h"
 #include "LLGI.ConstantBufferVulkan.h"
+#include "LLGI.FramebufferCacheVulkan.h"
 #include "LLGI.GraphicsVulkan.h"
 #include "LLGI.IndexBufferVulkan.h"
 #include "LLGI.PipelineStateVulkan.h"
@@ -24,19 +25,19 @@ RenderPassVulkan::RenderPassVulkan(RenderPassPipelineStateCacheVulkan* renderPas
 
 RenderPassVulkan::~RenderPassVulkan()
 {
-	if (frameBuffer_)
-	{
-		device_.destroyFramebuffer(frameBuffer_);
-	}
-
+	// a framebuffer is destroyed with textures because it may be used by command lists in flight
+	SafeRelease(framebufferCache_);
 	SafeRelease(renderPassPipelineState);
 	SafeRelease(renderPassPipelineStateCache_);
 	SafeRelease(owner_);
 }
 
-bool RenderPassVulkan::Initialize(const TextureVulkan** textures, int32_t textureCount, TextureVulkan* depthTexture)
+bool RenderPassVulkan::Initialize(const TextureVulkan** textures,
+								  int32_t textureCount,
+								  TextureVulkan* depthTexture,
+								  FramebufferCacheVulkan* framebufferCache)
 {
-	if (textureCount == 0)
+	if (textureCount == 0 || framebufferCache == nullptr)
 		return false;
 
 	if (!assignRenderTextures((Texture**)(textures), textureCount))
@@ -68,34 +69,77 @@ bool RenderPassVulkan::Initialize(const TextureVulkan** textures, int32_t textur
 		renderTargetProperties.at(i).format = textures[i]->GetVulkanFormat();
 	}
 
-	FixedSizeVector<vk::ImageView, RenderTargetMax + 1> views;
-	views.resize(textureCount + (GetHasDepthTexture() ? 1 : 0));
+	samplingCount_ = textures[0]->GetSamplingCount();
+
+	for (int32_t i = 0; i < textureCount; i++)
+	{
+		if (textures[i]->GetSamplingCount() != samplingCount_)
+		{
+			Log(LogType::Error, "RenderPass : Sampling counts of textures are different.");
+			return false;
+		}
+	}
+
+	if (depthTexture != nullptr && depthTexture->GetSamplingCount() != samplingCount_)
+	{
+		Log(LogType::Error, "RenderPass : A sampling count of a depth texture is different.");
+		return false;
+	}
+
+	// multisampled colors are resolved into textures
+	const bool isMultisampled = samplingCount_ > 1;
+	const int32_t resolveOffset = textureCount + (GetHasDepthTexture() ? 1 : 0);
+
+	auto& views = framebufferViews_;
+	views.resize(resolveOffset + (isMultisampled ? textureCount : 0));
 
 	for (int32_t i = 0; i < textureCount; i++)
 	{
-		views.at(i) = textures[i]->GetView();
+		views.at(i) = static_cast<VkImageView>(textures[i]->GetAttachmentView());
+
+		if (isMultisampled)
+		{
+			views.at(resolveOffset + i) = static_cast<VkImageView>(textures[i]->GetView());
+		}
 	}
 
 	if (GetHasDepthTexture())
 	{
-		views.at(textureCount) = depthTexture->GetView();
+		views.at(textureCount) = static_cast<VkImageView>(depthTexture->GetView());
 	}
 
 	ResetRenderPassPipelineState();
 
-	vk::FramebufferCreateInfo framebufferCreateInfo;
-	framebufferCreateInfo.renderPass = renderPassPipelineState->GetRenderPass();
-	framebufferCreateInfo.attachmentCount = static_cast<uint32_t>(views.size());
-	framebufferCreateInfo.pAttachments = views.data();
-	framebufferCreateInfo.width = screenSize_.X;
-	framebufferCreateInfo.height = screenSize_.Y;
-	framebufferCreateInfo.layers = 1;
+	SafeAssign(framebufferCache_, framebufferCache);
 
-	frameBuffer_ = device_.createFramebuffer(framebufferCreateInfo);
+	for (int32_t i = 0; i < textureCount; i++)
+	{
+		const_cast<TextureVulkan*>(textures[i])->SetFramebufferCache(framebufferCache_);
+	}
+
+	if (GetHasDepthTexture())
+	{
+		depthTexture->SetFramebufferCache(framebufferCache_);
+	}
+
+	ResetFramebuffer();
 
 	return true;
 }
 
+void RenderPassVulkan::ResetFramebuffer()
+{
+	// views are specified when rendering begins
+	if (renderPassPipelineState->GetIsDynamicRendering())
+	{
+		frameBuffer_ = nullptr;
+		return;
+	}
+
+	// a previous framebuffer is kept in the cache because command lists in flight may use it
+	frameBuffer_ = framebufferCache_->Get(renderPassPipelineState->GetRenderPass(), framebufferViews_, screenSize_, GetSubpasses());
+}
+
 Vec2I RenderPassVulkan::GetImageSize() const { return screenSize_; }
 
 void RenderPassVulkan::SetIsColorCleared(bool isColorCleared)
@@ -110,19 +154,56 @@ void RenderPassVulkan::SetIsDepthCleared(bool isDepthCleared)
 	ResetRenderPassPipelineState();
 }
 
+void RenderPassVulkan::SetColorAction(int32_t index, AttachmentLoadOp loadOp, AttachmentStoreOp storeOp)
+{
+	RenderPass::SetColorAction(index, loadOp, storeOp);
+	ResetRenderPassPipelineState();
+}
+
+void RenderPassVulkan::SetDepthAction(AttachmentLoadOp loadOp, AttachmentStoreOp storeOp)
+{
+	RenderPass::SetDepthAction(loadOp, storeOp);
+	ResetRenderPassPipelineState();
+}
+
+bool RenderPassVulkan::SetSubpasses(const SubpassParameter* subpasses, int32_t count)
+{
+	if (!RenderPass::SetSubpasses(subpasses, count))
+		return false;
+
+	// a framebuffer is not compatible with render passes which have other subpasses
+	ResetRenderPassPipelineState();
+	ResetFramebuffer();
+	return true;
+}
+
 void RenderPassVulkan::ResetRenderPassPipelineState()
 {
 	SafeRelease(renderPassPipelineState);
 
-	FixedSizeVector<vk::Format, RenderTargetMax> formats;
-	formats.resize(renderTargetProperties.size());
+	RenderPassPipelineStateVulkanKey key;
+	key.isPresentMode = GetIsSwapchainScreen();
+	key.hasDepth = GetHasDepthTexture();
+	key.samplingCount = samplingCount_;
+	key.formats.resize(renderTargetProperties.size());
+	key.colorLoadOps.resize(renderTargetProperties.size());
+	key.colorStoreOps.resize(renderTargetProperties.size());
 	for (int32_t i = 0; i < renderTargetProperties.size(); i++)
 	{
-		formats.at(i) = renderTargetProperties.at(i).colorBufferPtr->GetVulkanFormat();
+		key.formats.at(i) = renderTargetProperties.at(i).colorBufferPtr->GetVulkanFormat();
+		key.colorLoadOps.at(i) = GetColorLoadOp(i);
+		key.colorStoreOps.at(i) = GetColorStoreOp(i);
+	}
+
+	if (key.hasDepth)
+	{
+		key.depthLoadOp = GetDepthLoadOp();
+		key.depthStoreOp = GetDepthStoreOp();
 	}
 
-	this->renderPassPipelineState = renderPassPipelineStateCache_->Create(
-		GetIsSwapchainScreen(), GetHasDepthTexture(), formats, GetIsColorCleared(), GetIsDepthCleared());
+	key.subpasses = GetSubpasses();
+
+	this->renderPassPipelineState = renderPassPipelineStateCache_->Create(key);
 }
 
 RenderPassPipelineStateVulkan::RenderPassPipelineStateVulkan(vk::Device device, ReferenceObject* owner)
@@ -144,4 +225,24 @@ RenderPassPipelineStateVulkan::~RenderPassPipelineStateVulkan()
 
 vk::RenderPass RenderPassPipelineStateVulkan::GetRenderPass() const { return renderPass_; }
 
+int32_t RenderPassPipelineStateVulkan::GetColorAttachmentCount(int32_t subpass) const
+{
+	if (Key.subpasses.size() == 0)
+		return static_cast<int32_t>(Key.formats.size());
+
+	if (subpass < 0 || subpass >= static_cast<int32_t>(Key.subpasses.size()))
+		return 0;
+
+	int32_t count = 0;
+	for (size_t i = 0; i < Key.formats.size(); i++)
+	{
+		if ((Key.subpasses.at(subpass).ColorAttachmentMask & (1 << i)) != 0)
+		{
+			count++;
+		}
+	}
+
+	return count;
+}
+
 } // namespace LLGI
@@ -13,13 +13,19 @@ class RenderPassVulkan;
 class RenderPassPipelineStateVulkan;
 class RenderPassPipelineStateCacheVulkan;
 class TextureVulkan;
+class FramebufferCacheVulkan;
 
 class RenderPassVulkan : public RenderPass
 {
 private:
 	RenderPassPipelineStateCacheVulkan* renderPassPipelineStateCache_ = nullptr;
+	FramebufferCacheVulkan* framebufferCache_ = nullptr;
 	vk::Device device_;
 	ReferenceObject* owner_ = nullptr;
+	int32_t samplingCount_ = 1;
+
+	//! views of attachments of a framebuffer. multisampled colors, a depth and resolved colors
+	FixedSizeVector<VkImageView, RenderTargetMax * 2 + 1> framebufferViews_;
 
 	std::shared_ptr<TextureVulkan> depthBufferPtr;
 
@@ -42,7 +48,13 @@ public:
 	RenderPassVulkan(RenderPassPipelineStateCacheVulkan* renderPassPipelineStateCache, vk::Device device, ReferenceObject* owner);
 	virtual ~RenderPassVulkan();
 
-	bool Initialize(const TextureVulkan** textures, int32_t textureCount, TextureVulkan* depthTexture);
+	/**
+		@param	framebufferCache	a cache which owns a framebuffer until textures are destroyed
+	*/
+	bool Initialize(const TextureVulkan** textures,
+					int32_t textureCount,
+					TextureVulkan* depthTexture,
+					FramebufferCacheVulkan* framebufferCache);
 
 	Vec2I GetImageSize() const;
 
@@ -50,25 +62,16 @@ public:
 
 	virtual void SetIsDepthCleared(bool isDepthCleared) override;
 
-private:
-	void ResetRenderPassPipelineState();
-};
+	virtual void SetColorAction(int32_t index, AttachmentLoadOp loadOp, AttachmentStoreOp storeOp) override;
 
-class RenderPassPipelineStateVulkan : public RenderPassPipelineState
-{
-private:
-	vk::Device device_;
-	ReferenceObject* owner_ = nullptr;
-
-public:
-	RenderPassPipelineStateVulkan(vk::Device device, ReferenceObject* owner);
+	virtual void SetDepthAction(AttachmentLoadOp loadOp, AttachmentStoreOp storeOp) override;
 
-	virtual ~RenderPassPipelineStateVulkan();
+	virtual bool SetSubpasses(const SubpassParameter* subpasses, int32_t count) override;
 
-	vk::RenderPass renderPass_;
-	FixedSizeVector<vk::ImageLayout, RenderTargetMax + 1> finalLayouts_;
+private:
+	void ResetRenderPassPipelineState();
 
-	vk::RenderPass GetRenderPass() const;
+	void ResetFramebuffer();
 };
 
 struct RenderPassPipelineStateVulkanKey
@@ -76,13 +79,22 @@ struct RenderPassPipelineStateVulkanKey
 	bool isPresentMode;
 	FixedSizeVector<vk::Format, RenderTargetMax> formats;
 	bool hasDepth;
-	bool isColorCleared;
-	bool isDepthCleared;
+	FixedSizeVector<AttachmentLoadOp, RenderTargetMax> colorLoadOps;
+	FixedSizeVector<AttachmentStoreOp, RenderTargetMax> colorStoreOps;
+	AttachmentLoadOp depthLoadOp = AttachmentLoadOp::Load;
+	AttachmentStoreOp depthStoreOp = AttachmentStoreOp::Store;
+
+	//! colors are resolved if it is larger than 1
+	int32_t samplingCount = 1;
+
+	//! one subpass which writes all attachments is created if it is empty
+	FixedSizeVector<SubpassParameter, SubpassMax> subpasses;
 
 	bool operator==(const RenderPassPipelineStateVulkanKey& value) const
 	{
 		return (isPresentMode == value.isPresentMode && hasDepth == value.hasDepth && formats == value.formats &&
-				isColorCleared == value.isColorCleared && isDepthCleared == value.isDepthCleared);
+				colorLoadOps == value.colorLoadOps && colorStoreOps == value.colorStoreOps && depthLoadOp == value.depthLoadOp &&
+				depthStoreOp == value.depthStoreOp && samplingCount == value.samplingCount && subpasses == value.subpasses);
 	}
 
 	struct Hash
@@ -91,10 +103,59 @@ struct RenderPassPipelineStateVulkanKey
 
 		std::size_t operator()(const RenderPassPipelineStateVulkanKey& key) const
 		{
-			return key.formats.get_hash() + std::hash<bool>()(key.isPresentMode) + std::hash<bool>()(key.hasDepth) +
-				   std::hash<bool>()(key.isColorCleared) + std::hash<bool>()(key.isDepthCleared);
+			auto ret = key.formats.get_hash() + std::hash<bool>()(key.isPresentMode) + std::hash<bool>()(key.hasDepth);
+
+			for (size_t i = 0; i < key.colorLoadOps.size(); i++)
+			{
+				ret = ret * 31 + static_cast<std::size_t>(key.colorLoadOps.at(i)) * 3 + static_cast<std::size_t>(key.colorStoreOps.at(i));
+			}
+
+			ret = ret * 31 + static_cast<std::size_t>(key.depthLoadOp) * 3 + static_cast<std::size_t>(key.depthStoreOp);
+			ret = ret * 31 + static_cast<std::size_t>(key.samplingCount);
+
+			for (size_t i = 0; i < key.subpasses.size(); i++)
+			{
+				const auto& subpass = key.subpasses.at(i);
+				ret = ret * 31 + static_cast<std::size_t>(subpass.ColorAttachmentMask);
+				ret = ret * 31 + static_cast<std::size_t>(subpass.InputAttachmentMask);
+				ret = ret * 31 + static_cast<std::size_t>(subpass.IsDepthUsed) * 2 + static_cast<std::size_t>(subpass.IsDepthInput);
+			}
+
+			return ret;
 		}
 	};
 };
 
+class RenderPassPipelineStateVulkan : public RenderPassPipelineState
+{
+private:
+	vk::Device device_;
+	ReferenceObject* owner_ = nullptr;
+
+public:
+	RenderPassPipelineStateVulkan(vk::Device device, ReferenceObject* owner);
+
+	virtual ~RenderPassPipelineStateVulkan();
+
+	vk::RenderPass renderPass_;
+	FixedSizeVector<vk::ImageLayout, RenderTargetMax + 1> finalLayouts_;
+
+	//! a key which this is created with
+	RenderPassPipelineStateVulkanKey Key;
+
+	vk::RenderPass GetRenderPass() const;
+
+	/**
+		@brief	whether attachments are rendered with VK_KHR_dynamic_rendering instead of a render pass
+		@note
+		Colors are in VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL while rendering and transitioned into finalLayouts_ after it.
+	*/
+	bool GetIsDynamicRendering() const { return !renderPass_; }
+
+	/**
+		@brief	get the number of color attachments which a subpass writes
+	*/
+	int32_t GetColorAttachmentCount(int32_t subpass) const;
+};
+
 } // namespace LLGI
@@ -0,0 +1,197 @@
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "LLGI.GraphicsVulkan.h"
+#include "LLGI.ShaderPackVulkan.h"
+#include "LLGI.ShaderVulkan.h"
+
+namespace LLGI
+{
+
+ShaderPackVulkan::~ShaderPackVulkan()
+{
+	for (auto& shader : shaders_)
+	{
+		SafeRelease(shader.second);
+	}
+	shaders_.clear();
+
+	Unmap();
+	SafeRelease(graphics_);
+}
+
+bool ShaderPackVulkan::Map(const char* path)
+{
+#ifdef _WIN32
+	auto file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	file_ = file;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+		return false;
+
+	mapping_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping_ == nullptr)
+		return false;
+
+	data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+	if (data_ == nullptr)
+		return false;
+
+	size_ = static_cast<size_t>(size.QuadPart);
+#else
+	auto fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0)
+	{
+		close(fd);
+		return false;
+	}
+
+	// a mapping is kept after the descriptor is closed
+	auto data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (data == MAP_FAILED)
+		return false;
+
+	data_ = static_cast<const uint8_t*>(data);
+	size_ = static_cast<size_t>(st.st_size);
+#endif
+
+	return true;
+}
+
+void ShaderPackVulkan::Unmap()
+{
+#ifdef _WIN32
+	if (data_ != nullptr)
+	{
+		UnmapViewOfFile(data_);
+	}
+
+	if (mapping_ != nullptr)
+	{
+		CloseHandle(mapping_);
+		mapping_ = nullptr;
+	}
+
+	if (file_ != nullptr)
+	{
+		CloseHandle(file_);
+		file_ = nullptr;
+	}
+#else
+	if (data_ != nullptr)
+	{
+		munmap(const_cast<uint8_t*>(data_), size_);
+	}
+#endif
+
+	data_ = nullptr;
+	size_ = 0;
+	entries_ = nullptr;
+	entryCount_ = 0;
+}
+
+bool ShaderPackVulkan::Initialize(GraphicsVulkan* graphics, const char* path)
+{
+	SafeAddRef(graphics);
+	SafeRelease(graphics_);
+	graphics_ = graphics;
+
+	if (!Map(path))
+	{
+		Log(LogType::Error, "Failed to map a shader pack.");
+		Unmap();
+		return false;
+	}
+
+	ShaderPackHeader header;
+	if (size_ < sizeof(ShaderPackHeader))
+	{
+		Log(LogType::Error, "A shader pack is broken.");
+		Unmap();
+		return false;
+	}
+
+	memcpy(&header, data_, sizeof(ShaderPackHeader));
+
+	if (memcmp(header.Magic, ShaderPackMagic, sizeof(ShaderPackMagic)) != 0 || header.Version != ShaderPackVersion)
+	{
+		Log(LogType::Error, "A version of a shader pack is not supported.");
+		Unmap();
+		return false;
+	}
+
+	if (sizeof(ShaderPackHeader) + sizeof(ShaderPackEntry) * static_cast<uint64_t>(header.EntryCount) > size_)
+	{
+		Log(LogType::Error, "A shader pack is broken.");
+		Unmap();
+		return false;
+	}
+
+	// entries are aligned because the mapping is aligned to a page
+	entries_ = reinterpret_cast<const ShaderPackEntry*>(data_ + sizeof(ShaderPackHeader));
+	entryCount_ = header.EntryCount;
+
+	for (uint32_t i = 0; i < entryCount_; i++)
+	{
+		const auto& entry = entries_[i];
+		if (entry.Offset % sizeof(uint32_t) != 0 || entry.Offset > size_ || entry.Size > size_ - entry.Offset)
+		{
+			Log(LogType::Error, "A shader pack is broken.");
+			Unmap();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+Shader* ShaderPackVulkan::GetShader(const char* name)
+{
+	auto hash = GetShaderPackNameHash(name);
+
+	std::lock_guard<std::mutex> lock(mtx_);
+
+	auto it = shaders_.find(hash);
+	if (it != shaders_.end())
+	{
+		return it->second;
+	}
+
+	auto end = entries_ + entryCount_;
+	auto entry = std::lower_bound(entries_, end, hash, [](const ShaderPackEntry& e, uint64_t h) { return e.NameHash < h; });
+	if (entry == end || entry->NameHash != hash)
+	{
+		return nullptr;
+	}
+
+	// hashes are calculated when the pack is written, and the mapped binary is given without copying it
+	auto code = data_ + entry->Offset;
+	auto size = static_cast<size_t>(entry->Size);
+	auto shader = graphics_->CreateShader(code, size, entry->BinaryHash, entry->ContentHash);
+	if (shader == nullptr)
+	{
+		return nullptr;
+	}
+
+	shaders_[hash] = shader;
+	return shader;
+}
+
+} // namespace LLGI
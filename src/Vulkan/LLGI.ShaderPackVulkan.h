@@ -0,0 +1,60 @@
+
+#pragma once
+
+#include "../Utils/LLGI.ShaderPack.h"
+#include "LLGI.BaseVulkan.h"
+#include <mutex>
+#include <unordered_map>
+
+namespace LLGI
+{
+
+class GraphicsVulkan;
+class ShaderVulkan;
+
+/**
+	@brief	shaders which are loaded from a pack written by WriteShaderPack
+	@note
+	A file is mapped into memory and a module of a shader is created from the mapped memory when it is requested at first.
+	It is thread safe.
+*/
+class ShaderPackVulkan : public ReferenceObject
+{
+private:
+	GraphicsVulkan* graphics_ = nullptr;
+
+	const uint8_t* data_ = nullptr;
+	size_t size_ = 0;
+
+#ifdef _WIN32
+	void* file_ = nullptr;
+	void* mapping_ = nullptr;
+#endif
+
+	const ShaderPackEntry* entries_ = nullptr;
+	uint32_t entryCount_ = 0;
+
+	std::mutex mtx_;
+	std::unordered_map<uint64_t, ShaderVulkan*> shaders_;
+
+	bool Map(const char* path);
+	void Unmap();
+
+public:
+	ShaderPackVulkan() = default;
+	virtual ~ShaderPackVulkan();
+
+	bool Initialize(GraphicsVulkan* graphics, const char* path);
+
+	int32_t GetShaderCount() const { return static_cast<int32_t>(entryCount_); }
+
+	/**
+		@brief	get a shader with a name which is specified when the pack is written
+		@note
+		A shader is owned by the pack. Call AddRef to use it after the pack is released.
+		nullptr is returned if the shader is not found.
+	*/
+	Shader* GetShader(const char* name);
+};
+
+} // namespace LLGI
@@ -0,0 +1,399 @@
+#include "LLGI.ShaderReflectionVulkan.h"
+#include <algorithm>
+#include <string.h>
+#include <unordered_map>
+
+namespace LLGI
+{
+
+namespace
+{
+
+// values in the SPIR-V specification
+const uint32_t SpvMagicNumber = 0x07230203;
+
+const uint32_t SpvOpName = 5;
+const uint32_t SpvOpDecorate = 71;
+const uint32_t SpvOpMemberDecorate = 72;
+const uint32_t SpvOpTypeBool = 20;
+const uint32_t SpvOpTypeInt = 21;
+const uint32_t SpvOpTypeFloat = 22;
+const uint32_t SpvOpTypeVector = 23;
+const uint32_t SpvOpTypeMatrix = 24;
+const uint32_t SpvOpTypeImage = 25;
+const uint32_t SpvOpTypeSampledImage = 27;
+const uint32_t SpvOpTypeArray = 28;
+const uint32_t SpvOpTypeStruct = 30;
+const uint32_t SpvOpTypePointer = 32;
+const uint32_t SpvOpConstant = 43;
+const uint32_t SpvOpVariable = 59;
+
+const uint32_t SpvDecorationBlock = 2;
+const uint32_t SpvDecorationArrayStride = 6;
+const uint32_t SpvDecorationMatrixStride = 7;
+const uint32_t SpvDecorationBuiltIn = 11;
+const uint32_t SpvDecorationLocation = 30;
+const uint32_t SpvDecorationBinding = 33;
+const uint32_t SpvDecorationDescriptorSet = 34;
+const uint32_t SpvDecorationOffset = 35;
+
+const uint32_t SpvDimSubpassData = 6;
+
+const uint32_t SpvStorageClassUniformConstant = 0;
+const uint32_t SpvStorageClassInput = 1;
+const uint32_t SpvStorageClassUniform = 2;
+const uint32_t SpvStorageClassPushConstant = 9;
+const uint32_t SpvStorageClassStorageBuffer = 12;
+
+struct SpvType
+{
+	uint32_t Op = 0;
+
+	//! a width of scalars, a count of vectors, matrices and arrays, a dimension of images
+	uint32_t Count = 0;
+	uint32_t ElementType = 0;
+	uint32_t StorageClass = 0;
+	std::vector<uint32_t> Members;
+};
+
+struct SpvDecorations
+{
+	std::unordered_map<uint32_t, uint32_t> Values;
+	std::unordered_map<uint32_t, std::unordered_map<uint32_t, uint32_t>> MemberValues;
+
+	bool Has(uint32_t decoration) const { return Values.count(decoration) > 0; }
+
+	uint32_t Get(uint32_t decoration) const
+	{
+		auto it = Values.find(decoration);
+		return it != Values.end() ? it->second : 0;
+	}
+
+	bool GetMember(uint32_t member, uint32_t decoration, uint32_t& value) const
+	{
+		auto it = MemberValues.find(member);
+		if (it == MemberValues.end())
+			return false;
+
+		auto it2 = it->second.find(decoration);
+		if (it2 == it->second.end())
+			return false;
+
+		value = it2->second;
+		return true;
+	}
+};
+
+struct SpvModule
+{
+	std::unordered_map<uint32_t, SpvType> Types;
+	std::unordered_map<uint32_t, uint32_t> Constants;
+	std::unordered_map<uint32_t, SpvDecorations> Decorations;
+	std::unordered_map<uint32_t, std::string> Names;
+
+	//! pairs of a pointer type and an id
+	std::vector<std::pair<uint32_t, uint32_t>> Variables;
+
+	const SpvType* GetType(uint32_t id) const
+	{
+		auto it = Types.find(id);
+		return it != Types.end() ? &it->second : nullptr;
+	}
+
+	const SpvDecorations& GetDecorations(uint32_t id) const
+	{
+		static const SpvDecorations empty;
+		auto it = Decorations.find(id);
+		return it != Decorations.end() ? it->second : empty;
+	}
+
+	//! get the smallest offset of members of a struct
+	uint32_t GetOffset(uint32_t typeId) const
+	{
+		auto type = GetType(typeId);
+		if (type == nullptr || type->Op != SpvOpTypeStruct || type->Members.size() == 0)
+			return 0;
+
+		auto& decorations = GetDecorations(typeId);
+		uint32_t ret = UINT32_MAX;
+		for (size_t i = 0; i < type->Members.size(); i++)
+		{
+			uint32_t offset = 0;
+			decorations.GetMember(static_cast<uint32_t>(i), SpvDecorationOffset, offset);
+			ret = std::min(ret, offset);
+		}
+		return ret;
+	}
+
+	uint32_t GetSize(uint32_t typeId, uint32_t matrixStride) const
+	{
+		auto type = GetType(typeId);
+		if (type == nullptr)
+			return 0;
+
+		switch (type->Op)
+		{
+		case SpvOpTypeBool:
+			return 4;
+		case SpvOpTypeInt:
+		case SpvOpTypeFloat:
+			return type->Count / 8;
+		case SpvOpTypeVector:
+			return type->Count * GetSize(type->ElementType, 0);
+		case SpvOpTypeMatrix:
+			return type->Count * (matrixStride > 0 ? matrixStride : GetSize(type->ElementType, 0));
+		case SpvOpTypeArray:
+		{
+			auto it = Constants.find(type->Count);
+			auto length = it != Constants.end() ? it->second : 0;
+			auto& decorations = GetDecorations(typeId);
+			auto stride = decorations.Has(SpvDecorationArrayStride) ? decorations.Get(SpvDecorationArrayStride)
+																	 : GetSize(type->ElementType, matrixStride);
+			return length * stride;
+		}
+		case SpvOpTypeStruct:
+		{
+			auto& decorations = GetDecorations(typeId);
+			uint32_t size = 0;
+			for (size_t i = 0; i < type->Members.size(); i++)
+			{
+				uint32_t offset = 0;
+				uint32_t memberMatrixStride = 0;
+				decorations.GetMember(static_cast<uint32_t>(i), SpvDecorationOffset, offset);
+				decorations.GetMember(static_cast<uint32_t>(i), SpvDecorationMatrixStride, memberMatrixStride);
+				size = std::max(size, offset + GetSize(type->Members[i], memberMatrixStride));
+			}
+			return size;
+		}
+		default:
+			return 0;
+		}
+	}
+};
+
+} // namespace
+
+bool ShaderReflectionVulkan::Initialize(const void* data, size_t size)
+{
+	VertexInputs.clear();
+	Bindings.clear();
+	PushConstantOffset = 0;
+	PushConstantSize = 0;
+
+	if (size < sizeof(uint32_t) * 5 || size % sizeof(uint32_t) != 0)
+		return false;
+
+	std::vector<uint32_t> words(size / sizeof(uint32_t));
+	memcpy(words.data(), data, size);
+
+	if (words[0] != SpvMagicNumber)
+		return false;
+
+	SpvModule module;
+
+	// parse instructions which are required
+	for (size_t i = 5; i < words.size();)
+	{
+		auto op = words[i] & 0xFFFF;
+		auto count = words[i] >> 16;
+		if (count == 0 || i + count > words.size())
+			return false;
+
+		const uint32_t* operands = &words[i + 1];
+		auto operandCount = count - 1;
+
+		switch (op)
+		{
+		case SpvOpName:
+			if (operandCount >= 2)
+			{
+				auto str = reinterpret_cast<const char*>(&operands[1]);
+				module.Names[operands[0]] = std::string(str, strnlen(str, (operandCount - 1) * sizeof(uint32_t)));
+			}
+			break;
+		case SpvOpDecorate:
+			if (operandCount >= 2)
+			{
+				module.Decorations[operands[0]].Values[operands[1]] = operandCount >= 3 ? operands[2] : 0;
+			}
+			break;
+		case SpvOpMemberDecorate:
+			if (operandCount >= 3)
+			{
+				module.Decorations[operands[0]].MemberValues[operands[1]][operands[2]] = operandCount >= 4 ? operands[3] : 0;
+			}
+			break;
+		case SpvOpTypeBool:
+		case SpvOpTypeSampledImage:
+			if (operandCount >= 1)
+			{
+				module.Types[operands[0]].Op = op;
+			}
+			break;
+		case SpvOpTypeInt:
+		case SpvOpTypeFloat:
+			if (operandCount >= 2)
+			{
+				auto& type = module.Types[operands[0]];
+				type.Op = op;
+				type.Count = operands[1];
+			}
+			break;
+		case SpvOpTypeImage:
+			if (operandCount >= 3)
+			{
+				auto& type = module.Types[operands[0]];
+				type.Op = op;
+				type.ElementType = operands[1];
+				type.Count = operands[2];
+			}
+			break;
+		case SpvOpTypeVector:
+		case SpvOpTypeMatrix:
+		case SpvOpTypeArray:
+			if (operandCount >= 3)
+			{
+				auto& type = module.Types[operands[0]];
+				type.Op = op;
+				type.ElementType = operands[1];
+				type.Count = operands[2];
+			}
+			break;
+		case SpvOpTypeStruct:
+			if (operandCount >= 1)
+			{
+				auto& type = module.Types[operands[0]];
+				type.Op = op;
+				type.Members.assign(operands + 1, operands + operandCount);
+			}
+			break;
+		case SpvOpTypePointer:
+			if (operandCount >= 3)
+			{
+				auto& type = module.Types[operands[0]];
+				type.Op = op;
+				type.StorageClass = operands[1];
+				type.ElementType = operands[2];
+			}
+			break;
+		case SpvOpConstant:
+			if (operandCount >= 3)
+			{
+				module.Constants[operands[1]] = operands[2];
+			}
+			break;
+		case SpvOpVariable:
+			if (operandCount >= 3)
+			{
+				module.Variables.push_back(std::make_pair(operands[0], operands[1]));
+			}
+			break;
+		default:
+			break;
+		}
+
+		i += count;
+	}
+
+	for (const auto& variable : module.Variables)
+	{
+		auto pointer = module.GetType(variable.first);
+		if (pointer == nullptr || pointer->Op != SpvOpTypePointer)
+			continue;
+
+		const auto& decorations = module.GetDecorations(variable.second);
+
+		// unwrap arrays of resources
+		auto typeId = pointer->ElementType;
+		auto type = module.GetType(typeId);
+		while (type != nullptr && type->Op == SpvOpTypeArray)
+		{
+			typeId = type->ElementType;
+			type = module.GetType(typeId);
+		}
+
+		if (type == nullptr)
+			continue;
+
+		if (pointer->StorageClass == SpvStorageClassInput)
+		{
+			if (decorations.Has(SpvDecorationBuiltIn) || !decorations.Has(SpvDecorationLocation))
+				continue;
+
+			VertexInput input;
+			input.Location = static_cast<int32_t>(decorations.Get(SpvDecorationLocation));
+
+			auto it = module.Names.find(variable.second);
+			if (it != module.Names.end())
+			{
+				input.Name = it->second;
+			}
+
+			auto componentType = type;
+			input.ComponentCount = 1;
+			if (type->Op == SpvOpTypeVector)
+			{
+				input.ComponentCount = static_cast<int32_t>(type->Count);
+				componentType = module.GetType(type->ElementType);
+			}
+
+			input.IsFloat = componentType != nullptr && componentType->Op == SpvOpTypeFloat;
+			VertexInputs.push_back(input);
+		}
+		else if (pointer->StorageClass == SpvStorageClassPushConstant)
+		{
+			PushConstantSize = std::max(PushConstantSize, static_cast<int32_t>(module.GetSize(typeId, 0)));
+			PushConstantOffset = static_cast<int32_t>(module.GetOffset(typeId));
+		}
+		else if (pointer->StorageClass == SpvStorageClassUniformConstant || pointer->StorageClass == SpvStorageClassUniform ||
+				 pointer->StorageClass == SpvStorageClassStorageBuffer)
+		{
+			Binding binding;
+			binding.Set = static_cast<int32_t>(decorations.Get(SpvDecorationDescriptorSet));
+			binding.Binding = static_cast<int32_t>(decorations.Get(SpvDecorationBinding));
+
+			if (type->Op == SpvOpTypeSampledImage)
+			{
+				binding.Type = ShaderBindingTypeVulkan::CombinedImageSampler;
+			}
+			else if (type->Op == SpvOpTypeImage && type->Count == SpvDimSubpassData)
+			{
+				binding.Type = ShaderBindingTypeVulkan::InputAttachment;
+			}
+			else if (pointer->StorageClass == SpvStorageClassUniform && module.GetDecorations(typeId).Has(SpvDecorationBlock))
+			{
+				binding.Type = ShaderBindingTypeVulkan::UniformBuffer;
+				binding.Size = static_cast<int32_t>(module.GetSize(typeId, 0));
+			}
+
+			Bindings.push_back(binding);
+		}
+	}
+
+	std::sort(VertexInputs.begin(), VertexInputs.end(), [](const VertexInput& a, const VertexInput& b) { return a.Location < b.Location; });
+
+	return true;
+}
+
+bool ShaderReflectionVulkan::GetVertexLayoutFormat(const VertexInput& input, VertexLayoutFormat& format)
+{
+	if (!input.IsFloat)
+		return false;
+
+	switch (input.ComponentCount)
+	{
+	case 2:
+		format = VertexLayoutFormat::R32G32_FLOAT;
+		return true;
+	case 3:
+		format = VertexLayoutFormat::R32G32B32_FLOAT;
+		return true;
+	case 4:
+		format = VertexLayoutFormat::R32G32B32A32_FLOAT;
+		return true;
+	default:
+		return false;
+	}
+}
+
+} // namespace LLGI
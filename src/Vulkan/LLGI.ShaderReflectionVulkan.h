@@ -0,0 +1,68 @@
+
+#pragma once
+
+#include "../LLGI.Base.h"
+
+namespace LLGI
+{
+
+enum class ShaderBindingTypeVulkan
+{
+	UniformBuffer,
+	CombinedImageSampler,
+
+	//! an attachment which is written by a previous subpass
+	InputAttachment,
+	Other,
+};
+
+/**
+	@brief	resources which a SPIR-V module declares
+	@note
+	Only what LLGI binds is reflected. It does not depend on SPIRV-Cross, so it is available without a compiler.
+*/
+class ShaderReflectionVulkan
+{
+public:
+	struct VertexInput
+	{
+		int32_t Location = 0;
+		std::string Name;
+
+		//! the number of 32bit components
+		int32_t ComponentCount = 0;
+
+		bool IsFloat = true;
+	};
+
+	struct Binding
+	{
+		int32_t Set = 0;
+		int32_t Binding = 0;
+		ShaderBindingTypeVulkan Type = ShaderBindingTypeVulkan::Other;
+
+		//! the size of a uniform block in bytes
+		int32_t Size = 0;
+	};
+
+	//! inputs which are not built-in variables, sorted by location
+	std::vector<VertexInput> VertexInputs;
+
+	std::vector<Binding> Bindings;
+
+	//! the offset of the first member of a push constant block in bytes
+	int32_t PushConstantOffset = 0;
+
+	//! the end of members of a push constant block in bytes. it is 0 if there is no block
+	int32_t PushConstantSize = 0;
+
+	bool Initialize(const void* data, size_t size);
+
+	/**
+		@brief	get a format of a vertex input which is filled with floats
+		@return	false if there is no format for the input
+	*/
+	static bool GetVertexLayoutFormat(const VertexInput& input, VertexLayoutFormat& format);
+};
+
+} // namespace LLGI
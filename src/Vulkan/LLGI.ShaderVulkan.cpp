@@ -9,6 +9,8 @@ ShaderVulkan::~ShaderVulkan()
 {
 	if (shaderModule_)
 	{
+		// a shader is registered into graphics only if a module is created
+		graphics_->RemoveShader(this);
 		graphics_->GetDevice().destroyShaderModule(shaderModule_);
 		shaderModule_ = nullptr;
 	}
@@ -16,23 +18,28 @@ ShaderVulkan::~ShaderVulkan()
 	SafeRelease(graphics_);
 }
 
-bool ShaderVulkan::Initialize(GraphicsVulkan* graphics, DataStructure* data, int count)
+bool ShaderVulkan::Initialize(GraphicsVulkan* graphics, const void* code, size_t size, uint64_t hash, uint64_t contentHash)
 {
-	if (count != 1)
-		return false;
-	if (data[0].Size == 0)
+	if (size == 0)
 		return false;
 
-	buffer.resize(data[0].Size);
-	memcpy(buffer.data(), data[0].Data, data[0].Size);
+	hash_ = hash;
+	contentHash_ = contentHash;
+	size_ = size;
+
+	isReflected_ = reflection_.Initialize(code, size);
+	if (!isReflected_)
+	{
+		Log(LogType::Warning, "Failed to reflect a shader. Layouts of pipelines are not optimized.");
+	}
 
 	SafeAddRef(graphics);
 	SafeRelease(graphics_);
 	graphics_ = graphics;
 
 	vk::ShaderModuleCreateInfo info;
-	info.pCode = reinterpret_cast<const uint32_t*>(buffer.data());
-	info.codeSize = buffer.size();
+	info.pCode = static_cast<const uint32_t*>(code);
+	info.codeSize = size;
 
 	shaderModule_ = graphics_->GetDevice().createShaderModule(info);
 
@@ -4,6 +4,7 @@
 #include "../LLGI.Shader.h"
 #include "LLGI.BaseVulkan.h"
 #include "LLGI.GraphicsVulkan.h"
+#include "LLGI.ShaderReflectionVulkan.h"
 
 namespace LLGI
 {
@@ -12,16 +13,46 @@ class ShaderVulkan : public Shader
 {
 private:
 	GraphicsVulkan* graphics_ = nullptr;
-	std::vector<uint8_t> buffer;
 	vk::ShaderModule shaderModule_;
+	uint64_t hash_ = 0;
+	uint64_t contentHash_ = 0;
+	size_t size_ = 0;
+	ShaderReflectionVulkan reflection_;
+	bool isReflected_ = false;
 
 public:
 	ShaderVulkan();
 	virtual ~ShaderVulkan();
 
-	bool Initialize(GraphicsVulkan* graphics, DataStructure* data, int count);
+	/**
+		@brief	create a module from a code without copying it
+		@note
+		A code must be aligned to 4 bytes. It is not referred after this function returns.
+		Use GraphicsVulkan::CreateShader to share modules which have the same code.
+	*/
+	bool Initialize(GraphicsVulkan* graphics, const void* code, size_t size, uint64_t hash, uint64_t contentHash);
 
 	vk::ShaderModule GetShaderModule() const;
+
+	/**
+		@brief	get a hash of the binary which identifies the shader across processes
+	*/
+	uint64_t GetHash() const { return hash_; }
+
+	//! get a MurmurHash64A of the binary which confirms that shaders with the same hash have the same binary
+	uint64_t GetContentHash() const { return contentHash_; }
+
+	//! get the size of the binary in bytes
+	size_t GetSize() const { return size_; }
+
+	/**
+		@brief	get resources which the shader declares
+		@note
+		It is invalid if GetIsReflected returns false.
+	*/
+	const ShaderReflectionVulkan& GetReflection() const { return reflection_; }
+
+	bool GetIsReflected() const { return isReflected_; }
 };
 
 
@@ -0,0 +1,113 @@
+#include "LLGI.TaskQueueVulkan.h"
+#include <algorithm>
+
+namespace LLGI
+{
+
+TaskQueueVulkan::TaskQueueVulkan(int32_t workerCount)
+{
+	for (int32_t i = 0; i < workerCount; i++)
+	{
+		workers_.emplace_back([this]() { Run(); });
+	}
+}
+
+TaskQueueVulkan::~TaskQueueVulkan()
+{
+	std::deque<Entry> canceled;
+
+	{
+		std::lock_guard<std::mutex> lock(mtx_);
+		isTerminated_ = true;
+		canceled.swap(tasks_);
+	}
+
+	taskAdded_.notify_all();
+
+	for (auto& worker : workers_)
+	{
+		worker.join();
+	}
+	workers_.clear();
+
+	for (auto& entry : canceled)
+	{
+		entry.Function(true);
+	}
+}
+
+void TaskQueueVulkan::Run()
+{
+	while (true)
+	{
+		Entry entry;
+
+		{
+			std::unique_lock<std::mutex> lock(mtx_);
+			taskAdded_.wait(lock, [this]() { return isTerminated_ || !tasks_.empty(); });
+
+			if (isTerminated_)
+				return;
+
+			entry = std::move(tasks_.front());
+			tasks_.pop_front();
+			runningOwners_.push_back(entry.Owner);
+		}
+
+		entry.Function(false);
+
+		{
+			std::lock_guard<std::mutex> lock(mtx_);
+			runningOwners_.erase(std::find(runningOwners_.begin(), runningOwners_.end(), entry.Owner));
+		}
+
+		taskFinished_.notify_all();
+	}
+}
+
+void TaskQueueVulkan::Push(const void* owner, const Task& task)
+{
+	{
+		std::lock_guard<std::mutex> lock(mtx_);
+
+		Entry entry;
+		entry.Owner = owner;
+		entry.Function = task;
+		tasks_.push_back(std::move(entry));
+	}
+
+	taskAdded_.notify_one();
+}
+
+void TaskQueueVulkan::Cancel(const void* owner)
+{
+	std::deque<Entry> canceled;
+
+	{
+		std::unique_lock<std::mutex> lock(mtx_);
+
+		for (auto it = tasks_.begin(); it != tasks_.end();)
+		{
+			if (it->Owner == owner)
+			{
+				canceled.push_back(std::move(*it));
+				it = tasks_.erase(it);
+			}
+			else
+			{
+				it++;
+			}
+		}
+
+		taskFinished_.wait(lock, [this, owner]() {
+			return std::find(runningOwners_.begin(), runningOwners_.end(), owner) == runningOwners_.end();
+		});
+	}
+
+	for (auto& entry : canceled)
+	{
+		entry.Function(true);
+	}
+}
+
+} // namespace LLGI
@@ -0,0 +1,60 @@
+
+#pragma once
+
+#include "../LLGI.Base.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace LLGI
+{
+
+/**
+	@brief	a queue which runs tasks on a fixed number of worker threads
+	@note
+	Tasks are tagged with owners, so that an owner can cancel its tasks which have not started before it is destroyed.
+*/
+class TaskQueueVulkan
+{
+public:
+	//! a task receives whether it is canceled. a canceled task must finish without doing work
+	using Task = std::function<void(bool isCanceled)>;
+
+private:
+	struct Entry
+	{
+		const void* Owner = nullptr;
+		Task Function;
+	};
+
+	std::mutex mtx_;
+	std::condition_variable taskAdded_;
+	std::condition_variable taskFinished_;
+	std::deque<Entry> tasks_;
+	std::vector<const void*> runningOwners_;
+	std::vector<std::thread> workers_;
+	bool isTerminated_ = false;
+
+	void Run();
+
+public:
+	explicit TaskQueueVulkan(int32_t workerCount);
+
+	//! tasks which have not started are canceled
+	~TaskQueueVulkan();
+
+	TaskQueueVulkan(const TaskQueueVulkan&) = delete;
+	TaskQueueVulkan& operator=(const TaskQueueVulkan&) = delete;
+
+	void Push(const void* owner, const Task& task);
+
+	/**
+		@brief	cancel tasks of an owner which have not started and wait for its tasks which are running
+		@note
+		Canceled tasks are called with isCanceled in this thread.
+	*/
+	void Cancel(const void* owner);
+};
+
+} // namespace LLGI
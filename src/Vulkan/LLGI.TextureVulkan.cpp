@@ -1,17 +1,86 @@
 
 #include "LLGI.TextureVulkan.h"
+#include "LLGI.FramebufferCacheVulkan.h"
+#include "LLGI.ImageBarrierBatchVulkan.h"
 
 namespace LLGI
 {
 
+ImageStateVulkan ImageStateVulkan::FromLayout(vk::ImageLayout layout)
+{
+	switch (layout)
+	{
+	case vk::ImageLayout::eUndefined:
+		return ImageStateVulkan();
+	case vk::ImageLayout::eShaderReadOnlyOptimal:
+		return ImageStateVulkan(
+			layout, vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader, vk::AccessFlagBits::eShaderRead);
+	case vk::ImageLayout::eColorAttachmentOptimal:
+		return ImageStateVulkan(layout,
+								vk::PipelineStageFlagBits::eColorAttachmentOutput,
+								vk::AccessFlagBits::eColorAttachmentRead | vk::AccessFlagBits::eColorAttachmentWrite);
+	case vk::ImageLayout::eDepthStencilAttachmentOptimal:
+		return ImageStateVulkan(layout,
+								vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests,
+								vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eDepthStencilAttachmentWrite);
+	case vk::ImageLayout::eDepthStencilReadOnlyOptimal:
+		return ImageStateVulkan(layout,
+								vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests |
+									vk::PipelineStageFlagBits::eFragmentShader,
+								vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eShaderRead |
+									vk::AccessFlagBits::eInputAttachmentRead);
+	case vk::ImageLayout::eTransferSrcOptimal:
+		return ImageStateVulkan(layout, vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferRead);
+	case vk::ImageLayout::eTransferDstOptimal:
+		return ImageStateVulkan(layout, vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferWrite);
+	case vk::ImageLayout::ePresentSrcKHR:
+		// a presentation engine is synchronized with semaphores
+		return ImageStateVulkan(layout, vk::PipelineStageFlagBits::eBottomOfPipe, vk::AccessFlags());
+	default:
+		return ImageStateVulkan(
+			layout, vk::PipelineStageFlagBits::eAllCommands, vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite);
+	}
+}
+
 TextureVulkan::TextureVulkan() {}
 
 TextureVulkan::~TextureVulkan()
 {
+	if (bindlessTextureTable_ != nullptr)
+	{
+		bindlessTextureTable_->Unregister(bindlessIndex_);
+		bindlessTextureTable_.reset();
+	}
+
+	if (framebufferCache_ != nullptr)
+	{
+		framebufferCache_->Remove(static_cast<VkImageView>(view_));
+
+		if (multisampledView_)
+		{
+			framebufferCache_->Remove(static_cast<VkImageView>(multisampledView_));
+		}
+
+		SafeRelease(framebufferCache_);
+	}
+
+	if (multisampledImage_)
+	{
+		device_.destroyImageView(multisampledView_);
+		device_.destroyImage(multisampledImage_);
+		device_.freeMemory(multisampledDevMem_);
+	}
+
 	if (image_)
 	{
 		if (!isExternalResource_)
 		{
+			if (depthView_)
+			{
+				device_.destroyImageView(depthView_);
+				depthView_ = nullptr;
+			}
+
 			device_.destroyImageView(view_);
 			device_.destroyImage(image_);
 			device_.freeMemory(devMem_);
@@ -21,6 +90,8 @@ TextureVulkan::~TextureVulkan()
 		}
 	}
 
+	SafeRelease(sharedMemory_);
+
 	if (isStrongRef_)
 	{
 		SafeRelease(graphics_);
@@ -29,7 +100,7 @@ TextureVulkan::~TextureVulkan()
 	SafeRelease(owner_);
 }
 
-bool TextureVulkan::Initialize(GraphicsVulkan* graphics, bool isStrongRef, const Vec2I& size, bool isRenderPass)
+bool TextureVulkan::Initialize(GraphicsVulkan* graphics, bool isStrongRef, const Vec2I& size, bool isRenderPass, bool isTransient)
 {
 	graphics_ = graphics;
 	if (isStrongRef_)
@@ -44,7 +115,7 @@ bool TextureVulkan::Initialize(GraphicsVulkan* graphics, bool isStrongRef, const
 		type_ = TextureType::Render;
 	}
 
-	cpuBuf = std::unique_ptr<Buffer>(new Buffer(graphics_));
+	isTransient_ = isRenderPass && isTransient;
 
 	vk::Format format = vk::Format::eR8G8B8A8Unorm;
 
@@ -61,11 +132,19 @@ bool TextureVulkan::Initialize(GraphicsVulkan* graphics, bool isStrongRef, const
 	imageCreateInfo.tiling = vk::ImageTiling::eOptimal;
 	imageCreateInfo.initialLayout = vk::ImageLayout::eUndefined;
 
-	if (isRenderPass)
+	if (isTransient_)
+	{
+		// an input attachment is allowed to be in eShaderReadOnlyOptimal, which is a layout between render passes
+		isRenderPass_ = isRenderPass;
+		imageCreateInfo.usage = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransientAttachment |
+								vk::ImageUsageFlagBits::eInputAttachment;
+	}
+	else if (isRenderPass)
 	{
 		isRenderPass_ = isRenderPass;
 		imageCreateInfo.usage = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferDst |
-								vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eSampled;
+								vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eSampled |
+								vk::ImageUsageFlagBits::eInputAttachment;
 	}
 	else
 	{
@@ -86,7 +165,10 @@ bool TextureVulkan::Initialize(GraphicsVulkan* graphics, bool isStrongRef, const
 	memorySize = size.X * size.Y * 4;
 
 	// create a buffer on cpu
+	if (!isTransient_)
 	{
+		cpuBuf = std::unique_ptr<Buffer>(new Buffer(graphics_));
+
 		vk::BufferCreateInfo bufferInfo;
 		bufferInfo.size = memorySize;
 		bufferInfo.usage = vk::BufferUsageFlagBits::eTransferSrc;
@@ -107,7 +189,15 @@ bool TextureVulkan::Initialize(GraphicsVulkan* graphics, bool isStrongRef, const
 		vk::MemoryRequirements memReqs = device.getImageMemoryRequirements(image_);
 		vk::MemoryAllocateInfo memAlloc;
 		memAlloc.allocationSize = memReqs.size;
-		memAlloc.memoryTypeIndex = graphics_->GetMemoryTypeIndex(memReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
+		if (isTransient_)
+		{
+			auto physicalDevice = graphics_->GetPysicalDevice();
+			memAlloc.memoryTypeIndex = GetTransientMemoryTypeIndex(physicalDevice, memReqs.memoryTypeBits);
+		}
+		else
+		{
+			memAlloc.memoryTypeIndex = graphics_->GetMemoryTypeIndex(memReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
+		}
 		devMem_ = device.allocateMemory(memAlloc);
 		graphics_->GetDevice().bindImageMemory(image_, devMem_, 0);
 	}
@@ -129,8 +219,20 @@ bool TextureVulkan::Initialize(GraphicsVulkan* graphics, bool isStrongRef, const
 
 	textureSize = size;
 	vkTextureFormat_ = imageCreateInfo.format;
+	format_ = VulkanHelper::VkFormatToTextureFormat(static_cast<VkFormat>(vkTextureFormat_));
 	device_ = graphics_->GetDevice();
 
+	// register into a global texture table
+	// a transient texture is not sampled
+	if (!isTransient_)
+	{
+		bindlessTextureTable_ = graphics_->GetBindlessTextureTable();
+		if (bindlessTextureTable_ != nullptr)
+		{
+			bindlessIndex_ = bindlessTextureTable_->Register(view_);
+		}
+	}
+
 	return true;
 }
 
@@ -138,7 +240,60 @@ bool TextureVulkan::InitializeAsRenderTexture(GraphicsVulkan* graphics,
 											  bool isStrongRef,
 											  const RenderTextureInitializationParameter& parameter)
 {
-	return Initialize(graphics, isStrongRef, parameter.Size, true);
+	if (!Initialize(graphics, isStrongRef, parameter.Size, true, parameter.IsTransient))
+		return false;
+
+	if (parameter.IsMultiSampling)
+	{
+		auto physicalDevice = graphics_->GetPysicalDevice();
+		samplingCount_ = GetSupportedSamplingCount(physicalDevice, parameter.SamplingCount);
+
+		if (samplingCount_ > 1 && !CreateMultisampledImage())
+			return false;
+	}
+
+	return true;
+}
+
+bool TextureVulkan::CreateMultisampledImage()
+{
+	// contents are resolved on chip, so the image does not need to be backed by memory
+	vk::ImageCreateInfo imageCreateInfo;
+	imageCreateInfo.imageType = vk::ImageType::e2D;
+	imageCreateInfo.extent = vk::Extent3D(textureSize.X, textureSize.Y, 1);
+	imageCreateInfo.format = vkTextureFormat_;
+	imageCreateInfo.mipLevels = 1;
+	imageCreateInfo.arrayLayers = 1;
+	imageCreateInfo.tiling = vk::ImageTiling::eOptimal;
+	imageCreateInfo.initialLayout = vk::ImageLayout::eUndefined;
+	imageCreateInfo.sharingMode = vk::SharingMode::eExclusive;
+	imageCreateInfo.samples = static_cast<vk::SampleCountFlagBits>(samplingCount_);
+	imageCreateInfo.usage = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransientAttachment |
+							vk::ImageUsageFlagBits::eInputAttachment;
+	multisampledImage_ = device_.createImage(imageCreateInfo);
+
+	if (!multisampledImage_)
+	{
+		Log(LogType::Error, "Failed to create a multisampled image.");
+		return false;
+	}
+
+	auto physicalDevice = graphics_->GetPysicalDevice();
+	vk::MemoryRequirements memReqs = device_.getImageMemoryRequirements(multisampledImage_);
+	vk::MemoryAllocateInfo memAlloc;
+	memAlloc.allocationSize = memReqs.size;
+	memAlloc.memoryTypeIndex = GetTransientMemoryTypeIndex(physicalDevice, memReqs.memoryTypeBits);
+	multisampledDevMem_ = device_.allocateMemory(memAlloc);
+	device_.bindImageMemory(multisampledImage_, multisampledDevMem_, 0);
+
+	vk::ImageViewCreateInfo imageViewInfo;
+	imageViewInfo.image = multisampledImage_;
+	imageViewInfo.viewType = vk::ImageViewType::e2D;
+	imageViewInfo.format = vkTextureFormat_;
+	imageViewInfo.subresourceRange = subresourceRange_;
+	multisampledView_ = device_.createImageView(imageViewInfo);
+
+	return true;
 }
 
 bool TextureVulkan::InitializeAsScreen(const vk::Image& image, const vk::ImageView& imageVew, vk::Format format, const Vec2I& size)
@@ -148,19 +303,27 @@ bool TextureVulkan::InitializeAsScreen(const vk::Image& image, const vk::ImageVi
 	this->image_ = image;
 	this->view_ = imageVew;
 	vkTextureFormat_ = format;
+	format_ = VulkanHelper::VkFormatToTextureFormat(static_cast<VkFormat>(format));
 	textureSize = size;
 	memorySize = size.X * size.Y * 4; // TODO: format
 	isExternalResource_ = true;
+
+	subresourceRange_.aspectMask = vk::ImageAspectFlagBits::eColor;
+	subresourceRange_.levelCount = 1;
+	subresourceRange_.layerCount = 1;
 	return true;
 }
 
 bool TextureVulkan::InitializeAsDepthStencil(vk::Device device,
 											 vk::PhysicalDevice physicalDevice,
 											 const Vec2I& size,
-											 ReferenceObject* owner)
+											 ReferenceObject* owner,
+											 bool isTransient,
+											 int32_t samplingCount)
 {
 	type_ = TextureType::Depth;
 	textureSize = size;
+	isTransient_ = isTransient;
 
 	owner_ = owner;
 	SafeAddRef(owner_);
@@ -180,14 +343,31 @@ bool TextureVulkan::InitializeAsDepthStencil(vk::Device device,
 	imageCreateInfo.format = depthFormat;
 	imageCreateInfo.mipLevels = 1;
 	imageCreateInfo.arrayLayers = 1;
-	imageCreateInfo.usage = vk::ImageUsageFlagBits::eDepthStencilAttachment;
+	imageCreateInfo.usage = vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eInputAttachment;
+
+	samplingCount_ = GetSupportedSamplingCount(physicalDevice, samplingCount);
+	imageCreateInfo.samples = static_cast<vk::SampleCountFlagBits>(samplingCount_);
+
+	if (isTransient)
+	{
+		imageCreateInfo.usage |= vk::ImageUsageFlagBits::eTransientAttachment;
+	}
+
 	image_ = device.createImage(imageCreateInfo);
 
 	// allocate memory
 	vk::MemoryRequirements memReqs = device.getImageMemoryRequirements(image_);
 	vk::MemoryAllocateInfo memAlloc;
 	memAlloc.allocationSize = memReqs.size;
-	memAlloc.memoryTypeIndex = GetMemoryTypeIndex(physicalDevice, memReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
+
+	if (isTransient)
+	{
+		memAlloc.memoryTypeIndex = GetTransientMemoryTypeIndex(physicalDevice, memReqs.memoryTypeBits);
+	}
+	else
+	{
+		memAlloc.memoryTypeIndex = GetMemoryTypeIndex(physicalDevice, memReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
+	}
 	devMem_ = device.allocateMemory(memAlloc);
 	device.bindImageMemory(image_, devMem_, 0);
 
@@ -205,6 +385,25 @@ bool TextureVulkan::InitializeAsDepthStencil(vk::Device device,
 	subresourceRange_ = viewCreateInfo.subresourceRange;
 	vkTextureFormat_ = depthFormat;
 
+	return CreateDepthView();
+}
+
+bool TextureVulkan::CreateDepthView()
+{
+	vk::ImageViewCreateInfo viewCreateInfo;
+	viewCreateInfo.image = image_;
+	viewCreateInfo.viewType = vk::ImageViewType::e2D;
+	viewCreateInfo.format = vkTextureFormat_;
+	viewCreateInfo.subresourceRange = subresourceRange_;
+	viewCreateInfo.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eDepth;
+	depthView_ = device_.createImageView(viewCreateInfo);
+
+	if (!depthView_)
+	{
+		Log(LogType::Error, "Failed to create a view of a depth.");
+		return false;
+	}
+
 	return true;
 }
 
@@ -214,14 +413,104 @@ bool TextureVulkan::InitializeFromExternal(TextureType type, VkImage image, VkIm
 	image_ = vk::Image(image);
 	view_ = vk::ImageView(imageView);
 	vkTextureFormat_ = vk::Format(format);
+	format_ = type_ == TextureType::Depth ? TextureFormatType::Uknown : VulkanHelper::VkFormatToTextureFormat(format);
 	textureSize = size;
 	isExternalResource_ = true;
 
 	if (type_ == TextureType::Depth)
 	{
 		subresourceRange_.aspectMask = vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil;
-		subresourceRange_.levelCount = 1;
-		subresourceRange_.layerCount = 1;
+	}
+	else
+	{
+		subresourceRange_.aspectMask = vk::ImageAspectFlagBits::eColor;
+	}
+
+	subresourceRange_.levelCount = 1;
+	subresourceRange_.layerCount = 1;
+
+	return true;
+}
+
+bool TextureVulkan::InitializeAsTransient(GraphicsVulkan* graphics, const Vec2I& size, TextureFormatType format, bool isDepth)
+{
+	SafeAddRef(graphics);
+	SafeRelease(graphics_);
+	graphics_ = graphics;
+	isStrongRef_ = true;
+	device_ = graphics_->GetDevice();
+
+	type_ = isDepth ? TextureType::Depth : TextureType::Render;
+	format_ = isDepth ? TextureFormatType::Uknown : format;
+	isRenderPass_ = !isDepth;
+	isDepthBuffer_ = isDepth;
+	textureSize = size;
+
+	vk::ImageCreateInfo imageCreateInfo;
+	imageCreateInfo.imageType = vk::ImageType::e2D;
+	imageCreateInfo.extent = vk::Extent3D(size.X, size.Y, 1);
+	imageCreateInfo.mipLevels = 1;
+	imageCreateInfo.arrayLayers = 1;
+	imageCreateInfo.tiling = vk::ImageTiling::eOptimal;
+	imageCreateInfo.initialLayout = vk::ImageLayout::eUndefined;
+	imageCreateInfo.sharingMode = vk::SharingMode::eExclusive;
+	imageCreateInfo.samples = vk::SampleCountFlagBits::e1;
+
+	if (isDepth)
+	{
+		imageCreateInfo.format = vk::Format::eD32SfloatS8Uint;
+		imageCreateInfo.usage = vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eInputAttachment;
+		subresourceRange_.aspectMask = vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil;
+	}
+	else
+	{
+		imageCreateInfo.format = static_cast<vk::Format>(VulkanHelper::TextureFormatToVkFormat(format));
+		imageCreateInfo.usage = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferDst |
+								vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eSampled |
+								vk::ImageUsageFlagBits::eInputAttachment;
+		subresourceRange_.aspectMask = vk::ImageAspectFlagBits::eColor;
+	}
+
+	subresourceRange_.baseMipLevel = 0;
+	subresourceRange_.levelCount = 1;
+	subresourceRange_.baseArrayLayer = 0;
+	subresourceRange_.layerCount = 1;
+
+	vkTextureFormat_ = imageCreateInfo.format;
+	memorySize = size.X * size.Y * 4;
+
+	image_ = device_.createImage(imageCreateInfo);
+
+	return true;
+}
+
+vk::MemoryRequirements TextureVulkan::GetMemoryRequirements() const { return device_.getImageMemoryRequirements(image_); }
+
+bool TextureVulkan::BindMemory(DeviceMemoryVulkan* memory, vk::DeviceSize offset)
+{
+	SafeAddRef(memory);
+	SafeRelease(sharedMemory_);
+	sharedMemory_ = memory;
+
+	device_.bindImageMemory(image_, sharedMemory_->GetMemory(), offset);
+
+	vk::ImageViewCreateInfo imageViewInfo;
+	imageViewInfo.image = image_;
+	imageViewInfo.viewType = vk::ImageViewType::e2D;
+	imageViewInfo.format = vkTextureFormat_;
+	imageViewInfo.subresourceRange = subresourceRange_;
+	view_ = device_.createImageView(imageViewInfo);
+
+	// depth textures are not sampled, but they may be read as input attachments
+	if (isDepthBuffer_)
+	{
+		return CreateDepthView();
+	}
+
+	bindlessTextureTable_ = graphics_->GetBindlessTextureTable();
+	if (bindlessTextureTable_ != nullptr)
+	{
+		bindlessIndex_ = bindlessTextureTable_->Register(view_);
 	}
 
 	return true;
@@ -229,7 +518,8 @@ bool TextureVulkan::InitializeFromExternal(TextureType type, VkImage image, VkIm
 
 void* TextureVulkan::Lock()
 {
-	if (graphics_ == nullptr)
+	// transient textures don't have a buffer on cpu
+	if (graphics_ == nullptr || cpuBuf == nullptr)
 		return nullptr;
 
 	data = graphics_->GetDevice().mapMemory(cpuBuf->devMem(), 0, memorySize, vk::MemoryMapFlags());
@@ -238,7 +528,7 @@ void* TextureVulkan::Lock()
 
 void TextureVulkan::Unlock()
 {
-	if (graphics_ == nullptr)
+	if (graphics_ == nullptr || cpuBuf == nullptr)
 	{
 		return;
 	}
@@ -270,15 +560,15 @@ void TextureVulkan::Unlock()
 	imageBufferCopy.imageOffset = vk::Offset3D(0, 0, 0);
 	imageBufferCopy.imageExtent = vk::Extent3D(static_cast<uint32_t>(GetSizeAs2D().X), static_cast<uint32_t>(GetSizeAs2D().Y), 1);
 
-	vk::ImageSubresourceRange colorSubRange;
-	colorSubRange.aspectMask = vk::ImageAspectFlagBits::eColor;
-	colorSubRange.levelCount = 1;
-	colorSubRange.layerCount = 1;
+	// previous contents are overwritten
+	ImageBarrierBatchVulkan barrierBatch;
+	barrierBatch.Transition(this, ImageStateVulkan::FromLayout(vk::ImageLayout::eTransferDstOptimal), true);
+	barrierBatch.Flush(copyCommandBuffer);
+
+	copyCommandBuffer.copyBufferToImage(cpuBuf->buffer(), image_, vk::ImageLayout::eTransferDstOptimal, imageBufferCopy);
 
-	vk::ImageLayout imageLayout = vk::ImageLayout::eTransferDstOptimal;
-	ResourceBarrior(copyCommandBuffer, imageLayout);
-	copyCommandBuffer.copyBufferToImage(cpuBuf->buffer(), image_, imageLayout, imageBufferCopy);
-	ResourceBarrior(copyCommandBuffer, vk::ImageLayout::eShaderReadOnlyOptimal);
+	barrierBatch.Transition(this, ImageStateVulkan::FromLayout(vk::ImageLayout::eShaderReadOnlyOptimal));
+	barrierBatch.Flush(copyCommandBuffer);
 	copyCommandBuffer.end();
 
 	// submit and wait to execute command
@@ -294,17 +584,51 @@ void TextureVulkan::Unlock()
 
 Vec2I TextureVulkan::GetSizeAs2D() const { return textureSize; }
 
-vk::ImageLayout TextureVulkan::GetImageLayout() const { return imageLayout_; }
+vk::ImageLayout TextureVulkan::GetImageLayout() const
+{
+	if (subresourceStates_.size() == 0)
+		return vk::ImageLayout::eUndefined;
+
+	return subresourceStates_[0].Layout;
+}
 
-void TextureVulkan::ChangeImageLayout(const vk::ImageLayout& imageLayout) { imageLayout_ = imageLayout; }
+ImageStateVulkan& TextureVulkan::GetSubresourceState(uint32_t mipLevel, uint32_t arrayLayer)
+{
+	auto layerCount = GetArrayLayerCount();
+	subresourceStates_.resize(GetMipLevelCount() * layerCount);
 
-void TextureVulkan::ResourceBarrior(vk::CommandBuffer& commandBuffer, const vk::ImageLayout& imageLayout)
+	assert(mipLevel < GetMipLevelCount() && arrayLayer < layerCount);
+	return subresourceStates_[mipLevel * layerCount + arrayLayer];
+}
+
+void TextureVulkan::SetState(const ImageStateVulkan& state)
 {
-	if (imageLayout == imageLayout_)
-		return;
+	subresourceStates_.resize(GetMipLevelCount() * GetArrayLayerCount());
+
+	for (auto& s : subresourceStates_)
+	{
+		s = state;
+	}
+}
 
-	SetImageLayout(commandBuffer, image_, imageLayout_, imageLayout, subresourceRange_);
-	ChangeImageLayout(imageLayout);
+void TextureVulkan::AddAccess(vk::PipelineStageFlags stages, vk::AccessFlags accesses)
+{
+	subresourceStates_.resize(GetMipLevelCount() * GetArrayLayerCount());
+
+	for (auto& s : subresourceStates_)
+	{
+		s.Stages |= stages;
+		s.Accesses |= accesses;
+	}
+}
+
+void TextureVulkan::SetFramebufferCache(FramebufferCacheVulkan* framebufferCache) { SafeAssign(framebufferCache_, framebufferCache); }
+
+void TextureVulkan::ResourceBarrior(vk::CommandBuffer& commandBuffer, const vk::ImageLayout& imageLayout)
+{
+	ImageBarrierBatchVulkan barrierBatch;
+	barrierBatch.Transition(this, ImageStateVulkan::FromLayout(imageLayout));
+	barrierBatch.Flush(commandBuffer);
 }
 
 } // namespace LLGI
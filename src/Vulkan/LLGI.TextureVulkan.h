@@ -8,6 +8,30 @@
 namespace LLGI
 {
 
+class FramebufferCacheVulkan;
+
+/**
+	@brief	a layout of a subresource and accesses which have used it since the last barrier
+*/
+struct ImageStateVulkan
+{
+	vk::ImageLayout Layout = vk::ImageLayout::eUndefined;
+	vk::PipelineStageFlags Stages;
+	vk::AccessFlags Accesses;
+
+	ImageStateVulkan() = default;
+
+	ImageStateVulkan(vk::ImageLayout layout, vk::PipelineStageFlags stages, vk::AccessFlags accesses)
+		: Layout(layout), Stages(stages), Accesses(accesses)
+	{
+	}
+
+	/**
+		@brief	get a state which an image in a layout is usually accessed with
+	*/
+	static ImageStateVulkan FromLayout(vk::ImageLayout layout);
+};
+
 // for Texture2D, RenderTarget, DepthBuffer
 class TextureVulkan : public Texture
 {
@@ -19,8 +43,21 @@ private:
 	bool isStrongRef_ = false;
 	vk::Image image_ = nullptr;
 	vk::ImageView view_ = nullptr;
-	vk::ImageLayout imageLayout_ = vk::ImageLayout::eUndefined;
+
+	//! states of subresources. an index is mipLevel * (the number of array layers) + arrayLayer
+	std::vector<ImageStateVulkan> subresourceStates_;
+
 	vk::DeviceMemory devMem_ = nullptr;
+
+	//! a view of only a depth, which is read as an input attachment
+	vk::ImageView depthView_ = nullptr;
+
+	//! a transient image which is rendered and resolved into image_ if a render texture is multisampled
+	vk::Image multisampledImage_ = nullptr;
+	vk::ImageView multisampledView_ = nullptr;
+	vk::DeviceMemory multisampledDevMem_ = nullptr;
+	DeviceMemoryVulkan* sharedMemory_ = nullptr;
+	FramebufferCacheVulkan* framebufferCache_ = nullptr;
 	vk::Format vkTextureFormat_;
 	vk::ImageSubresourceRange subresourceRange_;
 
@@ -34,11 +71,21 @@ private:
 	bool isDepthBuffer_ = false;
 	bool isExternalResource_ = false;
 
+	std::shared_ptr<BindlessTextureTableVulkan> bindlessTextureTable_;
+	int32_t bindlessIndex_ = -1;
+
+	bool CreateMultisampledImage();
+
+	bool CreateDepthView();
+
 public:
 	TextureVulkan();
 	virtual ~TextureVulkan();
 
-	bool Initialize(GraphicsVulkan* graphics, bool isStrongRef, const Vec2I& size, bool isRenderPass);
+	/**
+		@param	isTransient	whether the texture is a transient attachment. It is valid only if isRenderPass is true.
+	*/
+	bool Initialize(GraphicsVulkan* graphics, bool isStrongRef, const Vec2I& size, bool isRenderPass, bool isTransient = false);
 
 	bool InitializeAsRenderTexture(GraphicsVulkan* graphics, bool isStrongRef, const RenderTextureInitializationParameter& parameter);
 
@@ -47,26 +94,103 @@ public:
 	*/
 	bool InitializeAsScreen(const vk::Image& image, const vk::ImageView& imageVew, vk::Format format, const Vec2I& size);
 
-	bool InitializeAsDepthStencil(vk::Device device, vk::PhysicalDevice physicalDevice, const Vec2I& size, ReferenceObject* owner);
+	bool InitializeAsDepthStencil(vk::Device device,
+								  vk::PhysicalDevice physicalDevice,
+								  const Vec2I& size,
+								  ReferenceObject* owner,
+								  bool isTransient = false,
+								  int32_t samplingCount = 1);
 
 	bool InitializeFromExternal(TextureType type, VkImage image, VkImageView imageView, VkFormat format, const Vec2I& size);
 
+	/**
+		@brief	initialize an image without memory
+		@note
+		BindMemory must be called before the texture is used.
+	*/
+	bool InitializeAsTransient(GraphicsVulkan* graphics, const Vec2I& size, TextureFormatType format, bool isDepth);
+
+	vk::MemoryRequirements GetMemoryRequirements() const;
+
+	/**
+		@brief	bind memory which may be shared with other textures and create a view
+	*/
+	bool BindMemory(DeviceMemoryVulkan* memory, vk::DeviceSize offset);
+
 	void* Lock() override;
 	void Unlock() override;
 	Vec2I GetSizeAs2D() const override;
+	int32_t GetBindlessIndex() const override { return bindlessIndex_; }
 
 	const vk::Image& GetImage() const { return image_; }
 	const vk::ImageView& GetView() const { return view_; }
 
+	/**
+		@brief	get a view which is rendered in a render pass
+		@note
+		It is a view of a multisampled image if a render texture is multisampled. Otherwise, it is same as GetView.
+	*/
+	const vk::ImageView& GetAttachmentView() const { return multisampledView_ ? multisampledView_ : view_; }
+
+	//! get a transient image which is resolved into the texture. It is null if the texture is not multisampled.
+	const vk::Image& GetMultisampledImage() const { return multisampledImage_; }
+
+	/**
+		@brief	get a view which is read as an input attachment in a following subpass
+		@note
+		It contains only a depth if the texture is a depth texture.
+	*/
+	const vk::ImageView& GetInputAttachmentView() const { return depthView_ ? depthView_ : GetAttachmentView(); }
+
+	/**
+		@brief	get a layout which an input attachment is read in
+	*/
+	vk::ImageLayout GetInputAttachmentLayout() const
+	{
+		return type_ == TextureType::Depth ? vk::ImageLayout::eDepthStencilReadOnlyOptimal : vk::ImageLayout::eShaderReadOnlyOptimal;
+	}
+
 	vk::Format GetVulkanFormat() const { return vkTextureFormat_; }
 	int32_t GetMemorySize() const { return memorySize; }
 
+	//! get a layout of the first subresource
 	vk::ImageLayout GetImageLayout() const;
 
 	vk::ImageSubresourceRange GetSubresourceRange() const { return subresourceRange_; }
 
-	void ChangeImageLayout(const vk::ImageLayout& imageLayout);
+	uint32_t GetMipLevelCount() const { return subresourceRange_.levelCount > 0 ? subresourceRange_.levelCount : 1; }
 
+	uint32_t GetArrayLayerCount() const { return subresourceRange_.layerCount > 0 ? subresourceRange_.layerCount : 1; }
+
+	/**
+		@brief	get a state of a subresource which is tracked on cpu
+		@note
+		A state is updated when a barrier is recorded with ImageBarrierBatchVulkan, not when gpu executes it.
+	*/
+	ImageStateVulkan& GetSubresourceState(uint32_t mipLevel, uint32_t arrayLayer);
+
+	/**
+		@brief	specify a state of all subresources which is changed without barriers. (e.g. by a render pass)
+	*/
+	void SetState(const ImageStateVulkan& state);
+
+	/**
+		@brief	add accesses which don't change a layout (e.g. reads by shaders)
+	*/
+	void AddAccess(vk::PipelineStageFlags stages, vk::AccessFlags accesses);
+
+	/**
+		@brief	specify a cache which has framebuffers using the texture
+		@note
+		The framebuffers are destroyed with the texture.
+	*/
+	void SetFramebufferCache(FramebufferCacheVulkan* framebufferCache);
+
+	/**
+		@brief	change a layout of all subresources with a barrier
+		@note
+		Please use ImageBarrierBatchVulkan to change layouts of several textures at once.
+	*/
 	void ResourceBarrior(vk::CommandBuffer& commandBuffer, const vk::ImageLayout& imageLayout);
 };
 
@@ -0,0 +1,12 @@
+#version 440 core
+
+layout(location = 0) in vec2 v_uv;
+layout(location = 1) in vec4 v_color;
+layout(input_attachment_index = 0, binding = 1, set = 1) uniform subpassInput mainInput;
+
+layout(location = 0) out vec4 color;
+
+void main()
+{
+    color = subpassLoad(mainInput).gbra;
+}
@@ -3,7 +3,7 @@
 
 layout(location = 0) in vec2 v_uv;
 layout(location = 1) in vec4 v_color;
-layout(binding = 1) uniform sampler2D mainTexture;
+layout(binding = 1, set = 1) uniform sampler2D mainTexture;
 
 layout(location = 0) out vec4 color;
 
@@ -1,5 +1 @@
-glslangValidator.exe ..\GLSL\simple_constant_rectangle.vert -e main -V -l -o simple_constant_rectangle.vert.spv
-glslangValidator.exe ..\GLSL\simple_constant_rectangle.frag -e main -V -l -o simple_constant_rectangle.frag.spv
-
-glslangValidator.exe ..\GLSL\simple_texture_rectangle.vert -e main -V -l -o simple_texture_rectangle.vert.spv
-glslangValidator.exe ..\GLSL\simple_texture_rectangle.frag -e main -V -l -o simple_texture_rectangle.frag.spv
+llgi_shaderc.exe ..\GLSL .
@@ -12,6 +12,19 @@ enum class RenderPassTestMode
 	CopyTexture,
 };
 
+enum class DrawRangeTestMode
+{
+	Indexed,
+	BaseVertex,
+	NonIndexed,
+};
+
+enum class DrawMultiTestMode
+{
+	Multi,
+	Indirect,
+};
+
 class TestHelper
 {
 public:
@@ -103,6 +103,149 @@ void test_capture(LLGI::DeviceType deviceType, LLGI::Vec2I windowSize)
 	pips.clear();
 }
 
+void test_readback(LLGI::DeviceType deviceType)
+{
+	int count = 0;
+
+	LLGI::PlatformParameter pp;
+	pp.Device = deviceType;
+	pp.WaitVSync = true;
+	auto window = std::unique_ptr<LLGI::Window>(LLGI::CreateWindow("Readback", LLGI::Vec2I(1280, 720)));
+	auto platform = LLGI::CreateSharedPtr(LLGI::CreatePlatform(pp, window.get()));
+	auto graphics = LLGI::CreateSharedPtr(platform->CreateGraphics());
+
+	// textures are read without waiting only in some platforms
+	if (platform->GetDeviceType() != LLGI::DeviceType::Vulkan)
+	{
+		std::cout << "Skip Readback because ReadbackTexture is not supported." << std::endl;
+		return;
+	}
+
+	auto sfMemoryPool = LLGI::CreateSharedPtr(graphics->CreateSingleFrameMemoryPool(1024 * 1024, 128));
+
+	std::array<std::shared_ptr<LLGI::CommandList>, 3> commandLists;
+	for (size_t i = 0; i < commandLists.size(); i++)
+		commandLists[i] = LLGI::CreateSharedPtr(graphics->CreateCommandList(sfMemoryPool.get()));
+
+	std::shared_ptr<LLGI::Shader> shader_vs = nullptr;
+	std::shared_ptr<LLGI::Shader> shader_ps = nullptr;
+
+	TestHelper::CreateShader(graphics.get(), deviceType, "simple_rectangle.vert", "simple_rectangle.frag", shader_vs, shader_ps);
+
+	std::shared_ptr<LLGI::VertexBuffer> vb;
+	std::shared_ptr<LLGI::IndexBuffer> ib;
+	TestHelper::CreateRectangle(graphics.get(),
+								LLGI::Vec3F(-0.5, 0.5, 0.5),
+								LLGI::Vec3F(0.5, -0.5, 0.5),
+								LLGI::Color8(255, 255, 255, 255),
+								LLGI::Color8(0, 255, 0, 255),
+								vb,
+								ib);
+
+	// a texture is 3MB, so a readback ring of 16MB in each command list wraps around in 6 frames of the command list
+	LLGI::RenderTextureInitializationParameter params;
+	params.Size = LLGI::Vec2I(1024, 768);
+	auto renderTexture = LLGI::CreateSharedPtr(graphics->CreateRenderTexture(params));
+	auto renderTexturePtr = renderTexture.get();
+	auto renderPass = LLGI::CreateSharedPtr(graphics->CreateRenderPass((const LLGI::Texture**)&renderTexturePtr, 1, nullptr));
+	renderPass->SetIsColorCleared(true);
+
+	auto renderPassPipelineState = LLGI::CreateSharedPtr(graphics->CreateRenderPassPipelineState(renderPass.get()));
+
+	auto pip = LLGI::CreateSharedPtr(graphics->CreatePiplineState());
+	pip->VertexLayouts[0] = LLGI::VertexLayoutFormat::R32G32B32_FLOAT;
+	pip->VertexLayouts[1] = LLGI::VertexLayoutFormat::R32G32_FLOAT;
+	pip->VertexLayouts[2] = LLGI::VertexLayoutFormat::R8G8B8A8_UNORM;
+	pip->VertexLayoutNames[0] = "POSITION";
+	pip->VertexLayoutNames[1] = "UV";
+	pip->VertexLayoutNames[2] = "COLOR";
+	pip->VertexLayoutCount = 3;
+
+	pip->Culling = LLGI::CullingMode::DoubleSide; // TEMP :vulkan
+	pip->SetShader(LLGI::ShaderStageType::Vertex, shader_vs.get());
+	pip->SetShader(LLGI::ShaderStageType::Pixel, shader_ps.get());
+	pip->SetRenderPassPipelineState(renderPassPipelineState.get());
+	pip->Compile();
+
+	// each frame has a different clear color, so a result shows which frame is read
+	auto getClearColor = [](int frame) -> LLGI::Color8 { return LLGI::Color8((frame * 8) % 256, 0, 255, 255); };
+
+	int readbackCount = 0;
+	int lastFrame = -1;
+	std::vector<uint8_t> lastData;
+
+	while (count < 100)
+	{
+		if (!platform->NewFrame())
+			break;
+
+		sfMemoryPool->NewFrame();
+
+		auto frame = count;
+		renderPass->SetClearColor(getClearColor(frame));
+
+		auto screen = platform->GetCurrentScreen(LLGI::Color8(), true, false); // TODO: isDepthClear is false, because it fails with dx12.
+
+		auto commandList = commandLists[count % commandLists.size()];
+		commandList->Begin();
+		commandList->BeginRenderPass(renderPass.get());
+		commandList->SetVertexBuffer(vb.get(), sizeof(SimpleVertex), 0);
+		commandList->SetIndexBuffer(ib.get());
+		commandList->SetPipelineState(pip.get());
+		commandList->Draw(2);
+		commandList->EndRenderPass();
+
+		auto isRecorded =
+			commandList->ReadbackTexture(renderTexture.get(), LLGI::TextureRegion(), [&, frame](const void* data, int32_t size) -> void {
+				EXPECT_EQ(size, params.Size.X * params.Size.Y * 4);
+
+				std::vector<uint8_t> pixels(static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+				Bitmap2D bitmap(pixels, params.Size.X, params.Size.Y, false);
+				auto clearColor = getClearColor(frame);
+				EXPECT_EQ(bitmap.GetPixel(params.Size.X / 10, params.Size.Y / 10).r, clearColor.R);
+				EXPECT_EQ(bitmap.GetPixel(params.Size.X / 10, params.Size.Y / 10).b, clearColor.B);
+				EXPECT_EQ(bitmap.GetPixel(params.Size.X / 2, params.Size.Y / 2).g, 255);
+
+				// results arrive in the order of frames
+				EXPECT_GT(frame, lastFrame);
+				lastFrame = frame;
+				lastData = pixels;
+				readbackCount++;
+			});
+
+		// a ring must have space after it wraps around because old regions are freed
+		EXPECT_TRUE(isRecorded);
+
+		commandList->BeginRenderPass(screen);
+		commandList->EndRenderPass();
+		commandList->End();
+
+		graphics->Execute(commandList.get());
+
+		platform->Present();
+		count++;
+
+		if (TestHelper::GetIsCaptureRequired() && count == 30)
+		{
+			for (auto& c : commandLists)
+			{
+				c->WaitUntilCompleted();
+			}
+
+			EXPECT_EQ(readbackCount, count);
+			EXPECT_EQ(lastFrame, count - 1);
+
+			// the last result is same as a texture which is captured after all commands
+			auto data = graphics->CaptureRenderTarget(renderTexture.get());
+			Bitmap2D(data, params.Size.X, params.Size.Y, false).Save("Readback.png");
+			EXPECT_TRUE(data == lastData);
+			break;
+		}
+	}
+
+	graphics->WaitFinish();
+}
+
 #if defined(__linux__) || defined(__APPLE__) || defined(WIN32)
 
 TEST(Capture, Size1279) { test_capture(LLGI::DeviceType::Default, LLGI::Vec2I(1279, 719)); }
@@ -111,4 +254,6 @@ TEST(Capture, Size800) { test_capture(LLGI::DeviceType::Default, LLGI::Vec2I(800
 
 TEST(Capture, Size1280) { test_capture(LLGI::DeviceType::Default, LLGI::Vec2I(1280, 720)); }
 
+TEST(Capture, Readback) { test_readback(LLGI::DeviceType::Default); }
+
 #endif
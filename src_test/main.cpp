@@ -22,6 +22,8 @@ void test_clear_update(LLGI::DeviceType deviceType = LLGI::DeviceType::Default);
 // Render
 void test_simple_rectangle(LLGI::DeviceType deviceType = LLGI::DeviceType::Default);
 void test_index_offset(LLGI::DeviceType deviceType = LLGI::DeviceType::Default);
+void test_draw_range(LLGI::DeviceType deviceType = LLGI::DeviceType::Default, DrawRangeTestMode mode = DrawRangeTestMode::Indexed);
+void test_draw_multi(LLGI::DeviceType deviceType = LLGI::DeviceType::Default, DrawMultiTestMode mode = DrawMultiTestMode::Multi);
 
 void test_simple_constant_rectangle(LLGI::ConstantBufferType type, LLGI::DeviceType deviceType = LLGI::DeviceType::Default);
 
@@ -30,10 +32,30 @@ void test_simple_texture_rectangle(LLGI::DeviceType deviceType = LLGI::DeviceTyp
 // Compile
 void test_compile(LLGI::DeviceType deviceType = LLGI::DeviceType::Default);
 
+// About compiler cache
+void test_compiler_cache_memory();
+void test_compiler_cache_file();
+
+// About shader reflection
+void test_shader_reflection_vertex();
+void test_shader_reflection_pixel();
+void test_shader_reflection_push_constant();
+
 // About renderPass
 void test_renderPass(LLGI::DeviceType deviceType = LLGI::DeviceType::Default, RenderPassTestMode mode = RenderPassTestMode::None);
 void test_multiRenderPass(LLGI::DeviceType deviceType = LLGI::DeviceType::Default);
+void test_msaa_resolve(LLGI::DeviceType deviceType = LLGI::DeviceType::Default);
+void test_subpass_input(LLGI::DeviceType deviceType = LLGI::DeviceType::Default);
+void test_dynamic_rendering(LLGI::DeviceType deviceType = LLGI::DeviceType::Default);
 void test_capture(LLGI::DeviceType deviceType = LLGI::DeviceType::Default);
+void test_readback(LLGI::DeviceType deviceType = LLGI::DeviceType::Default);
+
+// About render graph
+void test_render_graph(LLGI::DeviceType deviceType = LLGI::DeviceType::Default);
+
+// About render texture pool
+void test_render_texture_pool_reuse();
+void test_render_texture_pool_eviction();
 
 // About depth
 void test_depth(LLGI::DeviceType deviceType = LLGI::DeviceType::Default);
@@ -57,14 +79,23 @@ void call_test(LLGI::DeviceType device)
 	// Render
 	// test_simple_rectangle(device);
 	// test_index_offset(device);
+	// test_draw_range(device, DrawRangeTestMode::Indexed);
+	// test_draw_multi(device, DrawMultiTestMode::Multi);
 	// test_simple_constant_rectangle(LLGI::ConstantBufferType::LongTime, device);
 	test_simple_texture_rectangle(device);
 
 	// About renderPass
 	// test_renderPass(device, RenderPassTestMode::CopyTexture);
 	// test_multiRenderPass(device);
+	// test_msaa_resolve(device);
+	// test_subpass_input(device);
+	// test_dynamic_rendering(device);
 
 	// test_capture(device);
+	// test_readback(device);
+
+	// About render graph
+	// test_render_graph(device);
 
 	// About depth
 	// test_depth(device);
@@ -0,0 +1,116 @@
+#include "test.h"
+
+#if defined(ENABLE_VULKAN)
+
+#include <Vulkan/LLGI.CompilerCacheVulkan.h>
+#include <fstream>
+#include <stdio.h>
+
+static std::vector<uint8_t> CreateCacheBinary(size_t size, uint8_t seed)
+{
+	std::vector<uint8_t> binary(size);
+	for (size_t i = 0; i < size; i++)
+	{
+		binary[i] = static_cast<uint8_t>(seed + i);
+	}
+	return binary;
+}
+
+static std::string GetCacheFilePath(uint64_t key)
+{
+	char name[32];
+	snprintf(name, sizeof(name), "./%016llx.spv", static_cast<unsigned long long>(key));
+	return name;
+}
+
+static void WriteCacheFile(uint64_t key, uint64_t size, const std::vector<uint8_t>& binary)
+{
+	std::ofstream file(GetCacheFilePath(key), std::ios::binary);
+	file.write("LSCC", 4);
+	file.write(reinterpret_cast<const char*>(&key), sizeof(key));
+	file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+	file.write(reinterpret_cast<const char*>(binary.data()), binary.size());
+}
+
+void test_compiler_cache_memory()
+{
+	LLGI::CompilerCacheVulkan cache(16);
+
+	auto binary1 = CreateCacheBinary(8, 1);
+	auto binary2 = CreateCacheBinary(8, 2);
+	auto binary3 = CreateCacheBinary(8, 3);
+	std::vector<uint8_t> result;
+
+	cache.Store(1, binary1);
+	cache.Store(2, binary2);
+
+	// the first binary is marked as recently used, so the second binary is removed
+	EXPECT_TRUE(cache.Get(1, result));
+	EXPECT_TRUE(result == binary1);
+
+	cache.Store(3, binary3);
+
+	EXPECT_FALSE(cache.Get(2, result));
+	EXPECT_TRUE(cache.Get(1, result));
+	EXPECT_TRUE(result == binary1);
+	EXPECT_TRUE(cache.Get(3, result));
+	EXPECT_TRUE(result == binary3);
+
+	// a binary which is larger than the cache is not kept
+	cache.Store(4, CreateCacheBinary(32, 4));
+	EXPECT_FALSE(cache.Get(4, result));
+	EXPECT_TRUE(cache.Get(1, result));
+}
+
+void test_compiler_cache_file()
+{
+	const uint64_t key = 0x4c4c47497465737aULL;
+	const uint64_t brokenKey = key + 1;
+	const uint64_t truncatedKey = key + 2;
+
+	auto binary = CreateCacheBinary(64, 5);
+	std::vector<uint8_t> result;
+
+	{
+		LLGI::CompilerCacheVulkan writer;
+		writer.SetDirectory(".");
+		writer.Store(key, binary);
+	}
+
+	// another cache which has no binaries in memory reads the stored file
+	{
+		LLGI::CompilerCacheVulkan reader;
+		reader.SetDirectory(".");
+		EXPECT_TRUE(reader.Get(key, result));
+		EXPECT_TRUE(result == binary);
+
+		reader.SetDirectory("");
+		EXPECT_TRUE(reader.Get(key, result));
+		EXPECT_TRUE(result == binary);
+	}
+
+	// a size in a header which is larger than a file is rejected without allocating it
+	WriteCacheFile(brokenKey, 0xffffffffffffULL, binary);
+	WriteCacheFile(truncatedKey, binary.size(), CreateCacheBinary(binary.size() / 2, 6));
+
+	{
+		LLGI::CompilerCacheVulkan reader;
+		reader.SetDirectory(".");
+		EXPECT_FALSE(reader.Get(brokenKey, result));
+		EXPECT_FALSE(reader.Get(truncatedKey, result));
+	}
+
+	remove(GetCacheFilePath(key).c_str());
+	remove(GetCacheFilePath(brokenKey).c_str());
+	remove(GetCacheFilePath(truncatedKey).c_str());
+}
+
+#if defined(__linux__) || defined(__APPLE__) || defined(WIN32)
+
+TEST(CompilerCache, Memory) { test_compiler_cache_memory(); }
+
+TEST(CompilerCache, File) { test_compiler_cache_file(); }
+
+#endif
+
+#endif
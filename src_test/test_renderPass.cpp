@@ -3,6 +3,11 @@
 #include <array>
 #include <map>
 
+#if defined(ENABLE_VULKAN)
+#include <Vulkan/LLGI.GraphicsVulkan.h>
+#include <Vulkan/LLGI.RenderPassVulkan.h>
+#endif
+
 void test_renderPass(LLGI::DeviceType deviceType, RenderPassTestMode mode)
 {
 	auto code_gl_vs = R"(
@@ -1040,6 +1045,449 @@ void test_capture(LLGI::DeviceType deviceType)
 	LLGI::SafeRelease(compiler);
 }
 
+static std::shared_ptr<LLGI::PipelineState> CreateRectanglePipelineState(LLGI::Graphics* graphics,
+																		  LLGI::RenderPassPipelineState* renderPassPipelineState,
+																		  LLGI::Shader* vs,
+																		  LLGI::Shader* ps,
+																		  int32_t subpass = 0)
+{
+	auto pip = graphics->CreatePiplineState();
+	pip->VertexLayouts[0] = LLGI::VertexLayoutFormat::R32G32B32_FLOAT;
+	pip->VertexLayouts[1] = LLGI::VertexLayoutFormat::R32G32_FLOAT;
+	pip->VertexLayouts[2] = LLGI::VertexLayoutFormat::R8G8B8A8_UNORM;
+	pip->VertexLayoutNames[0] = "POSITION";
+	pip->VertexLayoutNames[1] = "UV";
+	pip->VertexLayoutNames[2] = "COLOR";
+	pip->VertexLayoutCount = 3;
+
+	pip->Culling = LLGI::CullingMode::DoubleSide; // TEMP :vulkan
+	pip->SetShader(LLGI::ShaderStageType::Vertex, vs);
+	pip->SetShader(LLGI::ShaderStageType::Pixel, ps);
+	pip->SetRenderPassPipelineState(renderPassPipelineState);
+	pip->Subpass = subpass;
+	pip->Compile();
+
+	return LLGI::CreateSharedPtr(pip);
+}
+
+void test_msaa_resolve(LLGI::DeviceType deviceType)
+{
+	int count = 0;
+
+	LLGI::PlatformParameter pp;
+	pp.Device = deviceType;
+	pp.WaitVSync = true;
+	auto window = std::unique_ptr<LLGI::Window>(LLGI::CreateWindow("MSAAResolve", LLGI::Vec2I(1280, 720)));
+	auto platform = LLGI::CreatePlatform(pp, window.get());
+	LLGI::SafeAddRef(platform);
+
+	auto graphics = platform->CreateGraphics();
+	graphics->SetDisposed([platform]() -> void { platform->Release(); });
+
+	auto sfMemoryPool = graphics->CreateSingleFrameMemoryPool(1024 * 1024, 128);
+
+	std::array<LLGI::CommandList*, 3> commandLists;
+	for (int i = 0; i < commandLists.size(); i++)
+		commandLists[i] = graphics->CreateCommandList(sfMemoryPool);
+
+	// colors are drawn into a multisampled image and resolved into the texture at the end of the render pass
+	LLGI::RenderTextureInitializationParameter params;
+	params.Size = LLGI::Vec2I(256, 256);
+	params.IsMultiSampling = true;
+	params.SamplingCount = 4;
+	auto renderTexture = LLGI::CreateSharedPtr(graphics->CreateRenderTexture(params));
+
+	if (renderTexture->GetSamplingCount() <= 1)
+	{
+		std::cout << "MSAA is not supported. The test is skipped." << std::endl;
+	}
+	else
+	{
+		auto texturePtr = renderTexture.get();
+		auto renderPass = LLGI::CreateSharedPtr(graphics->CreateRenderPass((const LLGI::Texture**)&texturePtr, 1, nullptr));
+		renderPass->SetIsColorCleared(true);
+		renderPass->SetClearColor(LLGI::Color8(0, 0, 255, 255));
+
+		std::shared_ptr<LLGI::Shader> shader_vs = nullptr;
+		std::shared_ptr<LLGI::Shader> shader_ps = nullptr;
+		TestHelper::CreateShader(graphics, deviceType, "simple_rectangle.vert", "simple_rectangle.frag", shader_vs, shader_ps);
+
+		// the left edge is at the center of a column of pixels, so the column is covered by a part of samples
+		std::shared_ptr<LLGI::VertexBuffer> vb;
+		std::shared_ptr<LLGI::IndexBuffer> ib;
+		TestHelper::CreateRectangle(graphics,
+									LLGI::Vec3F(-0.5f + 1.0f / params.Size.X, 0.5, 0.5),
+									LLGI::Vec3F(0.5, -0.5, 0.5),
+									LLGI::Color8(255, 255, 255, 255),
+									LLGI::Color8(0, 255, 0, 255),
+									vb,
+									ib);
+
+		auto renderPassPipelineState = LLGI::CreateSharedPtr(graphics->CreateRenderPassPipelineState(renderPass.get()));
+		auto pip = CreateRectanglePipelineState(graphics, renderPassPipelineState.get(), shader_vs.get(), shader_ps.get());
+
+		while (count < 1000)
+		{
+			if (!platform->NewFrame())
+				break;
+
+			sfMemoryPool->NewFrame();
+
+			auto commandList = commandLists[count % commandLists.size()];
+			commandList->Begin();
+			commandList->BeginRenderPass(renderPass.get());
+			commandList->SetVertexBuffer(vb.get(), sizeof(SimpleVertex), 0);
+			commandList->SetIndexBuffer(ib.get());
+			commandList->SetPipelineState(pip.get());
+			commandList->Draw(2);
+			commandList->EndRenderPass();
+
+			commandList->BeginRenderPass(platform->GetCurrentScreen(LLGI::Color8(), true));
+			commandList->EndRenderPass();
+			commandList->End();
+
+			graphics->Execute(commandList);
+
+			platform->Present();
+			count++;
+
+			if (TestHelper::GetIsCaptureRequired() && count == 5)
+			{
+				commandList->WaitUntilCompleted();
+
+				auto data = graphics->CaptureRenderTarget(renderTexture.get());
+				Bitmap2D bitmap(data, params.Size.X, params.Size.Y, false);
+				bitmap.Save("MSAAResolve.png");
+
+				EXPECT_EQ(bitmap.GetPixel(params.Size.X / 2, params.Size.Y / 2).g, 255);
+				EXPECT_EQ(bitmap.GetPixel(params.Size.X / 10, params.Size.Y / 10).g, 0);
+				EXPECT_EQ(bitmap.GetPixel(params.Size.X / 10, params.Size.Y / 10).b, 255);
+
+				// samples are averaged on the edge
+				auto edge = bitmap.GetPixel(params.Size.X / 4, params.Size.Y / 2);
+				EXPECT_GT(edge.g, 0);
+				EXPECT_LT(edge.g, 255);
+				break;
+			}
+		}
+
+		graphics->WaitFinish();
+	}
+
+	renderTexture.reset();
+
+	LLGI::SafeRelease(sfMemoryPool);
+	for (int i = 0; i < commandLists.size(); i++)
+		LLGI::SafeRelease(commandLists[i]);
+	LLGI::SafeRelease(graphics);
+	LLGI::SafeRelease(platform);
+}
+
+void test_subpass_input(LLGI::DeviceType deviceType)
+{
+	int count = 0;
+
+	LLGI::PlatformParameter pp;
+	pp.Device = deviceType;
+	pp.WaitVSync = true;
+	auto window = std::unique_ptr<LLGI::Window>(LLGI::CreateWindow("SubpassInput", LLGI::Vec2I(1280, 720)));
+	auto platform = LLGI::CreatePlatform(pp, window.get());
+	LLGI::SafeAddRef(platform);
+
+	auto graphics = platform->CreateGraphics();
+	graphics->SetDisposed([platform]() -> void { platform->Release(); });
+
+	auto sfMemoryPool = graphics->CreateSingleFrameMemoryPool(1024 * 1024, 128);
+
+	std::array<LLGI::CommandList*, 3> commandLists;
+	for (int i = 0; i < commandLists.size(); i++)
+		commandLists[i] = graphics->CreateCommandList(sfMemoryPool);
+
+	// subpasses are supported only in Vulkan
+	if (platform->GetDeviceType() != LLGI::DeviceType::Vulkan)
+	{
+		std::cout << "Subpasses are not supported. The test is skipped." << std::endl;
+	}
+	else
+	{
+		LLGI::RenderTextureInitializationParameter params;
+		params.Size = LLGI::Vec2I(256, 256);
+		auto first = LLGI::CreateSharedPtr(graphics->CreateRenderTexture(params));
+		auto second = LLGI::CreateSharedPtr(graphics->CreateRenderTexture(params));
+
+		// the first subpass draws a rectangle into first, and the second subpass reads it and writes second
+		std::array<LLGI::Texture*, 2> textures = {first.get(), second.get()};
+		auto renderPass = LLGI::CreateSharedPtr(graphics->CreateRenderPass((const LLGI::Texture**)textures.data(), 2, nullptr));
+		renderPass->SetIsColorCleared(true);
+		renderPass->SetClearColor(LLGI::Color8(0, 0, 255, 255));
+
+		std::array<LLGI::SubpassParameter, 2> subpasses;
+		subpasses[0].ColorAttachmentMask = 1 << 0;
+		subpasses[0].IsDepthUsed = false;
+		subpasses[1].ColorAttachmentMask = 1 << 1;
+		subpasses[1].InputAttachmentMask = 1 << 0;
+		subpasses[1].IsDepthUsed = false;
+		EXPECT_TRUE(renderPass->SetSubpasses(subpasses.data(), static_cast<int32_t>(subpasses.size())));
+
+		std::shared_ptr<LLGI::Shader> shader_vs = nullptr;
+		std::shared_ptr<LLGI::Shader> shader_ps = nullptr;
+		std::shared_ptr<LLGI::Shader> shader_input_vs = nullptr;
+		std::shared_ptr<LLGI::Shader> shader_input_ps = nullptr;
+		TestHelper::CreateShader(graphics, deviceType, "simple_rectangle.vert", "simple_rectangle.frag", shader_vs, shader_ps);
+		TestHelper::CreateShader(
+			graphics, deviceType, "simple_rectangle.vert", "simple_subpass_input.frag", shader_input_vs, shader_input_ps);
+
+		std::shared_ptr<LLGI::VertexBuffer> vb;
+		std::shared_ptr<LLGI::IndexBuffer> ib;
+		TestHelper::CreateRectangle(graphics,
+									LLGI::Vec3F(-0.5, 0.5, 0.5),
+									LLGI::Vec3F(0.5, -0.5, 0.5),
+									LLGI::Color8(255, 255, 255, 255),
+									LLGI::Color8(0, 255, 0, 255),
+									vb,
+									ib);
+
+		std::shared_ptr<LLGI::VertexBuffer> screenVB;
+		std::shared_ptr<LLGI::IndexBuffer> screenIB;
+		TestHelper::CreateRectangle(graphics,
+									LLGI::Vec3F(-1.0, 1.0, 0.5),
+									LLGI::Vec3F(1.0, -1.0, 0.5),
+									LLGI::Color8(255, 255, 255, 255),
+									LLGI::Color8(255, 255, 255, 255),
+									screenVB,
+									screenIB);
+
+		auto renderPassPipelineState = LLGI::CreateSharedPtr(graphics->CreateRenderPassPipelineState(renderPass.get()));
+		auto pip = CreateRectanglePipelineState(graphics, renderPassPipelineState.get(), shader_vs.get(), shader_ps.get(), 0);
+		auto pipInput =
+			CreateRectanglePipelineState(graphics, renderPassPipelineState.get(), shader_input_vs.get(), shader_input_ps.get(), 1);
+
+		while (count < 1000)
+		{
+			if (!platform->NewFrame())
+				break;
+
+			sfMemoryPool->NewFrame();
+
+			auto commandList = commandLists[count % commandLists.size()];
+			commandList->Begin();
+			commandList->BeginRenderPass(renderPass.get());
+			commandList->SetVertexBuffer(vb.get(), sizeof(SimpleVertex), 0);
+			commandList->SetIndexBuffer(ib.get());
+			commandList->SetPipelineState(pip.get());
+			commandList->Draw(2);
+
+			// an input attachment is bound at a texture slot
+			commandList->NextSubpass();
+			commandList->SetVertexBuffer(screenVB.get(), sizeof(SimpleVertex), 0);
+			commandList->SetIndexBuffer(screenIB.get());
+			commandList->SetPipelineState(pipInput.get());
+			commandList->SetTexture(
+				first.get(), LLGI::TextureWrapMode::Clamp, LLGI::TextureMinMagFilter::Nearest, 0, LLGI::ShaderStageType::Pixel);
+			commandList->Draw(2);
+			commandList->EndRenderPass();
+
+			commandList->BeginRenderPass(platform->GetCurrentScreen(LLGI::Color8(), true));
+			commandList->EndRenderPass();
+			commandList->End();
+
+			graphics->Execute(commandList);
+
+			platform->Present();
+			count++;
+
+			if (TestHelper::GetIsCaptureRequired() && count == 5)
+			{
+				commandList->WaitUntilCompleted();
+
+				auto dataFirst = graphics->CaptureRenderTarget(first.get());
+				Bitmap2D bitmapFirst(dataFirst, params.Size.X, params.Size.Y, false);
+				bitmapFirst.Save("SubpassInputFirst.png");
+
+				auto dataSecond = graphics->CaptureRenderTarget(second.get());
+				Bitmap2D bitmapSecond(dataSecond, params.Size.X, params.Size.Y, false);
+				bitmapSecond.Save("SubpassInputSecond.png");
+
+				EXPECT_EQ(bitmapFirst.GetPixel(params.Size.X / 2, params.Size.Y / 2).g, 255);
+				EXPECT_EQ(bitmapFirst.GetPixel(params.Size.X / 10, params.Size.Y / 10).b, 255);
+
+				// the second subpass writes first.gbra
+				EXPECT_EQ(bitmapSecond.GetPixel(params.Size.X / 2, params.Size.Y / 2).r, 255);
+				EXPECT_EQ(bitmapSecond.GetPixel(params.Size.X / 10, params.Size.Y / 10).r, 0);
+				EXPECT_EQ(bitmapSecond.GetPixel(params.Size.X / 10, params.Size.Y / 10).g, 255);
+				EXPECT_EQ(bitmapSecond.GetPixel(params.Size.X / 10, params.Size.Y / 10).b, 0);
+				break;
+			}
+		}
+
+		graphics->WaitFinish();
+	}
+
+	LLGI::SafeRelease(sfMemoryPool);
+	for (int i = 0; i < commandLists.size(); i++)
+		LLGI::SafeRelease(commandLists[i]);
+	LLGI::SafeRelease(graphics);
+	LLGI::SafeRelease(platform);
+}
+
+void test_dynamic_rendering(LLGI::DeviceType deviceType)
+{
+	int count = 0;
+
+	LLGI::PlatformParameter pp;
+	pp.Device = deviceType;
+	pp.WaitVSync = true;
+	auto window = std::unique_ptr<LLGI::Window>(LLGI::CreateWindow("DynamicRendering", LLGI::Vec2I(1280, 720)));
+	auto platform = LLGI::CreatePlatform(pp, window.get());
+	LLGI::SafeAddRef(platform);
+
+	auto graphics = platform->CreateGraphics();
+	graphics->SetDisposed([platform]() -> void { platform->Release(); });
+
+	auto sfMemoryPool = graphics->CreateSingleFrameMemoryPool(1024 * 1024, 128);
+
+	std::array<LLGI::CommandList*, 3> commandLists;
+	for (int i = 0; i < commandLists.size(); i++)
+		commandLists[i] = graphics->CreateCommandList(sfMemoryPool);
+
+	bool isSupported = false;
+#if defined(ENABLE_VULKAN)
+	if (platform->GetDeviceType() == LLGI::DeviceType::Vulkan)
+	{
+		isSupported = static_cast<LLGI::GraphicsVulkan*>(graphics)->GetDeviceExtensions().IsDynamicRenderingSupported;
+	}
+#endif
+
+	if (!isSupported)
+	{
+		std::cout << "VK_KHR_dynamic_rendering is not supported. The test is skipped." << std::endl;
+	}
+	else
+	{
+		LLGI::RenderTextureInitializationParameter params;
+		params.Size = LLGI::Vec2I(256, 256);
+		auto renderTexture = LLGI::CreateSharedPtr(graphics->CreateRenderTexture(params));
+
+		auto texturePtr = renderTexture.get();
+		auto renderPass = LLGI::CreateSharedPtr(graphics->CreateRenderPass((const LLGI::Texture**)&texturePtr, 1, nullptr));
+		renderPass->SetIsColorCleared(true);
+		renderPass->SetClearColor(LLGI::Color8(0, 0, 255, 255));
+
+#if defined(ENABLE_VULKAN)
+		// neither a render pass object nor a framebuffer is created
+		auto renderPassVulkan = static_cast<LLGI::RenderPassVulkan*>(renderPass.get());
+		EXPECT_TRUE(renderPassVulkan->renderPassPipelineState->GetIsDynamicRendering());
+		EXPECT_FALSE(static_cast<bool>(renderPassVulkan->frameBuffer_));
+#endif
+
+		std::shared_ptr<LLGI::Shader> shader_vs = nullptr;
+		std::shared_ptr<LLGI::Shader> shader_ps = nullptr;
+		std::shared_ptr<LLGI::Shader> shader_texture_vs = nullptr;
+		std::shared_ptr<LLGI::Shader> shader_texture_ps = nullptr;
+		TestHelper::CreateShader(graphics, deviceType, "simple_rectangle.vert", "simple_rectangle.frag", shader_vs, shader_ps);
+		TestHelper::CreateShader(
+			graphics, deviceType, "simple_texture_rectangle.vert", "simple_texture_rectangle.frag", shader_texture_vs, shader_texture_ps);
+
+		std::shared_ptr<LLGI::VertexBuffer> vb;
+		std::shared_ptr<LLGI::IndexBuffer> ib;
+		TestHelper::CreateRectangle(graphics,
+									LLGI::Vec3F(-0.5, 0.5, 0.5),
+									LLGI::Vec3F(0.5, -0.5, 0.5),
+									LLGI::Color8(255, 255, 255, 255),
+									LLGI::Color8(0, 255, 0, 255),
+									vb,
+									ib);
+
+		std::shared_ptr<LLGI::VertexBuffer> screenVB;
+		std::shared_ptr<LLGI::IndexBuffer> screenIB;
+		TestHelper::CreateRectangle(graphics,
+									LLGI::Vec3F(-1.0, 1.0, 0.5),
+									LLGI::Vec3F(1.0, -1.0, 0.5),
+									LLGI::Color8(255, 255, 255, 255),
+									LLGI::Color8(255, 255, 255, 255),
+									screenVB,
+									screenIB);
+
+		auto renderPassPipelineState = LLGI::CreateSharedPtr(graphics->CreateRenderPassPipelineState(renderPass.get()));
+		auto pip = CreateRectanglePipelineState(graphics, renderPassPipelineState.get(), shader_vs.get(), shader_ps.get());
+
+		std::map<std::shared_ptr<LLGI::RenderPassPipelineState>, std::shared_ptr<LLGI::PipelineState>> screenPips;
+
+		while (count < 1000)
+		{
+			if (!platform->NewFrame())
+				break;
+
+			sfMemoryPool->NewFrame();
+
+			auto commandList = commandLists[count % commandLists.size()];
+			commandList->Begin();
+			commandList->BeginRenderPass(renderPass.get());
+			commandList->SetVertexBuffer(vb.get(), sizeof(SimpleVertex), 0);
+			commandList->SetIndexBuffer(ib.get());
+			commandList->SetPipelineState(pip.get());
+			commandList->Draw(2);
+			commandList->EndRenderPass();
+
+			// a texture is sampled after rendering, so it must be transitioned out of an attachment layout
+			auto screen = platform->GetCurrentScreen(LLGI::Color8(), true);
+			auto screenRenderPassPipelineState = LLGI::CreateSharedPtr(graphics->CreateRenderPassPipelineState(screen));
+			if (screenPips.count(screenRenderPassPipelineState) == 0)
+			{
+				screenPips[screenRenderPassPipelineState] = CreateRectanglePipelineState(
+					graphics, screenRenderPassPipelineState.get(), shader_texture_vs.get(), shader_texture_ps.get());
+			}
+
+			commandList->BeginRenderPass(screen);
+			commandList->SetVertexBuffer(screenVB.get(), sizeof(SimpleVertex), 0);
+			commandList->SetIndexBuffer(screenIB.get());
+			commandList->SetPipelineState(screenPips[screenRenderPassPipelineState].get());
+			commandList->SetTexture(
+				renderTexture.get(), LLGI::TextureWrapMode::Clamp, LLGI::TextureMinMagFilter::Nearest, 0, LLGI::ShaderStageType::Pixel);
+			commandList->Draw(2);
+			commandList->EndRenderPass();
+			commandList->End();
+
+			graphics->Execute(commandList);
+
+			platform->Present();
+			count++;
+
+			if (TestHelper::GetIsCaptureRequired() && count == 5)
+			{
+				commandList->WaitUntilCompleted();
+
+				auto data = graphics->CaptureRenderTarget(renderTexture.get());
+				Bitmap2D bitmap(data, params.Size.X, params.Size.Y, false);
+				bitmap.Save("DynamicRendering.png");
+
+				EXPECT_EQ(bitmap.GetPixel(params.Size.X / 2, params.Size.Y / 2).g, 255);
+				EXPECT_EQ(bitmap.GetPixel(params.Size.X / 10, params.Size.Y / 10).g, 0);
+				EXPECT_EQ(bitmap.GetPixel(params.Size.X / 10, params.Size.Y / 10).b, 255);
+
+				auto screenTexture = screen->GetRenderTexture(0);
+				auto screenSize = screenTexture->GetSizeAs2D();
+				auto screenData = graphics->CaptureRenderTarget(screenTexture);
+				Bitmap2D screenBitmap(screenData, screenSize.X, screenSize.Y, true);
+				screenBitmap.Save("DynamicRenderingScreen.png");
+
+				EXPECT_EQ(screenBitmap.GetPixel(screenSize.X / 2, screenSize.Y / 2).g, 255);
+				EXPECT_EQ(screenBitmap.GetPixel(screenSize.X / 10, screenSize.Y / 10).g, 0);
+				EXPECT_EQ(screenBitmap.GetPixel(screenSize.X / 10, screenSize.Y / 10).b, 255);
+				break;
+			}
+		}
+
+		graphics->WaitFinish();
+	}
+
+	LLGI::SafeRelease(sfMemoryPool);
+	for (int i = 0; i < commandLists.size(); i++)
+		LLGI::SafeRelease(commandLists[i]);
+	LLGI::SafeRelease(graphics);
+	LLGI::SafeRelease(platform);
+}
+
 #if defined(__linux__) || defined(__APPLE__) || defined(WIN32)
 
 TEST(RenderPass, Basic) { test_renderPass(LLGI::DeviceType::Default, RenderPassTestMode::None); }
@@ -1050,4 +1498,10 @@ TEST(RenderPass, CopyTexture) { test_renderPass(LLGI::DeviceType::Default, Rende
 
 TEST(RenderPass, MRT) { test_multiRenderPass(LLGI::DeviceType::Default); }
 
+TEST(RenderPass, MSAAResolve) { test_msaa_resolve(LLGI::DeviceType::Default); }
+
+TEST(RenderPass, SubpassInput) { test_subpass_input(LLGI::DeviceType::Default); }
+
+TEST(RenderPass, DynamicRendering) { test_dynamic_rendering(LLGI::DeviceType::Default); }
+
 #endif
\ No newline at end of file
@@ -0,0 +1,210 @@
+#include "TestHelper.h"
+#include "test.h"
+#include <Utils/LLGI.RenderGraph.h>
+#include <array>
+
+void test_render_graph(LLGI::DeviceType deviceType)
+{
+	int count = 0;
+
+	LLGI::PlatformParameter pp;
+	pp.Device = deviceType;
+	pp.WaitVSync = true;
+	auto window = std::unique_ptr<LLGI::Window>(LLGI::CreateWindow("RenderGraph", LLGI::Vec2I(1280, 720)));
+	auto platform = LLGI::CreatePlatform(pp, window.get());
+	LLGI::SafeAddRef(platform);
+
+	auto graphics = platform->CreateGraphics();
+	graphics->SetDisposed([platform]() -> void { platform->Release(); });
+
+	auto sfMemoryPool = graphics->CreateSingleFrameMemoryPool(1024 * 1024, 128);
+
+	std::array<LLGI::CommandList*, 3> commandLists;
+	for (int i = 0; i < commandLists.size(); i++)
+		commandLists[i] = graphics->CreateCommandList(sfMemoryPool);
+
+	std::shared_ptr<LLGI::Shader> shader_vs = nullptr;
+	std::shared_ptr<LLGI::Shader> shader_ps = nullptr;
+
+	TestHelper::CreateShader(graphics, deviceType, "simple_rectangle.vert", "simple_rectangle.frag", shader_vs, shader_ps);
+
+	std::shared_ptr<LLGI::VertexBuffer> vb;
+	std::shared_ptr<LLGI::IndexBuffer> ib;
+	TestHelper::CreateRectangle(graphics,
+								LLGI::Vec3F(-0.5, 0.5, 0.5),
+								LLGI::Vec3F(0.5, -0.5, 0.5),
+								LLGI::Color8(255, 255, 255, 255),
+								LLGI::Color8(0, 255, 0, 255),
+								vb,
+								ib);
+
+	// results are copied from transient textures because transient textures are valid only in the graph
+	LLGI::RenderTextureInitializationParameter params;
+	params.Size = LLGI::Vec2I(256, 256);
+	auto resultFirst = LLGI::CreateSharedPtr(graphics->CreateRenderTexture(params));
+	auto resultSecond = LLGI::CreateSharedPtr(graphics->CreateRenderTexture(params));
+
+	std::shared_ptr<LLGI::PipelineState> pip;
+	bool isUnusedExecuted = false;
+
+	// first and second are used in different passes, so they may share memory
+	LLGI::RenderGraph graph(graphics);
+	auto first = graph.CreateTexture("First", params.Size, LLGI::TextureFormatType::R8G8B8A8_UNORM);
+	auto second = graph.CreateTexture("Second", params.Size, LLGI::TextureFormatType::R8G8B8A8_UNORM);
+	auto unused = graph.CreateTexture("Unused", params.Size, LLGI::TextureFormatType::R8G8B8A8_UNORM);
+	auto importedFirst = graph.ImportTexture("ResultFirst", resultFirst.get());
+	auto importedSecond = graph.ImportTexture("ResultSecond", resultSecond.get());
+
+	graph.AddPass(
+		"DrawFirst",
+		[&](LLGI::RenderGraph::Builder& builder) -> void {
+			builder.WriteColor(first);
+			builder.SetClearColor(LLGI::Color8(0, 0, 255, 255));
+		},
+		[&](const LLGI::RenderGraph& g, LLGI::CommandList* commandList) -> void {
+			commandList->SetVertexBuffer(vb.get(), sizeof(SimpleVertex), 0);
+			commandList->SetIndexBuffer(ib.get());
+			commandList->SetPipelineState(pip.get());
+			commandList->Draw(2);
+		});
+
+	graph.AddPass(
+		"CopyFirst",
+		[&](LLGI::RenderGraph::Builder& builder) -> void {
+			builder.CopyFrom(first);
+			builder.CopyTo(importedFirst);
+		},
+		[&](const LLGI::RenderGraph& g, LLGI::CommandList* commandList) -> void {
+			commandList->CopyTexture(g.GetTexture(first), g.GetTexture(importedFirst));
+		});
+
+	// nothing reads outputs of this pass, so it is culled and doesn't extend the range of first
+	graph.AddPass(
+		"Unused",
+		[&](LLGI::RenderGraph::Builder& builder) -> void {
+			builder.Read(first);
+			builder.WriteColor(unused);
+			builder.SetClearColor(LLGI::Color8(0, 255, 0, 255));
+		},
+		[&](const LLGI::RenderGraph& g, LLGI::CommandList* commandList) -> void { isUnusedExecuted = true; });
+
+	graph.AddPass(
+		"ClearSecond",
+		[&](LLGI::RenderGraph::Builder& builder) -> void {
+			builder.WriteColor(second);
+			builder.SetClearColor(LLGI::Color8(255, 0, 0, 255));
+		},
+		nullptr);
+
+	graph.AddPass(
+		"CopySecond",
+		[&](LLGI::RenderGraph::Builder& builder) -> void {
+			builder.CopyFrom(second);
+			builder.CopyTo(importedSecond);
+		},
+		[&](const LLGI::RenderGraph& g, LLGI::CommandList* commandList) -> void {
+			commandList->CopyTexture(g.GetTexture(second), g.GetTexture(importedSecond));
+		});
+
+	EXPECT_TRUE(graph.Compile());
+	EXPECT_TRUE(graph.GetIsCulled("Unused"));
+	EXPECT_FALSE(graph.GetIsCulled("CopySecond"));
+	EXPECT_TRUE(graph.GetTexture(unused) == nullptr);
+	EXPECT_TRUE(graph.GetTexture(first) != nullptr);
+	EXPECT_TRUE(graph.GetTexture(second) != nullptr);
+
+	auto renderPassPipelineState = LLGI::CreateSharedPtr(graphics->CreateRenderPassPipelineState(graph.GetRenderPass("DrawFirst")));
+
+	{
+		auto p = graphics->CreatePiplineState();
+		p->VertexLayouts[0] = LLGI::VertexLayoutFormat::R32G32B32_FLOAT;
+		p->VertexLayouts[1] = LLGI::VertexLayoutFormat::R32G32_FLOAT;
+		p->VertexLayouts[2] = LLGI::VertexLayoutFormat::R8G8B8A8_UNORM;
+		p->VertexLayoutNames[0] = "POSITION";
+		p->VertexLayoutNames[1] = "UV";
+		p->VertexLayoutNames[2] = "COLOR";
+		p->VertexLayoutCount = 3;
+
+		p->Culling = LLGI::CullingMode::DoubleSide; // TEMP :vulkan
+		p->SetShader(LLGI::ShaderStageType::Vertex, shader_vs.get());
+		p->SetShader(LLGI::ShaderStageType::Pixel, shader_ps.get());
+		p->SetRenderPassPipelineState(renderPassPipelineState.get());
+		p->Compile();
+
+		pip = LLGI::CreateSharedPtr(p);
+	}
+
+	while (count < 100)
+	{
+		if (!platform->NewFrame())
+			break;
+
+		sfMemoryPool->NewFrame();
+
+		LLGI::Color8 color;
+		color.R = count % 255;
+		color.G = 0;
+		color.B = 0;
+		color.A = 255;
+
+		auto renderPass = platform->GetCurrentScreen(color, true, false); // TODO: isDepthClear is false, because it fails with dx12.
+
+		auto commandList = commandLists[count % commandLists.size()];
+		commandList->Begin();
+		graph.Execute(commandList);
+		commandList->BeginRenderPass(renderPass);
+		commandList->EndRenderPass();
+		commandList->End();
+
+		graphics->Execute(commandList);
+
+		platform->Present();
+		count++;
+
+		if (TestHelper::GetIsCaptureRequired() && count == 5)
+		{
+			commandList->WaitUntilCompleted();
+
+			auto dataFirst = graphics->CaptureRenderTarget(resultFirst.get());
+			Bitmap2D bitmapFirst(dataFirst, params.Size.X, params.Size.Y, false);
+			bitmapFirst.Save("RenderGraphFirst.png");
+
+			auto dataSecond = graphics->CaptureRenderTarget(resultSecond.get());
+			Bitmap2D bitmapSecond(dataSecond, params.Size.X, params.Size.Y, false);
+			bitmapSecond.Save("RenderGraphSecond.png");
+
+			// the rectangle is drawn on the clear color, and the second texture doesn't break it
+			EXPECT_EQ(bitmapFirst.GetPixel(params.Size.X / 2, params.Size.Y / 2).g, 255);
+			EXPECT_EQ(bitmapFirst.GetPixel(params.Size.X / 10, params.Size.Y / 10).g, 0);
+			EXPECT_EQ(bitmapFirst.GetPixel(params.Size.X / 10, params.Size.Y / 10).b, 255);
+
+			// the second texture is cleared even if it shares memory with the first texture
+			EXPECT_EQ(bitmapSecond.GetPixel(params.Size.X / 2, params.Size.Y / 2).r, 255);
+			EXPECT_EQ(bitmapSecond.GetPixel(params.Size.X / 2, params.Size.Y / 2).g, 0);
+			EXPECT_EQ(bitmapSecond.GetPixel(params.Size.X / 10, params.Size.Y / 10).b, 0);
+			break;
+		}
+	}
+
+	EXPECT_FALSE(isUnusedExecuted);
+
+	graphics->WaitFinish();
+
+	graph.Reset();
+	pip.reset();
+	renderPassPipelineState.reset();
+	resultFirst.reset();
+	resultSecond.reset();
+
+	LLGI::SafeRelease(sfMemoryPool);
+	for (int i = 0; i < commandLists.size(); i++)
+		LLGI::SafeRelease(commandLists[i]);
+	LLGI::SafeRelease(graphics);
+	LLGI::SafeRelease(platform);
+}
+
+#if defined(__linux__) || defined(__APPLE__) || defined(WIN32)
+
+TEST(RenderGraph, Basic) { test_render_graph(LLGI::DeviceType::Default); }
+
+#endif
@@ -0,0 +1,149 @@
+#include "test.h"
+#include <Utils/LLGI.RenderTexturePool.h>
+
+//! a texture which counts living textures without a device
+class PoolTestTexture : public LLGI::Texture
+{
+private:
+	int32_t& livingCount_;
+
+public:
+	PoolTestTexture(int32_t& livingCount) : livingCount_(livingCount) { livingCount_++; }
+	~PoolTestTexture() override { livingCount_--; }
+};
+
+//! graphics which creates only textures, so the pool is tested without a device
+class PoolTestGraphics : public LLGI::Graphics
+{
+public:
+	int32_t CreatedCount = 0;
+	int32_t LivingCount = 0;
+
+	LLGI::Texture* CreateRenderTexture(const LLGI::RenderTextureInitializationParameter& parameter) override
+	{
+		CreatedCount++;
+		return new PoolTestTexture(LivingCount);
+	}
+
+	LLGI::Texture* CreateDepthTexture(const LLGI::DepthTextureInitializationParameter& parameter) override
+	{
+		CreatedCount++;
+		return new PoolTestTexture(LivingCount);
+	}
+};
+
+void test_render_texture_pool_reuse()
+{
+	auto graphics = LLGI::CreateSharedPtr(new PoolTestGraphics());
+	LLGI::RenderTexturePool pool(graphics.get());
+
+	LLGI::RenderTextureInitializationParameter params;
+	params.Size = LLGI::Vec2I(256, 256);
+
+	// a released texture is reused in the same frame
+	auto first = pool.AcquireRenderTexture(params);
+	ASSERT_TRUE(first != nullptr);
+	first->Release();
+
+	auto reused = pool.AcquireRenderTexture(params);
+	EXPECT_EQ(reused, first);
+	EXPECT_EQ(graphics->CreatedCount, 1);
+
+	// a held texture is not reused
+	auto held = pool.AcquireRenderTexture(params);
+	EXPECT_NE(held, reused);
+	EXPECT_EQ(graphics->CreatedCount, 2);
+
+	// a texture which is referred by others, like a command list, is not reused even if a user releases it
+	reused->AddRef(); // a command list refers it
+	reused->Release(); // a user releases it
+	auto another = pool.AcquireRenderTexture(params);
+	EXPECT_NE(another, reused);
+	EXPECT_NE(another, held);
+	EXPECT_EQ(graphics->CreatedCount, 3);
+	reused->Release();
+
+	// textures with different parameters are not shared
+	LLGI::RenderTextureInitializationParameter largeParams;
+	largeParams.Size = LLGI::Vec2I(512, 512);
+	auto large = pool.AcquireRenderTexture(largeParams);
+	EXPECT_EQ(graphics->CreatedCount, 4);
+
+	LLGI::DepthTextureInitializationParameter depthParams;
+	depthParams.Size = params.Size;
+	auto depth = pool.AcquireDepthTexture(depthParams);
+	EXPECT_EQ(graphics->CreatedCount, 5);
+	EXPECT_EQ(pool.GetTextureCount(), 5);
+
+	held->Release();
+	another->Release();
+	large->Release();
+	depth->Release();
+}
+
+void test_render_texture_pool_eviction()
+{
+	auto graphics = LLGI::CreateSharedPtr(new PoolTestGraphics());
+
+	{
+		const int32_t evictionFrames = 2;
+		LLGI::RenderTexturePool pool(graphics.get(), evictionFrames);
+
+		LLGI::RenderTextureInitializationParameter params;
+		params.Size = LLGI::Vec2I(256, 256);
+
+		auto idle = pool.AcquireRenderTexture(params);
+		auto held = pool.AcquireRenderTexture(params);
+		idle->Release();
+		EXPECT_EQ(graphics->LivingCount, 2);
+
+		// an idle texture is kept for evictionFrames
+		for (int32_t i = 0; i < evictionFrames; i++)
+		{
+			pool.NewFrame();
+		}
+		EXPECT_EQ(pool.GetTextureCount(), 2);
+
+		// an idle texture is destroyed, but a held texture is kept however many frames pass
+		pool.NewFrame();
+		EXPECT_EQ(pool.GetTextureCount(), 1);
+		EXPECT_EQ(graphics->LivingCount, 1);
+
+		for (int32_t i = 0; i < evictionFrames * 2; i++)
+		{
+			pool.NewFrame();
+		}
+		EXPECT_EQ(pool.GetTextureCount(), 1);
+
+		// a texture which was held until the last frame is not evicted immediately after it is released
+		held->Release();
+		pool.NewFrame();
+		EXPECT_EQ(pool.GetTextureCount(), 1);
+
+		auto reused = pool.AcquireRenderTexture(params);
+		EXPECT_EQ(reused, held);
+		EXPECT_EQ(graphics->CreatedCount, 2);
+		reused->Release();
+
+		for (int32_t i = 0; i <= evictionFrames; i++)
+		{
+			pool.NewFrame();
+		}
+		EXPECT_EQ(pool.GetTextureCount(), 0);
+		EXPECT_EQ(graphics->LivingCount, 0);
+
+		// the pool releases textures which remain when it is destroyed
+		pool.AcquireRenderTexture(params)->Release();
+		EXPECT_EQ(graphics->LivingCount, 1);
+	}
+
+	EXPECT_EQ(graphics->LivingCount, 0);
+}
+
+#if defined(__linux__) || defined(__APPLE__) || defined(WIN32)
+
+TEST(RenderTexturePool, Reuse) { test_render_texture_pool_reuse(); }
+
+TEST(RenderTexturePool, Eviction) { test_render_texture_pool_eviction(); }
+
+#endif
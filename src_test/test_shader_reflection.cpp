@@ -0,0 +1,145 @@
+#include "TestHelper.h"
+#include "test.h"
+
+#if defined(ENABLE_VULKAN)
+
+#include <Vulkan/LLGI.ShaderReflectionVulkan.h>
+
+//! binaries are loaded from SPIR-V shaders next to this file whichever device is tested
+static std::vector<uint8_t> LoadSPIRV(const char* name)
+{
+	auto path = std::string(__FILE__);
+#if defined(WIN32)
+	auto pos = path.find_last_of("\\/");
+#else
+	auto pos = path.find_last_of("/");
+#endif
+	path = path.substr(0, pos) + "/Shaders/SPIRV/" + name;
+	return TestHelper::LoadDataWithoutRoot(path.c_str());
+}
+
+static const LLGI::ShaderReflectionVulkan::Binding*
+FindBinding(const LLGI::ShaderReflectionVulkan& reflection, int32_t set, int32_t binding)
+{
+	for (const auto& b : reflection.Bindings)
+	{
+		if (b.Set == set && b.Binding == binding)
+			return &b;
+	}
+	return nullptr;
+}
+
+void test_shader_reflection_vertex()
+{
+	auto binary = LoadSPIRV("simple_constant_rectangle.vert.spv");
+	ASSERT_TRUE(binary.size() > 0);
+
+	LLGI::ShaderReflectionVulkan reflection;
+	ASSERT_TRUE(reflection.Initialize(binary.data(), binary.size()));
+
+	// gl_Position is a built-in variable, so only inputs with locations are reflected
+	ASSERT_EQ(reflection.VertexInputs.size(), 3u);
+	EXPECT_EQ(reflection.VertexInputs[0].Location, 0);
+	EXPECT_EQ(reflection.VertexInputs[0].Name, "a_position");
+	EXPECT_EQ(reflection.VertexInputs[0].ComponentCount, 3);
+	EXPECT_TRUE(reflection.VertexInputs[0].IsFloat);
+	EXPECT_EQ(reflection.VertexInputs[1].Location, 1);
+	EXPECT_EQ(reflection.VertexInputs[1].Name, "a_uv");
+	EXPECT_EQ(reflection.VertexInputs[1].ComponentCount, 2);
+	EXPECT_EQ(reflection.VertexInputs[2].Location, 2);
+	EXPECT_EQ(reflection.VertexInputs[2].Name, "a_color");
+	EXPECT_EQ(reflection.VertexInputs[2].ComponentCount, 4);
+
+	LLGI::VertexLayoutFormat format;
+	EXPECT_TRUE(LLGI::ShaderReflectionVulkan::GetVertexLayoutFormat(reflection.VertexInputs[0], format));
+	EXPECT_TRUE(format == LLGI::VertexLayoutFormat::R32G32B32_FLOAT);
+
+	ASSERT_EQ(reflection.Bindings.size(), 1u);
+	auto block = FindBinding(reflection, 0, 0);
+	ASSERT_TRUE(block != nullptr);
+	EXPECT_TRUE(block->Type == LLGI::ShaderBindingTypeVulkan::UniformBuffer);
+	EXPECT_EQ(block->Size, 16);
+
+	EXPECT_EQ(reflection.PushConstantSize, 0);
+}
+
+void test_shader_reflection_pixel()
+{
+	auto constantBinary = LoadSPIRV("simple_constant_rectangle.frag.spv");
+	ASSERT_TRUE(constantBinary.size() > 0);
+
+	LLGI::ShaderReflectionVulkan constantReflection;
+	ASSERT_TRUE(constantReflection.Initialize(constantBinary.data(), constantBinary.size()));
+
+	auto block = FindBinding(constantReflection, 1, 0);
+	ASSERT_TRUE(block != nullptr);
+	EXPECT_TRUE(block->Type == LLGI::ShaderBindingTypeVulkan::UniformBuffer);
+	EXPECT_EQ(block->Size, 16);
+
+	auto textureBinary = LoadSPIRV("simple_texture_rectangle.frag.spv");
+	ASSERT_TRUE(textureBinary.size() > 0);
+
+	LLGI::ShaderReflectionVulkan textureReflection;
+	ASSERT_TRUE(textureReflection.Initialize(textureBinary.data(), textureBinary.size()));
+
+	ASSERT_EQ(textureReflection.Bindings.size(), 1u);
+	auto texture = FindBinding(textureReflection, 1, 1);
+	ASSERT_TRUE(texture != nullptr);
+	EXPECT_TRUE(texture->Type == LLGI::ShaderBindingTypeVulkan::CombinedImageSampler);
+	EXPECT_EQ(textureReflection.PushConstantSize, 0);
+
+	auto inputBinary = LoadSPIRV("simple_subpass_input.frag.spv");
+	ASSERT_TRUE(inputBinary.size() > 0);
+
+	LLGI::ShaderReflectionVulkan inputReflection;
+	ASSERT_TRUE(inputReflection.Initialize(inputBinary.data(), inputBinary.size()));
+
+	ASSERT_EQ(inputReflection.Bindings.size(), 1u);
+	auto input = FindBinding(inputReflection, 1, 1);
+	ASSERT_TRUE(input != nullptr);
+	EXPECT_TRUE(input->Type == LLGI::ShaderBindingTypeVulkan::InputAttachment);
+}
+
+void test_shader_reflection_push_constant()
+{
+	// a module which declares only "layout(push_constant) uniform Block { layout(offset = 16) vec4 a; float b; }"
+	const uint32_t words[] = {
+		0x07230203, 0x00010000, 0, 6, 0,
+		(5 << 16) | 72, 3, 0, 35, 16, // OpMemberDecorate %3 0 Offset 16
+		(5 << 16) | 72, 3, 1, 35, 32, // OpMemberDecorate %3 1 Offset 32
+		(3 << 16) | 71, 3, 2,		  // OpDecorate %3 Block
+		(3 << 16) | 22, 1, 32,		  // %1 = OpTypeFloat 32
+		(4 << 16) | 23, 2, 1, 4,	  // %2 = OpTypeVector %1 4
+		(4 << 16) | 30, 3, 2, 1,	  // %3 = OpTypeStruct %2 %1
+		(4 << 16) | 32, 4, 9, 3,	  // %4 = OpTypePointer PushConstant %3
+		(4 << 16) | 59, 4, 5, 9,	  // %5 = OpVariable %4 PushConstant
+	};
+
+	LLGI::ShaderReflectionVulkan reflection;
+	ASSERT_TRUE(reflection.Initialize(words, sizeof(words)));
+	EXPECT_EQ(reflection.PushConstantOffset, 16);
+	EXPECT_EQ(reflection.PushConstantSize, 36);
+	EXPECT_EQ(reflection.Bindings.size(), 0u);
+	EXPECT_EQ(reflection.VertexInputs.size(), 0u);
+
+	// a broken module is rejected
+	auto broken = std::vector<uint32_t>(words, words + sizeof(words) / sizeof(uint32_t));
+	broken[0] = 0;
+	EXPECT_FALSE(reflection.Initialize(broken.data(), broken.size() * sizeof(uint32_t)));
+
+	broken[0] = words[0];
+	broken[5] = (64 << 16) | 72;
+	EXPECT_FALSE(reflection.Initialize(broken.data(), broken.size() * sizeof(uint32_t)));
+}
+
+#if defined(__linux__) || defined(__APPLE__) || defined(WIN32)
+
+TEST(ShaderReflection, Vertex) { test_shader_reflection_vertex(); }
+
+TEST(ShaderReflection, Pixel) { test_shader_reflection_pixel(); }
+
+TEST(ShaderReflection, PushConstant) { test_shader_reflection_push_constant(); }
+
+#endif
+
+#endif
@@ -2,6 +2,7 @@
 #include "TestHelper.h"
 #include "test.h"
 
+#include <LLGI.IndirectBuffer.h>
 #include <Utils/LLGI.CommandListPool.h>
 #include <array>
 #include <fstream>
@@ -222,6 +223,347 @@ void test_index_offset(LLGI::DeviceType deviceType)
 	LLGI::SafeRelease(platform);
 }
 
+void test_draw_range(LLGI::DeviceType deviceType, DrawRangeTestMode mode)
+{
+	int count = 0;
+
+	LLGI::PlatformParameter pp;
+	pp.Device = deviceType;
+	pp.WaitVSync = true;
+	auto window = std::unique_ptr<LLGI::Window>(LLGI::CreateWindow("DrawRange", LLGI::Vec2I(1280, 720)));
+	auto platform = LLGI::CreatePlatform(pp, window.get());
+	LLGI::SafeAddRef(platform);
+
+	auto graphics = platform->CreateGraphics();
+	graphics->SetDisposed([platform]() -> void { platform->Release(); });
+
+	auto sfMemoryPool = graphics->CreateSingleFrameMemoryPool(1024 * 1024, 128);
+
+	std::array<LLGI::CommandList*, 3> commandLists;
+	for (int i = 0; i < commandLists.size(); i++)
+		commandLists[i] = graphics->CreateCommandList(sfMemoryPool);
+
+	std::shared_ptr<LLGI::Shader> shader_vs = nullptr;
+	std::shared_ptr<LLGI::Shader> shader_ps = nullptr;
+
+	TestHelper::CreateShader(graphics, deviceType, "simple_rectangle.vert", "simple_rectangle.frag", shader_vs, shader_ps);
+
+	std::shared_ptr<LLGI::VertexBuffer> vb;
+	std::shared_ptr<LLGI::IndexBuffer> ib;
+	TestHelper::CreateRectangle(graphics,
+								LLGI::Vec3F(-0.5, 0.5, 0.5),
+								LLGI::Vec3F(0.5, -0.5, 0.5),
+								LLGI::Color8(255, 255, 255, 255),
+								LLGI::Color8(0, 255, 0, 255),
+								vb,
+								ib);
+
+	// vertices of the rectangle follow degenerate vertices, so the rectangle is drawn only if an offset of vertices is applied
+	auto shiftedVB = LLGI::CreateSharedPtr(graphics->CreateVertexBuffer(sizeof(SimpleVertex) * 8));
+	{
+		auto buf = static_cast<SimpleVertex*>(shiftedVB->Lock());
+		for (int i = 0; i < 4; i++)
+		{
+			buf[i].Pos = LLGI::Vec3F(-1.0f, -1.0f, 0.5f);
+			buf[i].UV = LLGI::Vec2F(0.0f, 0.0f);
+			buf[i].Color = LLGI::Color8(255, 0, 0, 255);
+		}
+
+		buf[4].Pos = LLGI::Vec3F(-0.5f, 0.5f, 0.5f);
+		buf[5].Pos = LLGI::Vec3F(0.5f, 0.5f, 0.5f);
+		buf[6].Pos = LLGI::Vec3F(0.5f, -0.5f, 0.5f);
+		buf[7].Pos = LLGI::Vec3F(-0.5f, -0.5f, 0.5f);
+
+		buf[4].UV = LLGI::Vec2F(0.0f, 0.0f);
+		buf[5].UV = LLGI::Vec2F(1.0f, 0.0f);
+		buf[6].UV = LLGI::Vec2F(1.0f, 1.0f);
+		buf[7].UV = LLGI::Vec2F(0.0f, 1.0f);
+
+		buf[4].Color = LLGI::Color8(255, 255, 255, 255);
+		buf[5].Color = LLGI::Color8(255, 255, 0, 255);
+		buf[6].Color = LLGI::Color8(0, 255, 0, 255);
+		buf[7].Color = LLGI::Color8(0, 255, 255, 255);
+
+		shiftedVB->Unlock();
+	}
+
+	std::map<std::shared_ptr<LLGI::RenderPassPipelineState>, std::shared_ptr<LLGI::PipelineState>> pips;
+
+	while (count < 100)
+	{
+		if (!platform->NewFrame())
+			break;
+
+		sfMemoryPool->NewFrame();
+
+		LLGI::Color8 color;
+		color.R = count % 255;
+		color.G = 0;
+		color.B = 0;
+		color.A = 255;
+
+		auto renderPass = platform->GetCurrentScreen(color, true, false); // TODO: isDepthClear is false, because it fails with dx12.
+		auto renderPassPipelineState = LLGI::CreateSharedPtr(graphics->CreateRenderPassPipelineState(renderPass));
+
+		if (pips.count(renderPassPipelineState) == 0)
+		{
+			auto pip = graphics->CreatePiplineState();
+			pip->VertexLayouts[0] = LLGI::VertexLayoutFormat::R32G32B32_FLOAT;
+			pip->VertexLayouts[1] = LLGI::VertexLayoutFormat::R32G32_FLOAT;
+			pip->VertexLayouts[2] = LLGI::VertexLayoutFormat::R8G8B8A8_UNORM;
+			pip->VertexLayoutNames[0] = "POSITION";
+			pip->VertexLayoutNames[1] = "UV";
+			pip->VertexLayoutNames[2] = "COLOR";
+			pip->VertexLayoutCount = 3;
+
+			pip->Culling = LLGI::CullingMode::DoubleSide; // TEMP :vulkan
+			pip->SetShader(LLGI::ShaderStageType::Vertex, shader_vs.get());
+			pip->SetShader(LLGI::ShaderStageType::Pixel, shader_ps.get());
+			pip->SetRenderPassPipelineState(renderPassPipelineState.get());
+			pip->Compile();
+
+			pips[renderPassPipelineState] = LLGI::CreateSharedPtr(pip);
+		}
+
+		auto commandList = commandLists[count % commandLists.size()];
+		commandList->Begin();
+		commandList->BeginRenderPass(renderPass);
+		commandList->SetVertexBuffer(mode == DrawRangeTestMode::Indexed ? vb.get() : shiftedVB.get(), sizeof(SimpleVertex), 0);
+		commandList->SetIndexBuffer(ib.get());
+		commandList->SetPipelineState(pips[renderPassPipelineState].get());
+
+		// the lower left triangle is drawn with indices and the upper right triangle is drawn without indices
+		if (mode == DrawRangeTestMode::Indexed)
+		{
+			commandList->DrawIndexed(3, 3, 0);
+		}
+		else if (mode == DrawRangeTestMode::BaseVertex)
+		{
+			commandList->DrawIndexed(3, 3, 4);
+		}
+		else
+		{
+			commandList->DrawNonIndexed(3, 4);
+		}
+
+		commandList->EndRenderPass();
+		commandList->End();
+
+		graphics->Execute(commandList);
+
+		platform->Present();
+		count++;
+
+		if (TestHelper::GetIsCaptureRequired() && count == 5)
+		{
+			commandList->WaitUntilCompleted();
+			auto texture = platform->GetCurrentScreen(LLGI::Color8(), true)->GetRenderTexture(0);
+			auto data = graphics->CaptureRenderTarget(texture);
+			auto size = texture->GetSizeAs2D();
+			Bitmap2D bitmap(data, size.X, size.Y, true);
+
+			if (mode == DrawRangeTestMode::Indexed)
+			{
+				bitmap.Save("SimpleRenderDrawRange.png");
+			}
+			else if (mode == DrawRangeTestMode::BaseVertex)
+			{
+				bitmap.Save("SimpleRenderDrawRangeBaseVertex.png");
+			}
+			else
+			{
+				bitmap.Save("SimpleRenderDrawRangeNonIndexed.png");
+			}
+
+			auto isLowerLeftDrawn = mode != DrawRangeTestMode::NonIndexed;
+			EXPECT_EQ(bitmap.GetPixel(size.X * 35 / 100, size.Y * 65 / 100).g, isLowerLeftDrawn ? 255 : 0);
+			EXPECT_EQ(bitmap.GetPixel(size.X * 65 / 100, size.Y * 35 / 100).g, isLowerLeftDrawn ? 0 : 255);
+			EXPECT_EQ(bitmap.GetPixel(size.X / 10, size.Y / 10).g, 0);
+			break;
+		}
+	}
+
+	pips.clear();
+
+	graphics->WaitFinish();
+
+	LLGI::SafeRelease(sfMemoryPool);
+	for (int i = 0; i < commandLists.size(); i++)
+		LLGI::SafeRelease(commandLists[i]);
+	LLGI::SafeRelease(graphics);
+	LLGI::SafeRelease(platform);
+}
+
+void test_draw_multi(LLGI::DeviceType deviceType, DrawMultiTestMode mode)
+{
+	int count = 0;
+
+	LLGI::PlatformParameter pp;
+	pp.Device = deviceType;
+	pp.WaitVSync = true;
+	auto window = std::unique_ptr<LLGI::Window>(LLGI::CreateWindow("DrawMulti", LLGI::Vec2I(1280, 720)));
+	auto platform = LLGI::CreatePlatform(pp, window.get());
+	LLGI::SafeAddRef(platform);
+
+	auto graphics = platform->CreateGraphics();
+	graphics->SetDisposed([platform]() -> void { platform->Release(); });
+
+	// indirect buffers are not supported in some platforms
+	std::shared_ptr<LLGI::IndirectBuffer> indirectBuffer;
+	if (mode == DrawMultiTestMode::Indirect)
+	{
+		indirectBuffer = LLGI::CreateSharedPtr(
+			graphics->CreateIndirectBuffer(sizeof(LLGI::DrawIndirectArguments) + sizeof(LLGI::DrawIndexedIndirectArguments)));
+
+		if (indirectBuffer == nullptr)
+		{
+			std::cout << "Skip DrawMulti because indirect buffers are not supported." << std::endl;
+			LLGI::SafeRelease(graphics);
+			LLGI::SafeRelease(platform);
+			return;
+		}
+
+		// the first triangle is drawn without indices and the second triangle is drawn with indices
+		auto buf = static_cast<uint8_t*>(indirectBuffer->Lock());
+		auto args = reinterpret_cast<LLGI::DrawIndirectArguments*>(buf);
+		args->VertexCount = 3;
+		args->InstanceCount = 1;
+		args->FirstVertex = 0;
+		args->FirstInstance = 0;
+
+		auto indexedArgs = reinterpret_cast<LLGI::DrawIndexedIndirectArguments*>(buf + sizeof(LLGI::DrawIndirectArguments));
+		indexedArgs->IndexCount = 3;
+		indexedArgs->InstanceCount = 1;
+		indexedArgs->FirstIndex = 3;
+		indexedArgs->VertexOffset = 0;
+		indexedArgs->FirstInstance = 0;
+		indirectBuffer->Unlock();
+	}
+
+	auto sfMemoryPool = graphics->CreateSingleFrameMemoryPool(1024 * 1024, 128);
+
+	std::array<LLGI::CommandList*, 3> commandLists;
+	for (int i = 0; i < commandLists.size(); i++)
+		commandLists[i] = graphics->CreateCommandList(sfMemoryPool);
+
+	std::shared_ptr<LLGI::Shader> shader_vs = nullptr;
+	std::shared_ptr<LLGI::Shader> shader_ps = nullptr;
+
+	TestHelper::CreateShader(graphics, deviceType, "simple_rectangle.vert", "simple_rectangle.frag", shader_vs, shader_ps);
+
+	std::shared_ptr<LLGI::VertexBuffer> vb;
+	std::shared_ptr<LLGI::IndexBuffer> ib;
+	TestHelper::CreateRectangle(graphics,
+								LLGI::Vec3F(-0.5, 0.5, 0.5),
+								LLGI::Vec3F(0.5, -0.5, 0.5),
+								LLGI::Color8(255, 255, 255, 255),
+								LLGI::Color8(0, 255, 0, 255),
+								vb,
+								ib);
+
+	// each range draws one triangle of the rectangle
+	std::array<LLGI::DrawIndexedRange, 2> ranges;
+	ranges[0].FirstIndex = 0;
+	ranges[0].IndexCount = 3;
+	ranges[0].VertexOffset = 0;
+	ranges[1].FirstIndex = 3;
+	ranges[1].IndexCount = 3;
+	ranges[1].VertexOffset = 0;
+
+	std::map<std::shared_ptr<LLGI::RenderPassPipelineState>, std::shared_ptr<LLGI::PipelineState>> pips;
+
+	while (count < 100)
+	{
+		if (!platform->NewFrame())
+			break;
+
+		sfMemoryPool->NewFrame();
+
+		LLGI::Color8 color;
+		color.R = count % 255;
+		color.G = 0;
+		color.B = 0;
+		color.A = 255;
+
+		auto renderPass = platform->GetCurrentScreen(color, true, false); // TODO: isDepthClear is false, because it fails with dx12.
+		auto renderPassPipelineState = LLGI::CreateSharedPtr(graphics->CreateRenderPassPipelineState(renderPass));
+
+		if (pips.count(renderPassPipelineState) == 0)
+		{
+			auto pip = graphics->CreatePiplineState();
+			pip->VertexLayouts[0] = LLGI::VertexLayoutFormat::R32G32B32_FLOAT;
+			pip->VertexLayouts[1] = LLGI::VertexLayoutFormat::R32G32_FLOAT;
+			pip->VertexLayouts[2] = LLGI::VertexLayoutFormat::R8G8B8A8_UNORM;
+			pip->VertexLayoutNames[0] = "POSITION";
+			pip->VertexLayoutNames[1] = "UV";
+			pip->VertexLayoutNames[2] = "COLOR";
+			pip->VertexLayoutCount = 3;
+
+			pip->Culling = LLGI::CullingMode::DoubleSide; // TEMP :vulkan
+			pip->SetShader(LLGI::ShaderStageType::Vertex, shader_vs.get());
+			pip->SetShader(LLGI::ShaderStageType::Pixel, shader_ps.get());
+			pip->SetRenderPassPipelineState(renderPassPipelineState.get());
+			pip->Compile();
+
+			pips[renderPassPipelineState] = LLGI::CreateSharedPtr(pip);
+		}
+
+		auto commandList = commandLists[count % commandLists.size()];
+		commandList->Begin();
+		commandList->BeginRenderPass(renderPass);
+		commandList->SetVertexBuffer(vb.get(), sizeof(SimpleVertex), 0);
+		commandList->SetIndexBuffer(ib.get());
+		commandList->SetPipelineState(pips[renderPassPipelineState].get());
+
+		if (mode == DrawMultiTestMode::Multi)
+		{
+			commandList->DrawIndexedMulti(ranges.data(), static_cast<int32_t>(ranges.size()));
+		}
+		else
+		{
+			commandList->DrawIndirect(indirectBuffer.get(), 0, 1, sizeof(LLGI::DrawIndirectArguments));
+			commandList->DrawIndexedIndirect(
+				indirectBuffer.get(), sizeof(LLGI::DrawIndirectArguments), 1, sizeof(LLGI::DrawIndexedIndirectArguments));
+		}
+
+		commandList->EndRenderPass();
+		commandList->End();
+
+		graphics->Execute(commandList);
+
+		platform->Present();
+		count++;
+
+		if (TestHelper::GetIsCaptureRequired() && count == 5)
+		{
+			commandList->WaitUntilCompleted();
+			auto texture = platform->GetCurrentScreen(LLGI::Color8(), true)->GetRenderTexture(0);
+			auto data = graphics->CaptureRenderTarget(texture);
+			auto size = texture->GetSizeAs2D();
+			Bitmap2D bitmap(data, size.X, size.Y, true);
+			bitmap.Save(mode == DrawMultiTestMode::Multi ? "SimpleRenderDrawMulti.png" : "SimpleRenderDrawIndirect.png");
+
+			// both triangles are drawn whichever diagonal splits the rectangle
+			EXPECT_EQ(bitmap.GetPixel(size.X * 3 / 10, size.Y / 2).g, 255);
+			EXPECT_EQ(bitmap.GetPixel(size.X * 7 / 10, size.Y / 2).g, 255);
+			EXPECT_EQ(bitmap.GetPixel(size.X / 2, size.Y * 3 / 10).g, 255);
+			EXPECT_EQ(bitmap.GetPixel(size.X / 2, size.Y * 7 / 10).g, 255);
+			EXPECT_EQ(bitmap.GetPixel(size.X / 10, size.Y / 10).g, 0);
+			break;
+		}
+	}
+
+	pips.clear();
+
+	graphics->WaitFinish();
+
+	LLGI::SafeRelease(sfMemoryPool);
+	for (int i = 0; i < commandLists.size(); i++)
+		LLGI::SafeRelease(commandLists[i]);
+	LLGI::SafeRelease(graphics);
+	LLGI::SafeRelease(platform);
+}
+
 void test_simple_constant_rectangle(LLGI::ConstantBufferType type, LLGI::DeviceType deviceType)
 {
 	auto code_gl_vs = R"(
@@ -864,6 +1206,16 @@ TEST(SimpleRender, Basic) { test_simple_rectangle(LLGI::DeviceType::Default); }
 
 TEST(SimpleRender, IndexOffset) { test_index_offset(LLGI::DeviceType::Default); }
 
+TEST(SimpleRender, DrawRange) { test_draw_range(LLGI::DeviceType::Default, DrawRangeTestMode::Indexed); }
+
+TEST(SimpleRender, DrawRangeBaseVertex) { test_draw_range(LLGI::DeviceType::Default, DrawRangeTestMode::BaseVertex); }
+
+TEST(SimpleRender, DrawRangeNonIndexed) { test_draw_range(LLGI::DeviceType::Default, DrawRangeTestMode::NonIndexed); }
+
+TEST(SimpleRender, DrawMulti) { test_draw_multi(LLGI::DeviceType::Default, DrawMultiTestMode::Multi); }
+
+TEST(SimpleRender, DrawIndirect) { test_draw_multi(LLGI::DeviceType::Default, DrawMultiTestMode::Indirect); }
+
 TEST(SimpleRender, ConstantLT) { test_simple_constant_rectangle(LLGI::ConstantBufferType::LongTime, LLGI::DeviceType::Default); }
 
 TEST(SimpleRender, ConstantST) { test_simple_constant_rectangle(LLGI::ConstantBufferType::ShortTime, LLGI::DeviceType::Default); }
@@ -0,0 +1,414 @@
+// llgi_shaderc
+// compiles GLSL shaders in a directory into SPIR-V
+// usage : llgi_shaderc [-f] [-O|-Os] [-DNAME[=VALUE]]... [-IDIRECTORY]... [-p PACK] <input directory> <output directory>
+// -O optimizes binaries for performance and -Os optimizes them for size
+// -p writes all binaries into a pack which is loaded with GraphicsVulkan::CreateShaderPack. shaders are named <name>.vert and <name>.frag
+// <name>.vert and <name>.frag are compiled into <name>.vert.spv and <name>.frag.spv
+// a shader is compiled only if its binary does not exist or is older than the source or files in include directories
+// unless -f is specified. all shaders are compiled if -O, -Os, -D or -I differs from the previous build
+
+#include <LLGI.Compiler.h>
+#include <Utils/LLGI.ShaderPack.h>
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <dirent.h>
+#endif
+
+struct ShaderFile
+{
+	std::string InputPath;
+	std::string OutputPath;
+	LLGI::ShaderStageType Stage;
+	std::string Code;
+};
+
+static bool EndsWith(const std::string& s, const std::string& suffix)
+{
+	return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+static std::vector<std::string> GetFileNames(const std::string& directory)
+{
+	std::vector<std::string> ret;
+
+#ifdef _WIN32
+	_finddata_t data;
+	auto handle = _findfirst((directory + "/*").c_str(), &data);
+	if (handle == -1)
+	{
+		return ret;
+	}
+
+	do
+	{
+		if ((data.attrib & _A_SUBDIR) == 0)
+		{
+			ret.push_back(data.name);
+		}
+	} while (_findnext(handle, &data) == 0);
+
+	_findclose(handle);
+#else
+	auto dir = opendir(directory.c_str());
+	if (dir == nullptr)
+	{
+		return ret;
+	}
+
+	while (auto entry = readdir(dir))
+	{
+		ret.push_back(entry->d_name);
+	}
+
+	closedir(dir);
+#endif
+
+	return ret;
+}
+
+static bool GetModifiedTime(const std::string& path, time_t& time)
+{
+	struct stat st;
+	if (stat(path.c_str(), &st) != 0)
+	{
+		return false;
+	}
+
+	time = st.st_mtime;
+	return true;
+}
+
+static bool ReadFile(const std::string& path, std::string& code)
+{
+	std::ifstream ifs(path, std::ios::binary);
+	if (!ifs)
+	{
+		return false;
+	}
+
+	std::stringstream ss;
+	ss << ifs.rdbuf();
+	code = ss.str();
+	return true;
+}
+
+static bool WriteFile(const std::string& path, const std::vector<uint8_t>& binary)
+{
+	std::ofstream ofs(path, std::ios::binary);
+	if (!ofs)
+	{
+		return false;
+	}
+
+	ofs.write(reinterpret_cast<const char*>(binary.data()), binary.size());
+	return static_cast<bool>(ofs);
+}
+
+static bool ReadBinary(const std::string& path, std::vector<uint8_t>& binary)
+{
+	std::ifstream ifs(path, std::ios::binary);
+	if (!ifs)
+	{
+		return false;
+	}
+
+	binary.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+	return true;
+}
+
+//! the name of a file in an output directory which records options of the previous build
+static const char* OptionStampName = ".llgi_shaderc_options";
+
+static std::string GetOptionStamp(LLGI::CompilerOptimizationLevel optimizationLevel,
+								  const std::vector<LLGI::CompilerDefine>& defines,
+								  const std::vector<std::string>& includeDirectories)
+{
+	std::ostringstream ss;
+	ss << "O " << static_cast<int>(optimizationLevel) << std::endl;
+
+	for (const auto& define : defines)
+	{
+		ss << "D " << define.Name << "=" << define.Value << std::endl;
+	}
+
+	for (const auto& directory : includeDirectories)
+	{
+		ss << "I " << directory << std::endl;
+	}
+
+	return ss.str();
+}
+
+static bool WriteText(const std::string& path, const std::string& text)
+{
+	std::ofstream ofs(path, std::ios::binary);
+	if (!ofs)
+	{
+		return false;
+	}
+
+	ofs << text;
+	return static_cast<bool>(ofs);
+}
+
+static void PrintUsage()
+{
+	std::cout << "usage : llgi_shaderc [-f] [-O|-Os] [-DNAME[=VALUE]]... [-IDIRECTORY]... [-p PACK] <input directory> <output directory>"
+			  << std::endl;
+}
+
+static bool CompileShaders(const std::vector<ShaderFile>& files,
+						   const std::vector<LLGI::CompilerDefine>& defines,
+						   const std::vector<std::string>& includeDirectories,
+						   LLGI::CompilerOptimizationLevel optimizationLevel)
+{
+	auto compiler = LLGI::CreateCompiler(LLGI::DeviceType::Vulkan);
+	if (compiler == nullptr)
+	{
+		std::cout << "Failed to create a compiler." << std::endl;
+		return false;
+	}
+
+	for (const auto& directory : includeDirectories)
+	{
+		compiler->AddIncludeDirectory(directory.c_str());
+	}
+
+	compiler->SetOptimizationLevel(optimizationLevel);
+
+	std::vector<LLGI::CompilerJob> jobs(files.size());
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		jobs[i].Code = files[i].Code.c_str();
+		jobs[i].Stage = files[i].Stage;
+		jobs[i].Defines = defines;
+	}
+
+	compiler->CompileBatch(jobs.data(), static_cast<int32_t>(jobs.size()));
+
+	bool ret = true;
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		const auto& result = jobs[i].Result;
+
+		if (result.Message != "")
+		{
+			std::cout << files[i].InputPath << std::endl << result.Message << std::endl;
+		}
+
+		if (result.Binary.size() == 0)
+		{
+			std::cout << "Failed to compile " << files[i].InputPath << std::endl;
+			ret = false;
+			continue;
+		}
+
+		if (!WriteFile(files[i].OutputPath, result.Binary[0]))
+		{
+			std::cout << "Failed to write " << files[i].OutputPath << std::endl;
+			ret = false;
+			continue;
+		}
+
+		std::cout << files[i].InputPath << " -> " << files[i].OutputPath << std::endl;
+	}
+
+	LLGI::SafeRelease(compiler);
+
+	return ret;
+}
+
+int main(int argc, char* argv[])
+{
+	bool isForced = false;
+	auto optimizationLevel = LLGI::CompilerOptimizationLevel::None;
+	std::vector<LLGI::CompilerDefine> defines;
+	std::vector<std::string> includeDirectories;
+	std::vector<std::string> directories;
+	std::string packPath;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+
+		if (arg == "-f")
+		{
+			isForced = true;
+		}
+		else if (arg == "-p" && i + 1 < argc)
+		{
+			i++;
+			packPath = argv[i];
+		}
+		else if (arg == "-O")
+		{
+			optimizationLevel = LLGI::CompilerOptimizationLevel::Performance;
+		}
+		else if (arg == "-Os")
+		{
+			optimizationLevel = LLGI::CompilerOptimizationLevel::Size;
+		}
+		else if (arg.compare(0, 2, "-D") == 0 && arg.size() > 2)
+		{
+			LLGI::CompilerDefine define;
+			auto separator = arg.find('=');
+			if (separator == std::string::npos)
+			{
+				define.Name = arg.substr(2);
+				define.Value = "1";
+			}
+			else
+			{
+				define.Name = arg.substr(2, separator - 2);
+				define.Value = arg.substr(separator + 1);
+			}
+			defines.push_back(define);
+		}
+		else if (arg.compare(0, 2, "-I") == 0 && arg.size() > 2)
+		{
+			includeDirectories.push_back(arg.substr(2));
+		}
+		else
+		{
+			directories.push_back(arg);
+		}
+	}
+
+	if (directories.size() != 2)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	const auto& inputDirectory = directories[0];
+	const auto& outputDirectory = directories[1];
+
+	// binaries which are compiled with other options are stale even if they are newer than sources
+	auto stampPath = outputDirectory + "/" + OptionStampName;
+	auto stamp = GetOptionStamp(optimizationLevel, defines, includeDirectories);
+	std::string previousStamp;
+	if (!ReadFile(stampPath, previousStamp) || previousStamp != stamp)
+	{
+		isForced = true;
+	}
+
+	// it is not tracked which files are included, so all shaders are compiled when any file in include directories is changed
+	time_t includeTime = 0;
+	for (const auto& directory : includeDirectories)
+	{
+		for (const auto& name : GetFileNames(directory))
+		{
+			time_t time = 0;
+			if (GetModifiedTime(directory + "/" + name, time) && time > includeTime)
+			{
+				includeTime = time;
+			}
+		}
+	}
+
+	std::vector<ShaderFile> files;
+	std::vector<std::string> shaderNames;
+
+	for (const auto& name : GetFileNames(inputDirectory))
+	{
+		ShaderFile file;
+
+		if (EndsWith(name, ".vert"))
+		{
+			file.Stage = LLGI::ShaderStageType::Vertex;
+		}
+		else if (EndsWith(name, ".frag"))
+		{
+			file.Stage = LLGI::ShaderStageType::Pixel;
+		}
+		else
+		{
+			continue;
+		}
+
+		file.InputPath = inputDirectory + "/" + name;
+		file.OutputPath = outputDirectory + "/" + name + ".spv";
+		shaderNames.push_back(name);
+
+		time_t inputTime = 0;
+		time_t outputTime = 0;
+		if (!isForced && GetModifiedTime(file.InputPath, inputTime) && GetModifiedTime(file.OutputPath, outputTime) &&
+			inputTime <= outputTime && includeTime <= outputTime)
+		{
+			continue;
+		}
+
+		if (!ReadFile(file.InputPath, file.Code))
+		{
+			std::cout << "Failed to read " << file.InputPath << std::endl;
+			return 1;
+		}
+
+		files.push_back(file);
+	}
+
+	if (files.size() == 0)
+	{
+		std::cout << "All shaders are up to date." << std::endl;
+	}
+	else if (!CompileShaders(files, defines, includeDirectories, optimizationLevel))
+	{
+		return 1;
+	}
+
+	// a stamp is written after all shaders are compiled, so shaders are compiled again if a build fails
+	if (previousStamp != stamp && !WriteText(stampPath, stamp))
+	{
+		std::cout << "Failed to write " << stampPath << std::endl;
+		return 1;
+	}
+
+	if (packPath != "")
+	{
+		time_t packTime = 0;
+		bool isPackUpdated = files.size() == 0 && GetModifiedTime(packPath, packTime);
+
+		std::vector<std::vector<uint8_t>> binaries(shaderNames.size());
+		for (size_t i = 0; i < shaderNames.size(); i++)
+		{
+			auto binaryPath = outputDirectory + "/" + shaderNames[i] + ".spv";
+
+			time_t binaryTime = 0;
+			isPackUpdated &= GetModifiedTime(binaryPath, binaryTime) && binaryTime <= packTime;
+
+			if (!ReadBinary(binaryPath, binaries[i]))
+			{
+				std::cout << "Failed to read " << binaryPath << std::endl;
+				return 1;
+			}
+		}
+
+		if (isPackUpdated)
+		{
+			std::cout << "A pack is up to date." << std::endl;
+		}
+		else if (!LLGI::WriteShaderPack(packPath.c_str(), shaderNames, binaries))
+		{
+			std::cout << "Failed to write " << packPath << std::endl;
+			return 1;
+		}
+		else
+		{
+			std::cout << shaderNames.size() << " shaders -> " << packPath << std::endl;
+		}
+	}
+
+	return 0;
+}